@@ -7,8 +7,10 @@ QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors
 
 HEADERS += \
     headers/dataFiles.h \
+    headers/earth-constants.h \
     headers/earth.h \
     headers/geometry.h \
+    headers/haversine.h \
     headers/points.h \
     headers/position.h \
     headers/types.h \
@@ -16,6 +18,7 @@ HEADERS += \
     headers/analysis/analysis-route.h \
     headers/analysis/analysis-track.h \
     headers/gpx/gpx-parser.h \
+    headers/io/io-progress.h \
     headers/xml/xml-element.h \
     headers/xml/xml-parser.h
 
@@ -26,14 +29,16 @@ SOURCES += \
     src/dataFiles.cpp \
     src/earth.cpp \
     src/geometry.cpp \
+    src/haversine.cpp \
     src/position.cpp \
     src/analysis/analysis-route.cpp \
     src/analysis/analysis-track.cpp \
     src/gpx/gpx-parser.cpp \
+    src/io/io-progress.cpp \
     src/xml/xml-element.cpp \
     src/xml/xml-parser.cpp
 
-INCLUDEPATH += headers/ headers/analysis/ headers/gpx/ headers/xml/
+INCLUDEPATH += headers/ headers/analysis/ headers/gpx/ headers/io/ headers/xml/
 
 OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
 DESTDIR = $$_PRO_FILE_PWD_/bin/
@@ -7,17 +7,28 @@ QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors
 
 HEADERS += \
     headers/dataFiles.h \
+    headers/earth-constants.h \
     headers/earth.h \
     headers/geometry.h \
+    headers/haversine.h \
     headers/position.h \
     headers/types.h \
     headers/waypoints.h \
     headers/analysis/analysis-route.h \
     headers/analysis/analysis-track.h \
+    headers/codec/codec-track.h \
     headers/gpx/gpx-parser.h \
     headers/gridworld/gridworld-model.h \
     headers/gridworld/gridworld-route.h \
     headers/gridworld/gridworld-track.h \
+    headers/io/io-events.h \
+    headers/io/io-input.h \
+    headers/io/io-mapped.h \
+    headers/io/io-progress.h \
+    headers/io/io-queue.h \
+    headers/nmea/nmea-emitter.h \
+    headers/nmea/nmea-formats.h \
+    headers/nmea/nmea-parser.h \
     headers/xml/xml-element.h \
     headers/xml/xml-generator.h \
     headers/xml/xml-parser.h
@@ -26,13 +37,22 @@ SOURCES += \
     src/dataFiles.cpp \
     src/earth.cpp \
     src/geometry.cpp \
+    src/haversine.cpp \
     src/position.cpp \
     src/analysis/analysis-route.cpp \
     src/analysis/analysis-track.cpp \
+    src/codec/codec-track.cpp \
     src/gpx/gpx-parser.cpp \
     src/gridworld/gridworld-model.cpp \
     src/gridworld/gridworld-route.cpp \
     src/gridworld/gridworld-track.cpp \
+    src/io/io-events.cpp \
+    src/io/io-input.cpp \
+    src/io/io-mapped.cpp \
+    src/io/io-progress.cpp \
+    src/nmea/nmea-emitter.cpp \
+    src/nmea/nmea-formats.cpp \
+    src/nmea/nmea-parser.cpp \
     src/xml/xml-element.cpp \
     src/xml/xml-generator.cpp \
     src/xml/xml-parser.cpp \
@@ -42,17 +62,27 @@ SOURCES += \
 SOURCES += \
     tests/BoostUTF-main.cpp \
     tests/geometry-tests.cpp \
+    tests/haversine-tests.cpp \
     tests/xml/xml-parser-tests.cpp \
     tests/gpx/gpx-parseRoute-tests.cpp \
     tests/gpx/gpx-parseTrack-tests.cpp \
+    tests/gpx/gpx-parseTrackLenient-tests.cpp \
+    tests/gpx/gpx-extensions-tests.cpp \
+    tests/gpx/gpx-parseDocument-tests.cpp \
+    tests/gpx/gpx-trackPointGenerator-tests.cpp \
     tests/analysis/numpoints.cpp \
     tests/analysis/indexing.cpp \
-    tests/analysis/totaltime.cpp
+    tests/analysis/totaltime.cpp \
+    tests/codec/codec-track-tests.cpp \
+    tests/io/io-input-tests.cpp \
+    tests/io/io-mapped-tests.cpp \
+    tests/io/io-progress-tests.cpp \
+    tests/io/io-queue-tests.cpp
 
-INCLUDEPATH += headers/ headers/analysis/ headers/gpx/ headers/gridworld/ headers/xml/
+INCLUDEPATH += headers/ headers/analysis/ headers/codec/ headers/gpx/ headers/gridworld/ headers/io/ headers/nmea/ headers/xml/
 
 OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
 DESTDIR = $$_PRO_FILE_PWD_/bin/
 TARGET = analysis-tests
 
-LIBS += -lboost_unit_test_framework
+LIBS += -lboost_unit_test_framework -lz -lpthread
@@ -7,14 +7,17 @@ QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors
 
 HEADERS += \
     headers/dataFiles.h \
+    headers/earth-constants.h \
     headers/earth.h \
     headers/geometry.h \
+    headers/haversine.h \
     headers/points.h \
     headers/position.h \
     headers/types.h \
     headers/gridworld/gridworld-model.h \
     headers/gridworld/gridworld-route.h \
     headers/gridworld/gridworld-track.h \
+    headers/nmea/nmea-emitter.h \
     headers/xml/xml-generator.h \
     headers/xml/xml-element.h
 
@@ -26,15 +29,17 @@ SOURCES += \
     src/dataFiles.cpp \
     src/earth.cpp \
     src/geometry.cpp \
+    src/haversine.cpp \
     src/position.cpp \
     src/gridworld/gridworld-model.cpp \
     src/gridworld/gridworld-route.cpp \
     src/gridworld/gridworld-track.cpp \
+    src/nmea/nmea-emitter.cpp \
     src/xml/xml-generator.cpp \
     src/xml/xml-element.cpp
 
 
-INCLUDEPATH += headers/ headers/xml/ headers/gridworld
+INCLUDEPATH += headers/ headers/xml/ headers/gridworld headers/nmea
 
 OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
 DESTDIR = $$_PRO_FILE_PWD_/bin/
@@ -0,0 +1,43 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors
+
+HEADERS += \
+    headers/dataFiles.h \
+    headers/earth-constants.h \
+    headers/earth.h \
+    headers/geometry.h \
+    headers/haversine.h \
+    headers/position.h \
+    headers/types.h \
+    headers/io/io-mapped.h \
+    headers/io/io-progress.h \
+    headers/nmea/nmea-batch.h \
+    headers/nmea/nmea-formats.h \
+    headers/nmea/nmea-parser.h
+
+SOURCES += \
+    apps/nmea-benchmark.cpp
+
+SOURCES += \
+    src/dataFiles.cpp \
+    src/earth.cpp \
+    src/geometry.cpp \
+    src/haversine.cpp \
+    src/position.cpp \
+    src/io/io-mapped.cpp \
+    src/io/io-progress.cpp \
+    src/nmea/nmea-batch.cpp \
+    src/nmea/nmea-formats.cpp \
+    src/nmea/nmea-parser.cpp
+
+INCLUDEPATH += headers/ headers/io/ headers/nmea/
+
+OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
+DESTDIR = $$_PRO_FILE_PWD_/bin/
+TARGET = nmea-benchmark
+
+LIBS += -lpthread
@@ -0,0 +1,54 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors
+
+HEADERS += \
+    headers/earth-constants.h \
+    headers/earth.h \
+    headers/geometry.h \
+    headers/haversine.h \
+    headers/position.h \
+    headers/types.h \
+    headers/waypoints.h \
+    headers/codec/codec-track.h \
+    headers/gpx/gpx-parser.h \
+    headers/io/io-input.h \
+    headers/io/io-mapped.h \
+    headers/io/io-progress.h \
+    headers/nmea/nmea-emitter.h \
+    headers/nmea/nmea-formats.h \
+    headers/nmea/nmea-parser.h \
+    headers/nmea/nmea-replay.h \
+    headers/xml/xml-element.h \
+    headers/xml/xml-parser.h
+
+SOURCES += \
+    apps/nmea-replay.cpp
+
+SOURCES += \
+    src/earth.cpp \
+    src/geometry.cpp \
+    src/haversine.cpp \
+    src/position.cpp \
+    src/codec/codec-track.cpp \
+    src/gpx/gpx-parser.cpp \
+    src/io/io-input.cpp \
+    src/io/io-mapped.cpp \
+    src/io/io-progress.cpp \
+    src/nmea/nmea-emitter.cpp \
+    src/nmea/nmea-formats.cpp \
+    src/nmea/nmea-parser.cpp \
+    src/nmea/nmea-replay.cpp \
+    src/xml/xml-element.cpp \
+    src/xml/xml-parser.cpp
+
+INCLUDEPATH += headers/ headers/codec/ headers/gpx/ headers/io/ headers/nmea/ headers/xml/
+
+OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
+DESTDIR = $$_PRO_FILE_PWD_/bin/
+TARGET = nmea-replay
+
+LIBS += -lz -lpthread
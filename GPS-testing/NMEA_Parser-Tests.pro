@@ -7,28 +7,75 @@ QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors
 
 HEADERS += \
     headers/dataFiles.h \
+    headers/earth-constants.h \
     headers/earth.h \
     headers/geometry.h \
+    headers/haversine.h \
     headers/position.h \
     headers/types.h \
-    headers/nmea/nmea-parser.h
+    headers/waypoints.h \
+    headers/codec/codec-track.h \
+    headers/gridworld/gridworld-model.h \
+    headers/gridworld/gridworld-route.h \
+    headers/gridworld/gridworld-track.h \
+    headers/io/io-events.h \
+    headers/io/io-mapped.h \
+    headers/io/io-progress.h \
+    headers/io/io-queue.h \
+    headers/nmea/nmea-batch.h \
+    headers/nmea/nmea-emitter.h \
+    headers/nmea/nmea-formats.h \
+    headers/nmea/nmea-fusion.h \
+    headers/nmea/nmea-ingest.h \
+    headers/nmea/nmea-live.h \
+    headers/nmea/nmea-parser.h \
+    headers/nmea/nmea-replay.h \
+    headers/nmea/nmea-track.h \
+    headers/xml/xml-element.h \
+    headers/xml/xml-generator.h
 
 SOURCES += \
     src/dataFiles.cpp \
     src/earth.cpp \
     src/geometry.cpp \
+    src/haversine.cpp \
     src/position.cpp \
-    src/nmea/nmea-parser.cpp
+    src/codec/codec-track.cpp \
+    src/gridworld/gridworld-model.cpp \
+    src/gridworld/gridworld-route.cpp \
+    src/gridworld/gridworld-track.cpp \
+    src/io/io-events.cpp \
+    src/io/io-mapped.cpp \
+    src/io/io-progress.cpp \
+    src/nmea/nmea-batch.cpp \
+    src/nmea/nmea-emitter.cpp \
+    src/nmea/nmea-formats.cpp \
+    src/nmea/nmea-fusion.cpp \
+    src/nmea/nmea-ingest.cpp \
+    src/nmea/nmea-live.cpp \
+    src/nmea/nmea-parser.cpp \
+    src/nmea/nmea-replay.cpp \
+    src/nmea/nmea-track.cpp \
+    src/xml/xml-element.cpp \
+    src/xml/xml-generator.cpp
 
 SOURCES += \
     tests/BoostUTF-main.cpp \
     tests/position-tests.cpp \
-    tests/nmea/nmea-parser-tests.cpp
+    tests/nmea/nmea-batch-tests.cpp \
+    tests/nmea/nmea-emitter-tests.cpp \
+    tests/nmea/nmea-formats-tests.cpp \
+    tests/nmea/nmea-fusion-tests.cpp \
+    tests/nmea/nmea-ingest-tests.cpp \
+    tests/nmea/nmea-live-tests.cpp \
+    tests/nmea/nmea-parser-tests.cpp \
+    tests/nmea/nmea-replay-tests.cpp \
+    tests/nmea/nmea-track-tests.cpp
 
-INCLUDEPATH += headers/ headers/nmea/
+INCLUDEPATH += headers/ headers/codec/ headers/gridworld/ headers/io/ headers/nmea/ headers/xml/
 
 OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
 DESTDIR = $$_PRO_FILE_PWD_/bin/
 TARGET = nmea-parser-tests
 
-LIBS += -lboost_unit_test_framework
+LIBS += -lboost_unit_test_framework -lpthread
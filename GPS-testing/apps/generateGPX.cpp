@@ -6,6 +6,7 @@
 #include "gridworld-model.h"
 #include "gridworld-route.h"
 #include "gridworld-track.h"
+#include "nmea-emitter.h"
 
 using namespace GPS;
 
@@ -50,4 +51,21 @@ int main()
     // file << GridWorld::Route("AGM").toGPX() << endl;
 
     /////////////////////////////////////////////////////////////
+
+    /* Writing a large NMEA log Example */
+
+    /* The emitter writes to the file whenever its buffer fills, so the log can be far larger than memory. */
+    // std::ofstream nmeaFile {DataFiles::NMEADir + "synthetic.log", std::ios::binary};
+    // NMEA::SentenceEmitter nmea {nmeaFile};
+    // const std::vector<TrackPoint> trackPoints = GridWorld::Track("A1G3M1S1Y").toTrackPoints();
+    // for (int repetition = 0; repetition < 1000000; ++repetition)
+    // {
+    //     for (const TrackPoint& trackPoint : trackPoints)
+    //     {
+    //         nmea.gga(trackPoint.position, trackPoint.dateTime);
+    //         nmea.rmc(trackPoint.position, trackPoint.dateTime);
+    //     }
+    // }
+
+    /////////////////////////////////////////////////////////////
 }
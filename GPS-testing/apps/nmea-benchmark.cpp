@@ -0,0 +1,130 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+
+#include "dataFiles.h"
+#include "nmea-parser.h"
+#include "nmea-batch.h"
+
+using namespace GPS;
+
+using std::cout;
+using std::endl;
+
+/* Compares the throughput of validating NMEA lines one at a time with NMEA::scanSentence()
+ * against NMEA::validateLines() at each supported SIMD level, and of reading a log file with
+ * NMEA::readSentences() against NMEA::readSentencesParallel().
+ *
+ * The logs in data/NMEA/ are concatenated and repeated up to the requested size (in MB,
+ * default 256), so that the timings are not dominated by start-up costs.
+ */
+
+template <typename Validation>
+void time(std::string description, const std::string& text, unsigned int repetitions, Validation validation)
+{
+    std::size_t numValid = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < repetitions; ++i)
+    {
+        numValid = validation();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double megabytes = double(text.size()) * repetitions / (1024 * 1024);
+    cout << description << ": " << megabytes / elapsed.count() << " MB/s"
+         << " (" << numValid << " valid sentences)" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t targetMegabytes = argc > 1 ? std::stoul(argv[1]) : 256;
+    const unsigned int repetitions = 5;
+
+    std::string logs;
+    for (std::string filename : {"gll.log", "gga_rmc-1.log", "gga_rmc-2.log"})
+    {
+        std::string filepath = DataFiles::NMEADir + filename;
+        if (! std::filesystem::exists(filepath))
+        {
+            cout << "Could not open log file: " + filepath << endl;
+            cout << "(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)" << endl;
+            return 1;
+        }
+        std::ifstream file {filepath};
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        logs += contents.str();
+    }
+
+    std::string text;
+    text.reserve(targetMegabytes * 1024 * 1024 + logs.size());
+    while (text.size() < targetMegabytes * 1024 * 1024) text += logs;
+
+    cout << "Validating " << text.size() / (1024 * 1024) << " MB of NMEA sentences, " << repetitions << " times." << endl;
+
+    time("scanSentence, line by line", text, repetitions, [&text]()
+    {
+        NMEA::SentenceView sentenceView;
+        std::size_t numValid = 0;
+        std::string_view remaining = text;
+        while (! remaining.empty())
+        {
+            const std::size_t newline = remaining.find('\n');
+            std::string_view line = remaining.substr(0, newline);
+            remaining.remove_prefix(newline == std::string_view::npos ? remaining.size() : newline + 1);
+            if (! line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (NMEA::scanSentence(line, sentenceView) == NMEA::ScanResult::valid) ++numValid;
+        }
+        return numValid;
+    });
+
+    const std::vector<std::pair<NMEA::SimdLevel,std::string>> levels =
+        { {NMEA::SimdLevel::scalar, "scalar"}, {NMEA::SimdLevel::sse2, "SSE2"}, {NMEA::SimdLevel::avx2, "AVX2"} };
+
+    std::vector<NMEA::LineCheck> results;
+    for (const auto& [level, name] : levels)
+    {
+        if (! NMEA::isSupported(level))
+        {
+            cout << "validateLines, " << name << ": not supported by this processor" << endl;
+            continue;
+        }
+
+        time("validateLines, " + name, text, repetitions, [&text,&results,level = level]()
+        {
+            results.clear();
+            NMEA::validateLines(text, results, level);
+            std::size_t numValid = 0;
+            for (const NMEA::LineCheck& line : results)
+            {
+                if (line.result == NMEA::ScanResult::valid) ++numValid;
+            }
+            return numValid;
+        });
+    }
+
+    const std::string filepath = (std::filesystem::temp_directory_path() / "nmea-benchmark.log").string();
+    {
+        std::ofstream file {filepath, std::ios::binary};
+        file << text;
+    }
+
+    time("readSentences", text, repetitions, [&filepath]()
+    {
+        std::ifstream file {filepath, std::ios::binary};
+        return NMEA::readSentences(file).size();
+    });
+
+    time("readSentencesParallel, " + std::to_string(std::thread::hardware_concurrency()) + " threads", text, repetitions, [&filepath]()
+    {
+        return NMEA::readSentencesParallel(filepath).size();
+    });
+
+    std::filesystem::remove(filepath);
+}
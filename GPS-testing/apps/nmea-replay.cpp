@@ -0,0 +1,191 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "gpx-parser.h"
+#include "io-input.h"
+#include "nmea-replay.h"
+
+using namespace GPS;
+
+using std::cerr;
+using std::endl;
+
+/* Replays a recorded NMEA log, or a GPX track, to any number of simulated devices, so that
+ * ingestion can be load-tested with realistic timing.
+ *
+ * Usage: nmea-replay [options] <file>
+ *   --speed N          Replay at N times real time (default 1), or as fast as possible if N is 0.
+ *   --repeat N         Replay the log N times (default 1).
+ *   --pty N            Create N pseudo-terminals, printing the name of each.
+ *   --socket PATH N    Listen on a Unix socket at PATH, waiting for N clients to connect.
+ *   --fifo PATH        Write to a named pipe (may be given more than once).
+ *
+ * Without any devices, the log is written to standard output.  Files whose names contain ".gpx"
+ * are read as GPX tracks, and anything else as NMEA logs; either may be gzip-compressed.
+ * Progress and statistics are reported on standard error.
+ */
+
+NMEA::Replayer* activeReplayer = nullptr;
+
+void stopReplay(int)
+{
+    if (activeReplayer) activeReplayer->stop();
+}
+
+int openPseudoTerminal()
+{
+    const int fd = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || ::grantpt(fd) < 0 || ::unlockpt(fd) < 0)
+    {
+        throw std::runtime_error(std::string("Cannot create a pseudo-terminal: ") + std::strerror(errno));
+    }
+
+    // Raw mode, so that the sentences are passed through unaltered.
+    termios attributes;
+    ::tcgetattr(fd, &attributes);
+    ::cfmakeraw(&attributes);
+    ::tcsetattr(fd, TCSANOW, &attributes);
+
+    cerr << "Pseudo-terminal: " << ::ptsname(fd) << endl;
+    return fd;
+}
+
+std::vector<int> acceptSocketClients(const std::string& path, unsigned int numClients)
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) throw std::invalid_argument("Socket path too long: " + path);
+    std::strcpy(address.sun_path, path.c_str());
+
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::unlink(path.c_str());
+    if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listener, numClients) < 0)
+    {
+        throw std::runtime_error("Cannot listen on socket " + path + ": " + std::strerror(errno));
+    }
+
+    cerr << "Waiting for " << numClients << " clients to connect to " << path << endl;
+    std::vector<int> clients;
+    while (clients.size() < numClients)
+    {
+        const int client = ::accept(listener, nullptr, nullptr);
+        if (client >= 0) clients.push_back(client);
+        else if (errno != EINTR) throw std::runtime_error(std::string("Cannot accept client: ") + std::strerror(errno));
+    }
+    ::close(listener);
+    ::unlink(path.c_str());
+    return clients;
+}
+
+NMEA::ReplayLog readLog(const std::string& filepath)
+{
+    IO::InputStream input {filepath};
+    if (filepath.find(".gpx") != std::string::npos)
+    {
+        return NMEA::ReplayLog::fromTrack(GPX::parseTrack(input));
+    }
+    return NMEA::ReplayLog::fromNMEA(input);
+}
+
+int main(int argc, char* argv[])
+{
+    double speed = 1;
+    unsigned int repetitions = 1;
+    unsigned int numPseudoTerminals = 0;
+    std::vector<std::pair<std::string,unsigned int>> sockets;
+    std::vector<std::string> fifos;
+    std::string filepath;
+
+    const std::string usage = "Usage: nmea-replay [--speed N] [--repeat N] [--pty N] [--socket PATH N] [--fifo PATH]... <file>";
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (arg == "--speed" && hasValue) speed = std::stod(argv[++i]);
+            else if (arg == "--repeat" && hasValue) repetitions = std::stoul(argv[++i]);
+            else if (arg == "--pty" && hasValue) numPseudoTerminals = std::stoul(argv[++i]);
+            else if (arg == "--fifo" && hasValue) fifos.push_back(argv[++i]);
+            else if (arg == "--socket" && i + 2 < argc)
+            {
+                sockets.emplace_back(argv[i+1], std::stoul(argv[i+2]));
+                i += 2;
+            }
+            else if (arg.substr(0,2) != "--" && filepath.empty()) filepath = arg;
+            else throw std::invalid_argument(arg);
+        }
+        if (filepath.empty()) throw std::invalid_argument("no file");
+    }
+    catch (const std::logic_error&) // Thrown by std::stod() and std::stoul() for non-numeric values, as well as above.
+    {
+        cerr << usage << endl;
+        return 1;
+    }
+
+    // Readers that disconnect are dropped, rather than terminating the replay.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    try
+    {
+        const NMEA::ReplayLog log = readLog(filepath);
+        cerr << "Replaying " << log.sentenceCount() << " sentences over " << log.duration() << " seconds." << endl;
+
+        std::vector<int> fds;
+        for (unsigned int i = 0; i < numPseudoTerminals; ++i) fds.push_back(openPseudoTerminal());
+        for (const auto& [path, numClients] : sockets)
+        {
+            for (int client : acceptSocketClients(path, numClients)) fds.push_back(client);
+        }
+        for (const std::string& fifo : fifos)
+        {
+            const int fd = ::open(fifo.c_str(), O_WRONLY); // Waits for a reader to open the pipe.
+            if (fd < 0) throw std::runtime_error("Cannot open named pipe " + fifo + ": " + std::strerror(errno));
+            fds.push_back(fd);
+        }
+        const bool toStandardOutput = fds.empty();
+        if (toStandardOutput) fds.push_back(STDOUT_FILENO);
+
+        NMEA::Replayer replayer {log, speed, repetitions};
+        for (int fd : fds) replayer.addDevice(fd);
+
+        activeReplayer = &replayer;
+        std::signal(SIGINT, stopReplay);
+        std::signal(SIGTERM, stopReplay);
+
+        const auto start = std::chrono::steady_clock::now();
+        replayer.run();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        activeReplayer = nullptr;
+
+        cerr << replayer.sentencesWritten() << " sentences written to " << fds.size() << " devices in "
+             << elapsed.count() << " seconds (" << replayer.sentencesWritten() / elapsed.count() << " per second)";
+        if (replayer.droppedDevices() > 0) cerr << ", " << replayer.droppedDevices() << " devices disconnected";
+        cerr << "." << endl;
+
+        if (! toStandardOutput)
+        {
+            for (int fd : fds) ::close(fd);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        cerr << e.what() << endl;
+        return 1;
+    }
+}
@@ -15,6 +15,18 @@ namespace GPS::Analysis
     protected:
       const std::vector<RoutePoint> routePoints;
 
+      // The route points prepared for individual distance computations.
+      const std::vector<GeodeticPoint> geodeticPoints;
+
+      /* The horizontal distance from each route point to the next.  With the AVX2 kernel (see
+       * haversine.h), they are computed in a batch from latitude and longitude arrays built for
+       * the call; otherwise, directly from the geodetic points.
+       */
+      std::vector<metres> horizontalDistances() const;
+
+      // The horizontal distance from each route point to the Position.
+      std::vector<metres> horizontalDistancesTo(Position) const;
+
     public:
       Route(std::vector<RoutePoint>);
 
@@ -158,6 +170,12 @@ namespace GPS::Analysis
        * Throws a std::out_of_range exception if the index is out-of-range.
        */
       RoutePoint operator[](unsigned int) const;
+
+    private:
+      // The latitudes and longitudes of the route points, as separate arrays for the AVX2 kernel.
+      void coordinateArrays(std::vector<degrees>& latitudes, std::vector<degrees>& longitudes) const;
+
+      static std::vector<GeodeticPoint> routePointsToGeodeticPoints(const std::vector<RoutePoint>&);
   };
 }
 
@@ -167,7 +167,15 @@ namespace GPS::Analysis
 
       static std::vector<TimeStamp> trackPointsToTimeStamps(std::vector<TrackPoint>);
 
-      bool withinRestingRange(RoutePoint,RoutePoint) const;
+      /* The distance between the route points at the two indices, including both vertical and
+       * horizontal distance.  Every decision on whether a leg is a rest is based on this, rather
+       * than on the batch distances (which may differ in the last few bits), so that all the
+       * queries agree on which legs are rests.
+       */
+      metres distanceBetween(unsigned int, unsigned int) const;
+
+      // Whether the route points at the two indices are within the resting range of each other.
+      bool withinRestingRange(unsigned int, unsigned int) const;
 
       static TimeStamp tmToTimeStamp(std::tm);
   };
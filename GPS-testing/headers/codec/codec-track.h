@@ -0,0 +1,175 @@
+#ifndef GPS_CODEC_TRACK_H
+#define GPS_CODEC_TRACK_H
+
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+#include <vector>
+#include <stdexcept>
+
+#include "types.h"
+#include "waypoints.h"
+
+namespace GPS::Codec
+{
+  /* A compact binary encoding for stored tracks.
+   *
+   * Each channel (latitude, longitude, elevation and time) is quantized to an integer using a
+   * configurable resolution, delta-encoded against the previous point, and packed as a zig-zag
+   * varint.  Points are grouped into blocks; the first point of every block is stored relative to
+   * zero rather than to the previous point, so each block can be decoded on its own.
+   *
+   * Layout (all multi-byte integers are varints unless stated otherwise):
+   *   - the magic bytes "GPSz" and a one-byte format version;
+   *   - the angle and elevation resolutions, as 8-byte little-endian IEEE doubles;
+   *   - a sequence of blocks, each consisting of its point count, its payload size in bytes,
+   *     and the payload itself.
+   *
+   * Point names are NOT stored.  Times are stored as whole seconds, interpreting the std::tm
+   * fields as UTC.
+   */
+
+  using Bytes = std::vector<std::uint8_t>;
+
+  struct Resolution
+  {
+      degrees angle = 1e-7;     // Approximately 1cm at the equator.
+      metres  elevation = 0.01;
+  };
+
+  /* Decoded track data in structure-of-arrays form, suitable for feeding directly into
+   * batch analysis.  All four vectors always have the same length.
+   */
+  struct Columns
+  {
+      std::vector<degrees> latitudes;
+      std::vector<degrees> longitudes;
+      std::vector<metres> elevations;
+      std::vector<std::time_t> times;
+
+      std::size_t size() const;
+      void clear();
+  };
+
+
+  class TrackEncoder
+  {
+    public:
+      /* Throws a std::invalid_argument exception if either resolution is not positive,
+       * or if the number of points per block is zero.
+       */
+      TrackEncoder(Resolution = {}, unsigned int pointsPerBlock = 4096);
+
+      void add(const TrackPoint&);
+      void add(degrees lat, degrees lon, metres ele, std::time_t);
+
+      // Flush any partially-filled block and return the complete encoding.
+      Bytes finish();
+
+    private:
+      const Resolution resolution;
+      const unsigned int pointsPerBlock;
+
+      Bytes output;
+      Bytes block;
+      unsigned int pointsInBlock = 0;
+      std::int64_t prevLat = 0, prevLon = 0, prevEle = 0, prevTime = 0;
+
+      void flushBlock();
+  };
+
+
+  // Encode a whole track in one call.
+  Bytes encodeTrack(const std::vector<TrackPoint>&, Resolution = {}, unsigned int pointsPerBlock = 4096);
+
+
+  class TrackDecoder
+  {
+    public:
+      /* The decoder does not copy the data, which must outlive the decoder.
+       * Throws a std::domain_error exception if the header or the block structure is malformed.
+       */
+      TrackDecoder(const std::uint8_t* data, std::size_t size);
+      TrackDecoder(const Bytes&);
+
+      Resolution resolution() const;
+      std::size_t numBlocks() const;
+      std::size_t numPoints() const;
+
+      /* Decode a single block, appending its points to the columns.
+       * Throws a std::out_of_range exception if the block index is out-of-range.
+       * Throws a std::domain_error exception if the block payload is malformed.
+       */
+      void decodeBlock(std::size_t blockIndex, Columns&) const;
+
+      // Decode every block, appending the points to the columns.
+      void decodeAll(Columns&) const;
+
+      /* Stream every point to a callable taking (degrees lat, degrees lon, metres ele, std::time_t),
+       * without materialising any intermediate containers.
+       */
+      template <typename Sink>
+      void forEachPoint(Sink&& sink) const;
+
+      // Decode into TrackPoints (with empty names), e.g. for constructing an Analysis::Track.
+      std::vector<TrackPoint> toTrackPoints() const;
+
+    private:
+      struct Block
+      {
+          const std::uint8_t* begin;
+          const std::uint8_t* end;
+          std::size_t numPoints;
+      };
+
+      Resolution res;
+      std::vector<Block> blocks;
+      std::size_t totalPoints = 0;
+
+      static std::int64_t readSigned(const std::uint8_t*& it, const std::uint8_t* end);
+  };
+
+
+  /* Conversions between the std::tm fields (interpreted as UTC) and seconds since the epoch.
+   * Unlike std::mktime(), these do not depend on the local time zone.
+   */
+  std::time_t tmToSeconds(const std::tm&);
+  std::tm secondsToTm(std::time_t);
+
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  inline std::int64_t TrackDecoder::readSigned(const std::uint8_t*& it, const std::uint8_t* end)
+  {
+      std::uint64_t raw = 0;
+      for (unsigned int shift = 0; ; shift += 7)
+      {
+          if (it == end || shift > 63) throw std::domain_error("Malformed varint in encoded track.");
+          const std::uint8_t byte = *it++;
+          raw |= std::uint64_t(byte & 0x7F) << shift;
+          if (byte < 0x80) break;
+      }
+      return std::int64_t(raw >> 1) ^ -std::int64_t(raw & 1); // zig-zag decoding
+  }
+
+  template <typename Sink>
+  void TrackDecoder::forEachPoint(Sink&& sink) const
+  {
+      for (const Block& b : blocks)
+      {
+          const std::uint8_t* it = b.begin;
+          std::int64_t lat = 0, lon = 0, ele = 0, time = 0;
+          for (std::size_t i = 0; i < b.numPoints; ++i)
+          {
+              lat  += readSigned(it, b.end);
+              lon  += readSigned(it, b.end);
+              ele  += readSigned(it, b.end);
+              time += readSigned(it, b.end);
+              sink(lat * res.angle, lon * res.angle, ele * res.elevation, std::time_t(time));
+          }
+          if (it != b.end) throw std::domain_error("Encoded track block has trailing bytes.");
+      }
+  }
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef GPS_EARTH_CONSTANTS_H
+#define GPS_EARTH_CONSTANTS_H
+
+#include "types.h"
+
+/* The Earth constants that Position itself depends on.  The rest, which depend on Position,
+ * are in earth.h (which includes this).
+ */
+namespace GPS::Earth
+{
+  inline constexpr metres meanRadius = 6371008.8;
+
+  /* Check that the elevation value is no lower than the centre of the Earth.
+   * No upper limit is imposed.  NaN is not valid.
+   */
+  constexpr bool isValidElevation(metres elevation)
+  {
+      return elevation >= -meanRadius;
+  }
+}
+
+#endif
@@ -1,23 +1,25 @@
 #ifndef GPS_EARTH_H
 #define GPS_EARTH_H
 
+#include "geometry.h"
+#include "earth-constants.h"
 #include "position.h"
 
 namespace GPS
 {
   namespace Earth
   {
-      extern const Position NorthPole;
-      extern const Position SouthPole;
-      extern const Position EquatorialMeridian;
-      extern const Position EquatorialAntiMeridian;
-      extern const Position CliftonCampus;
-      extern const Position CityCampus;
-      extern const Position Pontianak;
+      inline constexpr Position NorthPole = Position(poleLatitude,0,0);
+      inline constexpr Position SouthPole = Position(-poleLatitude,0,0);
+      inline constexpr Position EquatorialMeridian = Position(0,0,0);
+      inline constexpr Position EquatorialAntiMeridian = Position(0,antiMeridianLongitude,0);
+      inline constexpr Position CliftonCampus = Position(52.91249953,-1.18402513,58);
+      inline constexpr Position CityCampus = Position(52.9581383,-1.1542364,53);
+      inline constexpr Position Pontianak = Position(0,109.322134,0);
 
-      extern const metres meanRadius;
-      extern const metres equatorialCircumference;
-      extern const metres polarCircumference;
+      // meanRadius and isValidElevation() are in earth-constants.h.
+      inline constexpr metres equatorialCircumference = 40075160;
+      inline constexpr metres polarCircumference = 40008000;
 
 
       /* Determine the east/west circumference of the Earth at a specified latitude.
@@ -44,13 +46,6 @@ namespace GPS
        * specified latitude.
        */
       degrees longitudeSubtendedBy(metres eastWestDistance, degrees lat);
-
-
-      /* Check that the elevation value is no lower than the centre of the Earth.
-       * No upper limit is imposed.
-       */
-      bool isValidElevation(metres);
-
   }
 }
 
@@ -1,18 +1,20 @@
 #ifndef GPS_GEOMETRY_H
 #define GPS_GEOMETRY_H
 
+#include <cmath>
+
 #include "types.h"
 
 namespace GPS
 {
-  extern const unsigned int minutesPerDegree;
-  extern const unsigned int secondsPerMinute;
-  extern const unsigned int degreesInACircle;
-  extern const double pi;
-  extern const degrees fullRotation;
-  extern const degrees halfRotation;
-  extern const degrees poleLatitude;
-  extern const degrees antiMeridianLongitude;
+  inline constexpr unsigned int minutesPerDegree = 60;
+  inline constexpr unsigned int secondsPerMinute = 60;
+  inline constexpr unsigned int degreesInACircle = 360;
+  inline constexpr double pi = 3.141592653589793;
+  inline constexpr degrees fullRotation = degreesInACircle;
+  inline constexpr degrees halfRotation = fullRotation/2;
+  inline constexpr degrees poleLatitude = fullRotation/4;
+  inline constexpr degrees antiMeridianLongitude = fullRotation/2;
 
   // Compute hypotenuse of right-angled triangle in two dimensions.
   double pythagoras(double,double);
@@ -21,22 +23,62 @@ namespace GPS
   double pythagoras(double,double,double);
 
   // Convert from degrees to radians.
-  radians degToRad(degrees);
+  constexpr radians degToRad(degrees);
 
   // Convert from radians to degrees.
-  radians radToDeg(degrees);
+  constexpr degrees radToDeg(radians);
 
   // Sine squared function: sin^2(x)
   double sinSqr(radians);
 
-  // Check if the angle is within the [-90,90] range.
-  bool isValidLatitude(degrees);
+  // Check if the angle is within the [-90,90] range.  NaN is not.
+  constexpr bool isValidLatitude(degrees);
 
-  // Check if the angle is within the [-180,180] range.
-  bool isValidLongitude(degrees);
+  // Check if the angle is within the [-180,180] range.  NaN is not.
+  constexpr bool isValidLongitude(degrees);
 
   // Convert larger/smaller degrees into the (-180,180] range.
   degrees normaliseDegrees(degrees);
+
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  inline double pythagoras(double x, double y)
+  {
+      return std::sqrt(x*x + y*y);
+  }
+
+  inline double pythagoras(double x, double y, double z)
+  {
+      return std::sqrt(x*x + y*y + z*z);
+  }
+
+  constexpr radians degToRad(degrees d)
+  {
+      return d * pi / halfRotation;
+  }
+
+  constexpr degrees radToDeg(radians r)
+  {
+      return r * halfRotation / pi;
+  }
+
+  inline double sinSqr(radians x)
+  {
+      const double sx = std::sin(x);
+      return sx * sx;
+  }
+
+  // Written as two comparisons, rather than with std::abs() (which is not constexpr), so that NaN fails both.
+  constexpr bool isValidLatitude(degrees lat)
+  {
+      return lat >= -poleLatitude && lat <= poleLatitude;
+  }
+
+  constexpr bool isValidLongitude(degrees lon)
+  {
+      return lon >= -antiMeridianLongitude && lon <= antiMeridianLongitude;
+  }
 }
 
 #endif
@@ -1,10 +1,16 @@
 #ifndef GPS_GPX_PARSER_H
 #define GPS_GPX_PARSER_H
 
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+#include <string>
 #include <vector>
 #include <istream>
+#include <optional>
 
 #include "waypoints.h"
+#include "io-progress.h"
 
 namespace GPS::GPX
 {
@@ -13,6 +19,192 @@ namespace GPS::GPX
 
   // Parse GPX data containing a track.
   std::vector<GPS::TrackPoint> parseTrack(std::istream&);
+
+
+  // The reasons why a track point may be rejected by a lenient parse.
+  enum class PointError : std::uint8_t
+  {
+      missingLatitude,
+      missingLongitude,
+      malformedLatitude,
+      malformedLongitude,
+      malformedElevation,
+      invalidLatitude,    // well-formed, but outside the [-90,90] range
+      invalidLongitude,   // well-formed, but outside the [-180,180] range
+      invalidElevation,   // well-formed, but below the centre of the Earth
+      missingTime,
+      malformedTime
+  };
+
+  struct RejectedPoint
+  {
+      unsigned int index; // The position of the point within the track, counting across all segments.
+      PointError reason;
+  };
+
+  struct ParseReport
+  {
+      std::vector<RejectedPoint> rejectedPoints;
+  };
+
+  /* Parse GPX data containing a track, skipping any track points that contain invalid data
+   * and recording them in the report, rather than abandoning the whole track.
+   * Invalid track points are detected without throwing exceptions.
+   *
+   * Throws a std::domain_error exception only if the document itself is unusable, i.e. if the XML
+   * is malformed, or there is no 'gpx' root element or 'trk' element.
+   */
+  std::vector<GPS::TrackPoint> parseTrackLenient(std::istream&, ParseReport&);
+
+
+  /* Numeric sensor channels (e.g. heart rate, cadence, power, temperature) extracted from the
+   * '<extensions>' element of each track point, stored as parallel columns aligned with the
+   * track points: values[f][i] holds field f of track point i.
+   *
+   * A field is matched against the leaf elements anywhere beneath '<extensions>', ignoring
+   * namespace prefixes, so "hr" matches both "<gpxtpx:hr>" and "<ns3:hr>".  Where a field is
+   * absent or not numeric, valid[f][i] is false and values[f][i] is zero.
+   */
+  struct SensorColumns
+  {
+      SensorColumns(std::vector<std::string> fieldNames);
+
+      std::vector<std::string> fieldNames;
+      std::vector<std::vector<double>> values;
+      std::vector<std::vector<bool>> valid;
+
+      // Empty the columns, leaving one (empty) column for each of the field names.
+      void clear();
+
+      // Throws a std::out_of_range exception if there is no field of that name.
+      std::size_t fieldIndex(const std::string& fieldName) const;
+  };
+
+  // The fields carried by the Garmin TrackPointExtension schema, plus the commonly-used power field.
+  extern const std::vector<std::string> garminSensorFields;
+
+  /* As parseTrack(), additionally extracting the requested sensor fields during the same parse.
+   * Any values already in the columns are discarded first, so the columns can be reused.
+   */
+  std::vector<GPS::TrackPoint> parseTrack(std::istream&, SensorColumns&);
+
+  // As parseTrackLenient(), additionally extracting sensor fields for the accepted track points.
+  // Any values already in the columns are discarded first.
+  std::vector<GPS::TrackPoint> parseTrackLenient(std::istream&, ParseReport&, SensorColumns&);
+
+
+  /* As parseTrack(), reporting progress to the monitor as the data is read, and throwing an
+   * IO::Cancelled exception if the monitor cancels the parse.
+   * The XML is parsed in full before any points are extracted, so points are counted at the end.
+   */
+  std::vector<GPS::TrackPoint> parseTrack(std::istream&, IO::ProgressMonitor&);
+
+
+  // A contiguous range [begin,end) of indices into Document::points.
+  struct PointRange
+  {
+      std::size_t begin = 0;
+      std::size_t end = 0;
+
+      std::size_t size() const;
+  };
+
+  /* Every waypoint, route and track in a GPX document, loaded in a single parse.
+   *
+   * All points share one buffer, 'points', with their times held alongside in 'times' (valid
+   * only where 'hasTime' is true).  The waypoints come first, then the points of each route,
+   * then the points of each track; waypoints, routes and track segments are ranges within it.
+   */
+  struct Document
+  {
+      struct Route
+      {
+          std::string name;
+          PointRange points;
+      };
+
+      struct Track
+      {
+          std::string name;
+          std::vector<PointRange> segments; // Consecutive, so together they cover points().
+
+          PointRange points() const;
+      };
+
+      std::vector<GPS::RoutePoint> points;
+      std::vector<std::tm> times;
+      std::vector<bool> hasTime;
+
+      PointRange waypoints;
+      std::vector<Route> routes;
+      std::vector<Track> tracks;
+
+      // Copy the points of a route or track out of the shared buffer.
+      // Throws a std::out_of_range exception if there is no route/track with that index.
+      std::vector<GPS::RoutePoint> routePoints(std::size_t routeIndex) const;
+      std::vector<GPS::TrackPoint> trackPoints(std::size_t trackIndex) const;
+  };
+
+  /* Parse a GPX document, extracting every 'wpt', every 'rte' and every 'trk' (with its
+   * 'trkseg's) in one pass over the data.
+   *
+   * Track points must have a time, as for parseTrack(); waypoints and route points may have one.
+   * Routes and tracks may be empty, and a document may contain no routes or tracks at all.
+   *
+   * Throws a std::domain_error exception if the XML is malformed or there is no 'gpx' root
+   * element.  Points containing missing or invalid data cause exceptions as for parseTrack().
+   */
+  Document parseDocument(std::istream&);
+
+
+  /* A resumable counterpart to parseTrack(), for GPX data that arrives over time (e.g. an
+   * upload) on a file descriptor.  next() yields each track point as soon as its 'trkpt' element
+   * is complete, and returns nothing, without waiting, when it needs more data, so that the caller
+   * can resume it once the descriptor is readable again.  Driven by an IO::EventLoop, one thread
+   * can interleave the parsing of many streams.
+   *
+   * As for parseTrack(), the points are those of the first 'trk' element.  Each 'trkpt' element is
+   * parsed as a whole, with the same checks as parseTrack(); the rest of the document is scanned
+   * for the 'trk' and 'trkpt' tags only, so it is not otherwise checked for well-formedness.
+   *
+   * The descriptor is switched to non-blocking mode (and restored on destruction, but not closed).
+   */
+  class TrackPointGenerator
+  {
+    public:
+      // Throws a std::invalid_argument exception if the descriptor is invalid.
+      explicit TrackPointGenerator(int fd);
+      ~TrackPointGenerator();
+
+      TrackPointGenerator(const TrackPointGenerator&) = delete;
+      TrackPointGenerator& operator=(const TrackPointGenerator&) = delete;
+
+      /* Returns nothing if no further point has arrived yet, or if the track has ended.
+       * Throws a std::domain_error exception if a 'trkpt' element is invalid, or (when the input
+       * ends) if there is no 'trk' element, it contains no points, or it is incomplete.
+       * Throws a std::runtime_error exception if reading fails.
+       */
+      std::optional<GPS::TrackPoint> next();
+
+      // True once the track has ended and every point has been yielded.
+      bool ended() const;
+
+    private:
+      enum class Section { beforeTrack, inTrack, afterTrack };
+
+      int fd;
+      int originalFlags;
+
+      std::string buffer;
+      std::size_t scanned = 0; // The data before this has been consumed.
+      Section section = Section::beforeTrack;
+      std::size_t pointsYielded = 0;
+      bool endOfInput = false;
+
+      bool readAvailable();
+      std::optional<GPS::TrackPoint> extractPoint();
+      void checkComplete() const;
+  };
 }
 
 #endif
@@ -11,7 +11,7 @@ namespace GPS::GridWorld
 {
   /* This class generates routes in either:
    *  - GPX format
-   *  - NMEA format (currently unimplemented)
+   *  - NMEA format
    *  - C++ data structure format (std::vector<RoutePoint>)
    *
    * To use this class, the user must provide a string of GridWorld::Points
@@ -28,8 +28,8 @@ namespace GPS::GridWorld
       // Produce a GPX representation of the route.
       std::string toGPX() const;
 
-      // Produce a NMEA representation of the route.
-      std::string toNMEA() const; // unimplemented
+      // Produce a NMEA representation of the route, as one GGA sentence per point (with empty time fields).
+      std::string toNMEA() const;
 
       // Produce a string representation of the route.
       std::string toString() const;
@@ -16,7 +16,7 @@ namespace GPS::GridWorld
 {
   /* This class generates tracks in either:
    *  - GPX format
-   *  - NMEA format (currently unimplemented)
+   *  - NMEA format
    *  - C++ data structure format (std::vector<TrackPoint>)
    *
    * To use this class, the user must provide a string of GridWorld::Points,
@@ -37,8 +37,8 @@ namespace GPS::GridWorld
       // Produce a GPX representation of the track.
       std::string toGPX() const;
 
-      // Produce a NMEA representation of the track.
-      std::string toNMEA() const; // unimplemented
+      // Produce a NMEA representation of the track, as a GGA sentence and an RMC sentence per point.
+      std::string toNMEA() const;
 
       // Produce a string representation of the track.
       std::string toString() const;
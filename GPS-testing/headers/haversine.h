@@ -0,0 +1,70 @@
+#ifndef GPS_HAVERSINE_H
+#define GPS_HAVERSINE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "types.h"
+#include "position.h"
+
+namespace GPS
+{
+  /* Computes the horizontal distance between two points on the Earth's surface by the haversine
+   * formula, as Position::horizontalDistanceBetween() does (which calls this).
+   *
+   * Pre-condition: the latitudes and longitudes are valid.
+   */
+  metres haversineDistance(degrees lat1, degrees lon1, degrees lat2, degrees lon2);
+
+  // As above, with the same result, reusing the points' radians and cosines.
+  metres haversineDistance(const GeodeticPoint&, const GeodeticPoint&);
+
+
+  // The instruction set used by the batch distance functions below.
+  enum class DistanceKernel : std::uint8_t
+  {
+      scalar, // haversineDistance()
+      avx2    // 4 distances at a time
+  };
+
+  // The best kernel supported by the processor that the program is running on.
+  DistanceKernel bestDistanceKernel();
+
+  bool isSupported(DistanceKernel);
+
+
+  /* The batch functions below take the points' latitudes and longitudes as separate arrays of
+   * equal length, and replace the contents of 'distances' with the results.
+   *
+   * The AVX2 kernel evaluates sine, cosine and arcsine with its own polynomials rather than the
+   * C library's, so its distances can differ from haversineDistance()'s in the last few bits.
+   * For points no more than a quarter of the Earth's circumference apart, the difference is at
+   * most 'maxBatchErrorULPs' units in the last place.  (The haversine formula is ill-conditioned
+   * for nearly antipodal points, where both results are less accurate, and may differ by more.)
+   *
+   * The coordinates are not validated, by either kernel, so the caller must ensure that they are
+   * valid latitudes and longitudes (as they are if taken from Positions); for invalid ones, both
+   * kernels compute a meaningless distance rather than throwing.
+   *
+   * Throws a std::invalid_argument exception if the arrays differ in length.
+   */
+  inline constexpr unsigned int maxBatchErrorULPs = 8;
+
+  /* The distance from each point to the next: 'distances[i]' is the distance between points
+   * i and i+1, so there is one fewer distance than points (and none if there are no points).
+   */
+  void consecutiveDistances(const std::vector<degrees>& lats, const std::vector<degrees>& lons,
+                            std::vector<metres>& distances);
+
+  // The distance from each point to the target: 'distances[i]' is the distance from point i.
+  void distancesTo(const std::vector<degrees>& lats, const std::vector<degrees>& lons,
+                   degrees targetLat, degrees targetLon, std::vector<metres>& distances);
+
+  // As above, using the specified kernel, which must be supported.
+  void consecutiveDistances(const std::vector<degrees>& lats, const std::vector<degrees>& lons,
+                            std::vector<metres>& distances, DistanceKernel);
+  void distancesTo(const std::vector<degrees>& lats, const std::vector<degrees>& lons,
+                   degrees targetLat, degrees targetLon, std::vector<metres>& distances, DistanceKernel);
+}
+
+#endif
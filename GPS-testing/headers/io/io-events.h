@@ -0,0 +1,53 @@
+#ifndef GPS_IO_EVENTS_H
+#define GPS_IO_EVENTS_H
+
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include <poll.h>
+
+namespace GPS::IO
+{
+  /* Drives any number of non-blocking readers from a single thread, calling each reader's
+   * handler whenever its file descriptor becomes readable (or is closed by the writer), so that
+   * many streams can be parsed concurrently without a thread per stream.
+   *
+   * A handler should consume whatever data is available without waiting (e.g. by draining an
+   * NMEA::FixGenerator or a GPX::TrackPointGenerator), and return false once it has finished
+   * with the descriptor, which is then no longer watched (but not closed).
+   *
+   * Handlers may watch further descriptors.  An exception thrown by a handler stops watching
+   * its descriptor, and propagates out of run().
+   */
+  class EventLoop
+  {
+    public:
+      using Handler = std::function<bool()>;
+
+      void watch(int fd, Handler);
+
+      /* Calls handlers until no descriptors are being watched, or until stop() is called (from
+       * a handler or another thread), which takes effect within 'stopLatency'.
+       */
+      void run(std::chrono::milliseconds stopLatency = std::chrono::milliseconds(100));
+      void stop();
+
+      // The number of descriptors being watched.
+      std::size_t size() const;
+
+    private:
+      std::vector<pollfd> descriptors;
+      std::vector<Handler> handlers;
+
+      // Watched by handlers during the current round, and added to the above after it.
+      std::vector<pollfd> newDescriptors;
+      std::vector<Handler> newHandlers;
+
+      std::atomic<bool> stopping {false};
+  };
+}
+
+#endif
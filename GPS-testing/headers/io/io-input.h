@@ -0,0 +1,95 @@
+#ifndef GPS_IO_INPUT_H
+#define GPS_IO_INPUT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <istream>
+#include <fstream>
+#include <streambuf>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace GPS::IO
+{
+  /* Determine whether the stream begins with the gzip magic bytes (0x1f 0x8b).
+   * No characters are consumed.
+   */
+  bool isGzip(std::istream&);
+
+
+  /* A stream buffer that decompresses gzip data read from another stream.
+   *
+   * Decompression runs on a background thread, which fills one buffer while the reader consumes
+   * the other, so that decompression and parsing overlap.  Concatenated gzip members (as produced
+   * by appending to a .gz file) are decompressed in sequence.
+   *
+   * Up to 'putbackSize' characters can be put back (e.g. by std::istream::unget()), even across
+   * the boundary between buffers.
+   *
+   * Corrupt or truncated data causes an exception to be thrown when reading, which the owning
+   * std::istream reports by setting its badbit.
+   */
+  class DecompressingStreambuf : public std::streambuf
+  {
+    public:
+      DecompressingStreambuf(std::istream& compressedSource, std::size_t bufferSize = 256 * 1024);
+      ~DecompressingStreambuf();
+
+      DecompressingStreambuf(const DecompressingStreambuf&) = delete;
+      DecompressingStreambuf& operator=(const DecompressingStreambuf&) = delete;
+
+      static constexpr std::size_t putbackSize = 16;
+
+    protected:
+      int_type underflow() override;
+
+    private:
+      struct Buffer
+      {
+          std::vector<char> data; // The first 'putbackSize' characters are reserved for putback.
+          std::size_t size = 0;   // Excluding the putback area.
+          bool ready = false; // Filled by the decompressor and not yet released by the reader.
+      };
+
+      std::istream& source;
+      Buffer buffers[2];
+      int current = -1; // The buffer being read, or -1 before the first read.
+
+      std::mutex mutex;
+      std::condition_variable bufferStateChanged;
+      bool stopping = false;
+      std::string error;
+
+      std::thread decompressor;
+
+      void decompress();
+  };
+
+
+  /* An input stream over either a file or another stream, which transparently decompresses the
+   * data if it is gzip-compressed (detected by its magic bytes), and otherwise passes it through
+   * unchanged.  Can be passed directly to GPX::parseTrack(), NMEA::readSentences(), etc.
+   */
+  class InputStream : public std::istream
+  {
+    public:
+      // Throws a std::invalid_argument exception if the file cannot be opened.
+      explicit InputStream(const std::string& filepath);
+
+      // The source stream must outlive this stream.
+      explicit InputStream(std::istream& source);
+
+      bool isCompressed() const;
+
+    private:
+      std::unique_ptr<std::ifstream> file;
+      std::unique_ptr<DecompressingStreambuf> decompressor;
+
+      void attach(std::istream& source);
+  };
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef GPS_IO_MAPPED_H
+#define GPS_IO_MAPPED_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GPS::IO
+{
+  /* A read-only memory mapping of a whole file, so that it can be read in place without
+   * copying it into a buffer.  The mapping is released when the object is destroyed.
+   */
+  class MappedFile
+  {
+    public:
+      // Throws a std::invalid_argument exception if the file cannot be opened or mapped.
+      explicit MappedFile(const std::string& filepath);
+      ~MappedFile();
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      // The file's contents, valid for the lifetime of this object.
+      std::string_view contents() const;
+
+    private:
+      const char* data = nullptr;
+      std::size_t size = 0;
+  };
+
+
+  /* Splits the text into at most 'maxChunks' chunks of roughly equal size, each ending just
+   * after a '\n' (except perhaps the last), so that no line is split between chunks.
+   * Fewer chunks are returned if the text has too few lines, and none if it is empty.
+   */
+  std::vector<std::string_view> splitIntoLineChunks(std::string_view text, std::size_t maxChunks);
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef GPS_IO_PROGRESS_H
+#define GPS_IO_PROGRESS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include <istream>
+#include <streambuf>
+
+namespace GPS::IO
+{
+  struct Progress
+  {
+      std::uint64_t bytesConsumed = 0;
+      std::uint64_t pointsProduced = 0;
+      std::chrono::steady_clock::duration elapsed {};
+  };
+
+  // Called periodically during a parse.  Returning false cancels the parse.
+  using ProgressCallback = std::function<bool(const Progress&)>;
+
+  // Thrown out of a parse when it is cancelled.
+  class Cancelled : public std::runtime_error
+  {
+    public:
+      Cancelled();
+  };
+
+
+  /* Tracks the progress of a parse, and decides when to abandon it.
+   *
+   * The byte count is advanced by a MonitoredStream as input is consumed, and the callback is
+   * invoked each time another 'checkInterval' bytes have been consumed; between checks the cost
+   * is one addition and one comparison per block of input read.
+   *
+   * cancel() may be called from any thread (e.g. when a client disconnects); the parse stops by
+   * throwing Cancelled at its next check.
+   */
+  class ProgressMonitor
+  {
+    public:
+      ProgressMonitor(ProgressCallback = nullptr, std::size_t checkInterval = 64 * 1024);
+
+      void cancel();
+      bool isCancelled() const;
+
+      Progress progress() const;
+
+      void addBytes(std::size_t);
+      void addPoints(std::size_t);
+
+      // Invokes the callback now.  Throws Cancelled if the parse has been cancelled.
+      void check();
+
+    private:
+      const ProgressCallback callback;
+      const std::size_t checkInterval;
+      const std::chrono::steady_clock::time_point start;
+
+      std::uint64_t bytesConsumed = 0;
+      std::uint64_t pointsProduced = 0;
+      std::uint64_t nextCheck;
+      std::atomic<bool> cancelled {false};
+  };
+
+
+  /* An input stream that reads from another stream, reporting the bytes consumed to a
+   * ProgressMonitor.  Can be passed directly to GPX::parseTrack(), NMEA::readSentences(), etc.
+   *
+   * The Cancelled exception propagates out of any read on this stream, rather than being
+   * absorbed into the stream state; so do any other exceptions from the source's stream buffer.
+   */
+  class MonitoredStream : public std::istream
+  {
+    public:
+      // The source stream and the monitor must outlive this stream.
+      MonitoredStream(std::istream& source, ProgressMonitor&);
+
+    private:
+      class Streambuf : public std::streambuf
+      {
+        public:
+          Streambuf(std::streambuf* source, ProgressMonitor&);
+
+        protected:
+          int_type underflow() override;
+
+        private:
+          static constexpr std::size_t putbackSize = 16;
+          static constexpr std::size_t blockSize = 4096;
+
+          std::streambuf* source;
+          ProgressMonitor& monitor;
+          std::vector<char> buffer;
+      };
+
+      Streambuf streambuf;
+  };
+}
+
+#endif
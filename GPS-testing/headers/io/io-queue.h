@@ -0,0 +1,90 @@
+#ifndef GPS_IO_QUEUE_H
+#define GPS_IO_QUEUE_H
+
+#include <cstddef>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace GPS::IO
+{
+  /* A bounded, lock-free queue for passing values from exactly one producer thread to exactly
+   * one consumer thread.  Neither side ever waits for the other: pushing to a full queue or
+   * popping from an empty one fails immediately.
+   */
+  template <typename T>
+  class SpscQueue
+  {
+    public:
+      // Throws a std::invalid_argument exception if the capacity is zero.
+      explicit SpscQueue(std::size_t capacity);
+
+      SpscQueue(const SpscQueue&) = delete;
+      SpscQueue& operator=(const SpscQueue&) = delete;
+
+      // Producer only.  Returns false if the queue is full.
+      bool tryPush(const T&);
+
+      // Consumer only.  Returns false if the queue is empty.
+      bool tryPop(T&);
+
+      // Approximate if called while the other thread is active.
+      bool empty() const;
+
+      std::size_t capacity() const;
+
+    private:
+      std::vector<T> slots; // One more than the capacity, so that a full queue differs from an empty one.
+
+      // On separate cache lines, so that the producer and consumer do not contend for them.
+      alignas(64) std::atomic<std::size_t> head {0}; // The next slot to pop; written by the consumer.
+      alignas(64) std::atomic<std::size_t> tail {0}; // The next slot to push; written by the producer.
+  };
+
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  template <typename T>
+  SpscQueue<T>::SpscQueue(std::size_t capacity)
+  {
+      if (capacity == 0) throw std::invalid_argument("A queue must have a non-zero capacity.");
+      slots.resize(capacity + 1);
+  }
+
+  template <typename T>
+  bool SpscQueue<T>::tryPush(const T& value)
+  {
+      const std::size_t currentTail = tail.load(std::memory_order_relaxed);
+      const std::size_t nextTail = currentTail + 1 == slots.size() ? 0 : currentTail + 1;
+      if (nextTail == head.load(std::memory_order_acquire)) return false;
+
+      slots[currentTail] = value;
+      tail.store(nextTail, std::memory_order_release);
+      return true;
+  }
+
+  template <typename T>
+  bool SpscQueue<T>::tryPop(T& value)
+  {
+      const std::size_t currentHead = head.load(std::memory_order_relaxed);
+      if (currentHead == tail.load(std::memory_order_acquire)) return false;
+
+      value = slots[currentHead];
+      head.store(currentHead + 1 == slots.size() ? 0 : currentHead + 1, std::memory_order_release);
+      return true;
+  }
+
+  template <typename T>
+  bool SpscQueue<T>::empty() const
+  {
+      return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+  }
+
+  template <typename T>
+  std::size_t SpscQueue<T>::capacity() const
+  {
+      return slots.size() - 1;
+  }
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef GPS_NMEA_BATCH_H
+#define GPS_NMEA_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "nmea-parser.h"
+
+namespace GPS::NMEA
+{
+  // The instruction set used by validateLines().
+  enum class SimdLevel : std::uint8_t
+  {
+      scalar,
+      sse2,  // 16-byte blocks
+      avx2   // 32-byte blocks
+  };
+
+  // The best level supported by the processor that the program is running on.
+  SimdLevel bestSimdLevel();
+
+  bool isSupported(SimdLevel);
+
+
+  // The outcome of validating one line.
+  struct LineCheck
+  {
+      std::size_t begin;   // The offset of the line within the text.
+      std::size_t length;  // Excluding the line ending ("\n" or "\r\n").
+      ScanResult result;
+  };
+
+  /* Validates the structure and checksum of every line in a block of NMEA text, producing one
+   * LineCheck per line, with the same results as scanSentence() (but without splitting fields).
+   * Lines are terminated by "\n" or "\r\n"; the final line need not be terminated.
+   *
+   * Each line is scanned in 16 or 32-byte blocks, using SIMD comparisons to locate the '*',
+   * '$' and '\n' characters, and SIMD XORs to accumulate the checksum.  The results are
+   * appended to the vector, so that it can be reused across calls without reallocating.
+   */
+  void validateLines(std::string_view text, std::vector<LineCheck>& results);
+
+  // As above, using the specified instruction set, which must be supported.
+  void validateLines(std::string_view text, std::vector<LineCheck>& results, SimdLevel);
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef GPS_NMEA_EMITTER_H
+#define GPS_NMEA_EMITTER_H
+
+#include <cstddef>
+#include <ctime>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "position.h"
+
+namespace GPS::NMEA
+{
+  /* The fields of a GGA sentence that describe the quality of the fix, which cannot be derived
+   * from a Position.  The defaults describe a good GPS fix, so emitted sentences pass the
+   * default QualityFilter; change them to generate data that a stricter filter rejects.
+   */
+  struct GGAQuality
+  {
+      unsigned int quality = 1;    // The fix quality indicator, 0-9 (0 means no fix, 1 a GPS fix).
+      unsigned int satellites = 8; // 0-99, written as two digits.
+      double hdop = 1.0;           // 0-99.9, written with 1 decimal place.
+  };
+
+
+  /* Formats GLL, GGA and RMC sentences, with "$GP" talker IDs, DDM coordinates and XOR checksums,
+   * directly into a preallocated buffer.  Numbers are formatted digit by digit, so no strings
+   * are constructed per sentence or per field.  Each sentence is terminated by "\r\n".
+   *
+   * Latitudes and longitudes are written with 4 decimal places of minutes (about 0.2 metres),
+   * elevations with 1 decimal place, and times as "hhmmss.000".
+   *
+   * Sentences accumulate in the buffer.  An emitter constructed with a sink stream writes the
+   * buffer to the sink whenever it fills (and on flush() and destruction), so arbitrarily large
+   * logs can be produced with a fixed amount of memory; without a sink the buffer grows as needed.
+   */
+  class SentenceEmitter
+  {
+    public:
+      // Throws a std::invalid_argument exception if the capacity cannot hold a sentence.
+      explicit SentenceEmitter(std::size_t bufferCapacity = 64 * 1024);
+      explicit SentenceEmitter(std::ostream& sink, std::size_t bufferCapacity = 64 * 1024);
+      ~SentenceEmitter();
+
+      SentenceEmitter(const SentenceEmitter&) = delete;
+      SentenceEmitter& operator=(const SentenceEmitter&) = delete;
+
+      /* Append a sentence for the Position.  Where the time is absent, the time field is left empty.
+       * GGA sentences take their quality fields from the GGAQuality, and always have a geoid
+       * separation of 0.0 and empty DGPS fields.
+       * RMC sentences take the date from the std::tm, and leave the speed and course fields empty.
+       *
+       * Throw a std::domain_error exception if the elevation is too large (10,000 km or more) to be written,
+       * or if a GGAQuality field is outside the range given above.
+       */
+      void gll(const Position&, const std::optional<std::tm>& time = {});
+      void gga(const Position&, const std::optional<std::tm>& time = {}, const GGAQuality& = {});
+      void rmc(const Position&, const std::tm& dateTime);
+
+      // The sentences emitted since construction or since the last clear() or flush().
+      std::string_view contents() const;
+
+      void clear();
+
+      // Write the buffered sentences to the sink (if there is one), and empty the buffer.
+      void flush();
+
+      // Enough room for any sentence that this class emits.
+      static constexpr std::size_t maxSentenceLength = 96;
+
+    private:
+      std::ostream* sink;
+      std::vector<char> buffer;
+      std::size_t used = 0;
+
+      // Ensures there is room for a sentence, writes "$GP", the format and a comma, and returns the start of the sentence.
+      char* beginSentence(const char* format);
+
+      // Writes the checksum of the sentence that starts at 'begin', and the line terminator.
+      void endSentence(char* begin, char* end);
+  };
+}
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef GPS_NMEA_FORMATS_H
+#define GPS_NMEA_FORMATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "types.h"
+#include "position.h"
+#include "nmea-parser.h"
+
+namespace GPS::NMEA
+{
+  /* Packs a three-character format code (e.g. "GGA") into an integer, so that formats can be
+   * dispatched with a switch statement rather than a string comparison per format.
+   * Codes of any other length pack to zero.
+   */
+  constexpr std::uint32_t packFormatCode(std::string_view format)
+  {
+      if (format.size() != 3) return 0;
+      return (std::uint32_t(std::uint8_t(format[0])) << 16)
+           | (std::uint32_t(std::uint8_t(format[1])) << 8)
+           |  std::uint32_t(std::uint8_t(format[2]));
+  }
+
+
+  struct Date
+  {
+      unsigned int year;   // e.g. 2014
+      unsigned int month;  // 1-12
+      unsigned int day;    // 1-31
+  };
+
+  /* Everything decoded from a single sentence.  Each member is present only if the sentence
+   * format carries it and the sentence contains it (receivers leave fields empty when they
+   * have no data for them).
+   */
+  struct Fix
+  {
+      std::string_view format; // e.g. "RMC"
+      Talker talker = Talker::gps;
+
+      std::optional<Position> position;           // GLL, RMC, GGA, GNS (with elevation only from GGA and GNS)
+      std::optional<double> timeOfDay;            // seconds since midnight UTC: GLL, RMC, GGA, ZDA, GNS
+      std::optional<Date> date;                   // RMC, ZDA
+      std::optional<speed> groundSpeed;           // metres per second: RMC, VTG
+      std::optional<degrees> course;              // true course over the ground: RMC, VTG
+      std::optional<unsigned int> quality;        // GGA fix quality indicator (0 means no fix)
+      std::optional<unsigned int> satellitesUsed; // GGA, GNS, GSA
+      std::optional<unsigned int> satellitesInView; // GSV
+      std::optional<double> pdop;                 // GSA
+      std::optional<double> hdop;                 // GSA, GGA, GNS
+      std::optional<double> vdop;                 // GSA
+  };
+
+
+  /* Describes a supported sentence format: how many data fields it has, where its common
+   * fields are, and how to decode its format-specific fields.
+   */
+  struct FormatSpec
+  {
+      std::string_view format;
+
+      std::size_t minFields;  // Later revisions of the NMEA standard append fields to some formats.
+      std::size_t maxFields;
+
+      // Field indices, or -1 if the format does not contain that field.
+      int timeField;
+      int latitudeField;  // Followed by the N/S field, the longitude field, and the E/W field.
+      int elevationField;
+      // Only the position formats record these, since only they are filtered by checkQuality().
+      int qualityField;   // The GGA fix quality indicator.
+      int satellitesField;
+      int hdopField;
+
+      // Decodes any other fields, returning false if they contain invalid data.
+      bool (*decodeOtherFields)(const std::vector<std::string_view>&, Fix&);
+  };
+
+  // Returns nullptr if the format is not supported.
+  const FormatSpec* findFormat(std::string_view format);
+
+  // All the supported formats.
+  const std::vector<FormatSpec>& supportedFormats();
+
+
+  /* Decodes every field of a sentence that its format declares.
+   *
+   * Empty fields are treated as absent, but non-empty fields must be valid; a position is only
+   * present if all of its fields are.  Returns false if the format is not supported, the
+   * number of fields is wrong, or any field contains invalid data.
+   */
+  bool decodeFix(const SentenceView&, Fix&);
+
+  /* Decodes only the position, which is faster than decodeFix() when nothing else is needed.
+   * Returns DecodeStatus::noPosition if the format does not carry a position, or the reason why
+   * the position fields are invalid.
+   *
+   * Pre-condition: the sentence has the number of fields declared in the format spec.
+   */
+  DecodeStatus decodePosition(const FormatSpec&, const SentenceView&, degrees& lat, degrees& lon, metres& ele);
+
+  /* Applies the filter to the sentence's raw quality fields, without decoding anything else.
+   * Returns DecodeStatus::poorQuality if the filter rejects the sentence, or
+   * DecodeStatus::malformedNumber if a field that the filter needs is not a number.
+   *
+   * Pre-condition: the sentence has the number of fields declared in the format spec.
+   */
+  DecodeStatus checkQuality(const FormatSpec&, const SentenceView&, const QualityFilter&);
+
+  /* Applies the filter to the quality members of a decoded fix, e.g. one from decodeFix() or a
+   * LiveReader's callback.  The readers do not filter the fixes that they yield, so callers that
+   * want filtered fixes apply this themselves.
+   */
+  bool meetsQuality(const Fix&, const QualityFilter&);
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef GPS_NMEA_FUSION_H
+#define GPS_NMEA_FUSION_H
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include "nmea-formats.h"
+
+namespace GPS::NMEA
+{
+  /* Merges the fixes decoded from the sentences of one epoch (e.g. the GGA and RMC sentences
+   * that a receiver sends for each position update) into a single fix, so that it carries
+   * everything from all of them: the elevation from GGA, the date and speed from RMC, etc.
+   *
+   * Fixes are grouped by their time of day.  Fixes without a time (VTG, GSA and GSV) belong to
+   * the latest epoch received so far.
+   *
+   * At most 'maxPendingEpochs' epochs are held while waiting for further sentences; when a new
+   * epoch would exceed that, the oldest is emitted as it stands.  Therefore a missing sentence
+   * delays an epoch by a bounded number of epochs, rather than indefinitely.  A sentence that
+   * arrives after its epoch has been emitted is emitted on its own, and counted as late.
+   *
+   * Where sentences disagree, the first to arrive wins, except that a position with an
+   * elevation (from GGA or GNS) replaces one without.  The merged fix takes the format of the
+   * sentence that supplied its position, or if there is none, of the first sentence.
+   */
+  class EpochFuser
+  {
+    public:
+      // Throws a std::invalid_argument exception if maxPendingEpochs is zero.
+      explicit EpochFuser(std::size_t maxPendingEpochs = 2);
+
+      // Adds a fix, appending any epochs that are pushed out of the buffer to 'fused'.
+      void add(const Fix&, std::vector<Fix>& fused);
+
+      // Appends all pending epochs to 'fused', oldest first.
+      void flush(std::vector<Fix>& fused);
+
+      std::size_t pendingEpochs() const;
+      std::size_t lateFixes() const;
+
+    private:
+      std::size_t maxPendingEpochs;
+      std::deque<Fix> pending; // Ordered by time of day, oldest first.
+      std::optional<double> lastEmitted; // The time of the latest epoch emitted.
+      std::size_t late = 0;
+  };
+
+  // Merge the members of 'from' that 'into' lacks, as described above.
+  void mergeFix(Fix& into, const Fix& from);
+
+  /* Reads a stream of NMEA sentences (one sentence per line), and fuses the fixes from each
+   * epoch, ignoring any lines that do not contain valid sentences of a supported format.
+   */
+  std::vector<Fix> readFusedFixes(std::istream&, std::size_t maxPendingEpochs = 2);
+}
+
+#endif
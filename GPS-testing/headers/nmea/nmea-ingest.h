@@ -0,0 +1,121 @@
+#ifndef GPS_NMEA_INGEST_H
+#define GPS_NMEA_INGEST_H
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "io-queue.h"
+#include "nmea-formats.h"
+#include "nmea-live.h"
+
+namespace GPS::NMEA
+{
+  /* Reads NMEA sentences from many devices at once (serial devices, pipes, ptys or sockets),
+   * using a fixed number of threads rather than one thread per device.
+   *
+   * Each device is assigned to a shard, and each shard is served by its own thread, which
+   * waits on all of its devices' descriptors with poll() and reads from whichever are ready.
+   * Each device has its own LiveReader (i.e. its own parse state and buffer), and each read is
+   * limited in size, so that a busy device cannot starve the others in its shard.  The shards
+   * share nothing, so throughput scales with the number of shards (by default, one per core).
+   *
+   * The fixes from each device are published to that device's own lock-free queue, from which
+   * the application pops them on any one thread.  If the application falls behind and a
+   * device's queue fills, further fixes from that device are dropped (and counted) rather than
+   * holding up the shard.  Each queue is allocated in full when the device is added, so its
+   * capacity sets the memory used per device (roughly 200 bytes per fix).  The default suits
+   * devices that report a few times a second; sources that arrive in bursts (e.g. replayed
+   * logs) need queues large enough to hold a burst.
+   *
+   * Once a device's input has ended, its reader is destroyed (restoring the descriptor's flags)
+   * before ended() returns true, so the caller may then close the descriptor.  Devices that are
+   * finished with should be removed, to free their queues.
+   */
+  class IngestEngine
+  {
+    public:
+      class Device
+      {
+        public:
+          Device(int fd, std::size_t shard, std::size_t queueCapacity);
+
+          // Pops the next fix from the device, if there is one.  Call from one thread only.
+          bool tryPop(Fix&);
+
+          // Whether the device's input has ended (its fixes may still be waiting to be popped).
+          bool ended() const;
+
+          // The number of fixes dropped because the queue was full.
+          std::size_t droppedFixes() const;
+
+          std::size_t shard() const;
+
+        private:
+          friend class IngestEngine;
+
+          int fd;
+          std::size_t shardIndex;
+          IO::SpscQueue<Fix> fixes;
+          std::unique_ptr<LiveReader> reader; // Used only by the shard's thread.
+          std::atomic<bool> inputEnded {false};
+          std::atomic<std::size_t> dropped {0};
+          bool released = false; // Guarded by the shard's mutex.
+      };
+
+      // If the shard count is zero, one shard per hardware core is used.
+      explicit IngestEngine(std::size_t shardCount = 0, std::size_t queueCapacity = 256);
+      ~IngestEngine();
+
+      IngestEngine(const IngestEngine&) = delete;
+      IngestEngine& operator=(const IngestEngine&) = delete;
+
+      /* Starts reading from the descriptor (which is made non-blocking, but is not closed),
+       * on the shard with the fewest devices.  Devices can be added at any time.
+       * The returned Device remains valid until it is removed, or the engine is destroyed.
+       * The descriptor must stay open until then, or until the device has ended.
+       */
+      Device& addDevice(int fd);
+
+      /* Stops reading from the device, and destroys it (restoring the descriptor's flags), so
+       * that the caller may then close the descriptor.  Any fixes not yet popped are lost.
+       * Throws a std::invalid_argument exception if the device does not belong to this engine.
+       */
+      void removeDevice(Device&);
+
+      // Stops all the shards' threads.  Called by the destructor.
+      void stop();
+
+      std::size_t shardCount() const;
+
+    private:
+      struct Shard
+      {
+          std::thread thread;
+          int wakePipe[2];
+
+          std::mutex mutex;                 // Guards the members below, which are shared with addDevice() and removeDevice().
+          std::vector<Device*> newDevices;
+          std::vector<Device*> removedDevices;
+          std::condition_variable released; // Notified when removed devices are released, or the thread finishes.
+          std::size_t numDevices = 0;
+          bool finished = false;
+      };
+
+      std::size_t queueCapacity;
+      std::vector<std::unique_ptr<Shard>> shards;
+      std::vector<std::unique_ptr<Device>> devices;
+      std::mutex devicesMutex;
+      std::atomic<bool> stopping {false};
+
+      void serve(Shard&);
+      static void wake(Shard&);
+      static void endDevice(Device&);
+  };
+}
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef GPS_NMEA_LIVE_H
+#define GPS_NMEA_LIVE_H
+
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "nmea-formats.h"
+
+namespace GPS::NMEA
+{
+  /* Reads NMEA sentences as they arrive from a file descriptor, such as a serial device, a pipe
+   * or a pseudo-terminal, rather than from a finite std::istream.
+   *
+   * The descriptor is switched to non-blocking mode (and restored on destruction, but not
+   * closed).  Data is read into a fixed-size ring buffer; lines may arrive split across any
+   * number of reads.  As soon as a line is complete it is decoded, and if it contains a valid
+   * sentence of a supported format, the fix is passed to the callback, so a sentence is never
+   * held back waiting for more data.  (To merge the sentences of each epoch, pass the fixes
+   * on to an EpochFuser.)
+   *
+   * A line longer than the buffer cannot be a valid sentence, so it is discarded and counted.
+   *
+   * Input ends when the writer closes a pipe, or hangs up a pseudo-terminal.  A final line
+   * without a '\n' is still read.  Any other read error throws a std::runtime_error exception.
+   */
+  class LiveReader
+  {
+    public:
+      using FixCallback = std::function<void(const Fix&)>;
+
+      // Throws a std::invalid_argument exception if the descriptor is invalid or the buffer is empty.
+      LiveReader(int fd, FixCallback, std::size_t bufferSize = 4096);
+      ~LiveReader();
+
+      LiveReader(const LiveReader&) = delete;
+      LiveReader& operator=(const LiveReader&) = delete;
+
+      // Reads whatever data is available, without waiting.  Returns false once the input has ended.
+      bool poll();
+
+      /* As poll(), but makes at most 'maxReads' calls to read(), so that a device that sends
+       * continuously cannot monopolise a thread that serves several devices.
+       */
+      bool readSome(std::size_t maxReads);
+
+      // Waits up to the timeout for data to arrive, then reads it.  Returns false once the input has ended.
+      bool poll(std::chrono::milliseconds timeout);
+
+      /* Reads until the input ends, or until stop() is called (from the callback or another
+       * thread), which takes effect within 'stopLatency'.
+       */
+      void run(std::chrono::milliseconds stopLatency = std::chrono::milliseconds(100));
+      void stop();
+
+      bool ended() const;
+      std::size_t discardedLines() const;
+
+    private:
+      int fd;
+      int originalFlags;
+      FixCallback onFix;
+
+      std::vector<char> ring;
+      std::size_t head = 0;  // The start of the unconsumed data.
+      std::size_t count = 0; // The amount of unconsumed data, none of which is a '\n'.
+      bool discarding = false; // Within a line that overflowed the buffer.
+      std::size_t discarded = 0;
+      bool endOfInput = false;
+      std::atomic<bool> stopping {false};
+
+      std::string wrappedLine; // Holds a line that wraps around the end of the ring.
+      SentenceView sentence;
+      Fix fix;
+
+      void consumeLines(std::size_t newDataStart, std::size_t newDataSize);
+      void processLine(std::size_t start, std::size_t length);
+      void finish();
+  };
+
+
+  /* A resumable counterpart to readSentences(), for input that arrives over time (e.g. an
+   * upload) on a file descriptor.  next() yields the fixes decoded from whatever data has
+   * arrived, and returns nothing, without waiting, when it needs more, so that the caller can
+   * resume it once the descriptor is readable again.  Driven by an IO::EventLoop, one thread
+   * can interleave the parsing of many streams.
+   *
+   * Each resumption reads only a little, and next() returns nothing once it has yielded those
+   * fixes, so a device that sends continuously cannot monopolise the thread.
+   */
+  class FixGenerator
+  {
+    public:
+      // Throws a std::invalid_argument exception if the descriptor is invalid.
+      explicit FixGenerator(int fd, std::size_t bufferSize = 4096);
+
+      /* Returns nothing if no further fix has arrived yet, or if the input has ended.
+       * Throws a std::runtime_error exception if reading fails.
+       */
+      std::optional<Fix> next();
+
+      // True once the input has ended and every fix has been yielded.
+      bool ended() const;
+
+    private:
+      static constexpr std::size_t readsPerResume = 2; // Enough for a final line and the end of input.
+
+      std::deque<Fix> decoded; // Read but not yet yielded.
+      bool yielded = false; // Fixes have been yielded since the last read.
+      LiveReader reader;
+  };
+}
+
+#endif
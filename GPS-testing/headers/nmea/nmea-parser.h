@@ -1,24 +1,79 @@
 #ifndef GPS_NMEA_PARSER_H
 #define GPS_NMEA_PARSER_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <istream>
+#include <functional>
+#include <limits>
 
 #include "position.h"
+#include "io-progress.h"
 
 namespace GPS::NMEA
 {
   /* Determine whether the parameter is the three-character code for a sentence format
    * that is currently supported.
-   * Currently the only supported sentence formats are "GLL", "GGA" and "RMC".
+   * Currently the supported sentence formats are "GLL", "GGA", "RMC", "VTG", "GSA", "GSV",
+   * "ZDA" and "GNS" (see nmea-formats.h).
    */
   bool isSupportedFormat(std::string);
 
 
+  /* The talker ID at the start of a sentence identifies the satellite system that the receiver
+   * used: "GP" for GPS, "GL" for GLONASS, "GA" for Galileo, "GB" or "BD" for BeiDou, and "GN"
+   * for fixes that combine several systems.
+   */
+  enum class Talker : std::uint8_t
+  {
+      gps,
+      glonass,
+      galileo,
+      beidou,
+      multiple
+  };
+
+  struct TalkerID
+  {
+      char id[2];
+      Talker talker;
+  };
+
+  // The talker IDs that are accepted.
+  inline constexpr TalkerID acceptedTalkers[] =
+  {
+      {{'G','P'}, Talker::gps},
+      {{'G','L'}, Talker::glonass},
+      {{'G','A'}, Talker::galileo},
+      {{'G','B'}, Talker::beidou},
+      {{'B','D'}, Talker::beidou},
+      {{'G','N'}, Talker::multiple}
+  };
+
+  /* Look up a talker ID in the table above, setting 'talker' and returning true if it is
+   * accepted.  This compares characters, so no strings are constructed.
+   */
+  constexpr bool findTalker(char first, char second, Talker& talker)
+  {
+      for (const TalkerID& accepted : acceptedTalkers)
+      {
+          if (accepted.id[0] == first && accepted.id[1] == second)
+          {
+              talker = accepted.talker;
+              return true;
+          }
+      }
+      return false;
+  }
+
+
   /* Determine whether the parameter conforms to the structure of a NMEA sentence.
    * A NMEA sentence contains the following contents:
-   *   - the prefix "$GP";
+   *   - the prefix '$';
+   *   - followed by an accepted two-character talker ID (see above), e.g. "GP";
    *   - followed by a sequence of three uppercase (English) alphabet characters
    *     identifying the sentence format;
    *   - followed by a sequence of one or more comma-prefixed data fields;
@@ -48,7 +103,7 @@ namespace GPS::NMEA
    */
   struct SentenceData
   {
-      /* Stores the NMEA sentence format, excluding the 'GP' prefix.
+      /* Stores the NMEA sentence format, excluding the talker ID prefix.
        * E.g. "GLL".
        */
       std::string format;
@@ -58,11 +113,44 @@ namespace GPS::NMEA
        * and the second element could be "N".
        */
       std::vector<std::string> dataFields;
+
+      Talker talker = Talker::gps;
+  };
+
+
+  /* A NMEA sentence's format and data fields, as views into the sentence's characters
+   * (which must outlive it).  Produced by scanSentence() without copying any characters.
+   */
+  struct SentenceView
+  {
+      std::string_view format;
+
+      /* Cleared, not deallocated, by each scan, so a SentenceView that is reused from one
+       * sentence to the next stops allocating once it has grown to the largest sentence.
+       */
+      std::vector<std::string_view> dataFields;
+
+      Talker talker = Talker::gps;
   };
 
+  enum class ScanResult : std::uint8_t
+  {
+      valid,
+      invalidStructure,  // see hasValidSentenceStructure()
+      checksumMismatch   // the structure is valid, but see checksumMatches()
+  };
+
+  /* Checks the structure of a sentence, computes its checksum, and records its format and field
+   * boundaries, all in a single pass over the characters.
+   *
+   * The sentence view is filled in unless the structure is invalid (in which case it is left
+   * empty).  Unlike the functions above, this has no pre-conditions.
+   */
+  ScanResult scanSentence(std::string_view, SentenceView&);
+
 
-  /* Extracts the sentence format and the field contents from a NMEA sentence string.
-   * The '$GP' and the checksum are ignored.
+  /* Extracts the talker, the sentence format and the field contents from a NMEA sentence string.
+   * The '$' and the checksum are ignored.
    *
    * Pre-condition: the argument string must conform to the structure of NMEA sentences.
    * Non-conforming arguments cause undefined behaviour.
@@ -71,7 +159,8 @@ namespace GPS::NMEA
 
 
   /* Check whether the sentence data contains the correct number of fields for the
-   * sentence format.
+   * sentence format.  Some formats allow for the extra fields added by later revisions of
+   * the NMEA standard.
    *
    * Pre-condition: the sentence data contains a supported format.
    * Unsupported formats cause undefined behaviour.
@@ -80,11 +169,11 @@ namespace GPS::NMEA
 
 
   /* Computes a Position from NMEA sentence data.
-   * Currently only supports the GLL, GGA and RMC sentence formats.
+   * Supports the formats that carry a position: GLL, GGA, RMC and GNS.
    * If the format does not contain elevation data, then the elevation is set to zero.
    *
    * Throws a std::domain_error exception if the neccessary data fields contain
-   * invalid data.
+   * invalid data, or if the format does not carry a position.
    *
    * Pre-conditions:
    *   - the sentence data contains a supported format;
@@ -94,18 +183,126 @@ namespace GPS::NMEA
   Position positionFromSentenceData(SentenceData);
 
 
+  /* The outcome of decoding a sentence, reported by status code rather than by exception, so
+   * that rejecting a bad sentence costs about as little as accepting a good one.
+   */
+  enum class DecodeStatus : std::uint8_t
+  {
+      ok,
+      invalidStructure,    // see hasValidSentenceStructure()
+      checksumMismatch,    // see checksumMatches()
+      unsupportedFormat,   // see isSupportedFormat()
+      noPosition,          // a supported format that does not carry a position, e.g. "GSV"
+      wrongNumberOfFields, // see hasCorrectNumberOfFields()
+      badBearing,          // not 'N'/'S' or 'E'/'W' as appropriate
+      malformedNumber,     // a field that must be numeric is not
+      outOfRange,          // a well-formed latitude, longitude or elevation that is geometrically invalid
+      poorQuality          // rejected by a QualityFilter
+  };
+
+  inline constexpr std::size_t numDecodeStatuses = 10;
+
+  /* The number of lines with each decode status, which callers can read after a run.
+   * Recording a status is a single increment.
+   */
+  struct DecodeCounters
+  {
+      std::uint64_t counts[numDecodeStatuses] = {};
+
+      void record(DecodeStatus);
+      std::uint64_t operator[](DecodeStatus) const;
+
+      // All the lines that were not decoded successfully.
+      std::uint64_t rejected() const;
+
+      DecodeCounters& operator+=(const DecodeCounters&);
+  };
+
+  /* Checks and decodes the position in a single line, without throwing exceptions or allocating
+   * (once the sentence view has grown to the largest sentence).  A final '\r' is ignored.
+   * The lat/lon/ele outputs are set only if the result is DecodeStatus::ok.
+   */
+  DecodeStatus decodePositionSentence(std::string_view line, SentenceView&, degrees& lat, degrees& lon, metres& ele);
+
+
+  /* Thresholds on the receiver's own assessment of a fix: the GGA fix quality indicator, and the
+   * number of satellites used and the HDOP (from GGA and GNS sentences).  Formats that do not
+   * carry a field are not filtered on it, and nor are sentences that leave it empty.
+   *
+   * The default filter rejects only GGA sentences whose quality is 0 ("fix not available").
+   */
+  struct QualityFilter
+  {
+      unsigned int minQuality = 1;
+      unsigned int minSatellites = 0;
+      double maxHdop = std::numeric_limits<double>::infinity();
+  };
+
+  /* As above, but first applies the filter to the raw quality fields, so that a rejected sentence
+   * (DecodeStatus::poorQuality) costs a few character comparisons, and its coordinates are never
+   * decoded.  A quality field that the filter needs but that is not a number is malformed.
+   */
+  DecodeStatus decodePositionSentence(std::string_view line, SentenceView&, const QualityFilter&,
+                                      degrees& lat, degrees& lon, metres& ele);
+
+
   /* Reads a stream of NMEA sentences (one sentence per line), and constructs a
    * vector of Positions, ignoring any lines that do not contain valid sentences.
    *
    * A line is a valid sentence if all of the following are true:
    *  - the line conforms to the structure of NMEA sentences;
    *  - the checksum matches;
-   *  - the sentence format is supported (currently GLL, GGA and RMC);
+   *  - the sentence format is supported, and carries a position (GLL, GGA, RMC or GNS);
    *  - the sentence has the correct number of fields;
    *  - the neccessary fields contain valid data.
    */
   std::vector<Position> readSentences(std::istream &);
 
+
+  /* As readSentences(), reporting progress to the monitor as the data is read, and throwing an
+   * IO::Cancelled exception if the monitor cancels the read.
+   */
+  std::vector<Position> readSentences(std::istream &, IO::ProgressMonitor &);
+
+  /* As readSentences(), also counting every non-empty line by its decode status.
+   * The counters are added to, so that they can accumulate over several streams.
+   */
+  std::vector<Position> readSentences(std::istream &, DecodeCounters &);
+
+  /* As readSentences(), also ignoring sentences rejected by the filter (see above), optionally
+   * counting every non-empty line by its decode status.
+   */
+  std::vector<Position> readSentences(std::istream &, const QualityFilter &);
+  std::vector<Position> readSentences(std::istream &, const QualityFilter &, DecodeCounters &);
+
+
+  /* As readSentences(), but reads a file by memory-mapping it, cutting it into newline-aligned
+   * chunks, and reading the chunks in parallel; the Positions are returned in file order.
+   * If the thread count is zero, one thread per hardware core is used.
+   *
+   * Throws a std::invalid_argument exception if the file cannot be opened.
+   */
+  std::vector<Position> readSentencesParallel(const std::string & filepath, unsigned int threadCount = 0);
+
+
+  /* Calls the function on each line of the stream, excluding the '\n' line terminator (but not
+   * any '\r').  The stream is read in large blocks, and each line is passed as a view into the
+   * block, valid only for the duration of the call.  The final line need not be terminated.
+   */
+  void forEachLine(std::istream &, const std::function<void(std::string_view)> &);
+
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  inline void DecodeCounters::record(DecodeStatus status)
+  {
+      ++counts[static_cast<std::size_t>(status)];
+  }
+
+  inline std::uint64_t DecodeCounters::operator[](DecodeStatus status) const
+  {
+      return counts[static_cast<std::size_t>(status)];
+  }
 }
 
 #endif
@@ -0,0 +1,132 @@
+#ifndef GPS_NMEA_REPLAY_H
+#define GPS_NMEA_REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "waypoints.h"
+
+namespace GPS::NMEA
+{
+  /* A recorded log prepared for replay: its sentences held in one block of text, each terminated
+   * by "\r\n", together with the time at which each sentence is due, in seconds from the first.
+   */
+  class ReplayLog
+  {
+    public:
+      /* Every non-blank line of an NMEA log, including lines that are not valid sentences, since
+       * receivers send those too.  Each line is due at the time of day of the most recent sentence
+       * carrying one (or of the first such sentence, for lines that precede it); times that pass
+       * midnight continue into the next day, and times never go backwards.
+       * If no sentence carries a time of day, every line is due at once.
+       */
+      static ReplayLog fromNMEA(std::istream&);
+
+      // A GGA and an RMC sentence per track point (see SentenceEmitter), due at the point's time.
+      static ReplayLog fromTrack(const std::vector<GPS::TrackPoint>&);
+
+      std::string_view text() const;
+      std::size_t sentenceCount() const;
+
+      // The time at which the last sentence is due.
+      double duration() const;
+
+      // The time at which the sentence is due, and the offset within text() just past its end.
+      double dueTime(std::size_t sentenceIndex) const;
+      std::size_t sentenceEnd(std::size_t sentenceIndex) const;
+
+      // The number of sentences due at or before the time.
+      std::size_t sentencesDueBy(double time) const;
+
+    private:
+      std::string sentences;
+      std::vector<std::size_t> ends;
+      std::vector<double> dueTimes;
+
+      void append(std::string_view sentence, double dueTime);
+  };
+
+
+  /* Writes a ReplayLog to any number of file descriptors (pipes, pseudo-terminals, stream
+   * sockets), all replaying the same log on the same schedule, from a single thread.
+   *
+   * The speed is a multiple of real time, or zero to write as fast as the readers accept the
+   * data.  Whenever the schedule falls due, every sentence that is due is written in one block,
+   * so high speeds cost no more system calls than low ones.  The descriptors are switched to
+   * non-blocking mode (and restored on destruction, but not closed): a reader that falls behind
+   * is caught up when it can accept more data, without holding up the others.
+   *
+   * A repeated log starts again one second after its last sentence.
+   *
+   * A device whose reader goes away (e.g. the read end of a pipe is closed) is dropped and
+   * counted.  Writing to a closed pipe raises SIGPIPE, so that signal should be ignored.
+   */
+  class Replayer
+  {
+    public:
+      // Throws a std::invalid_argument exception if the speed is negative or there are no repetitions.
+      Replayer(const ReplayLog&, double speed = 1, unsigned int repetitions = 1);
+
+      // The log is not copied, so must outlive the Replayer; a temporary log would not.
+      Replayer(ReplayLog&&, double speed = 1, unsigned int repetitions = 1) = delete;
+      ~Replayer();
+
+      Replayer(const Replayer&) = delete;
+      Replayer& operator=(const Replayer&) = delete;
+
+      // Throws a std::invalid_argument exception if the descriptor is invalid.
+      void addDevice(int fd);
+
+      /* Replays the log to every device, returning when every device has been sent every
+       * repetition or has been dropped, or when stop() is called (from another thread), which
+       * takes effect within 'stopLatency'.
+       */
+      void run(std::chrono::milliseconds stopLatency = std::chrono::milliseconds(100));
+      void stop();
+
+      // Complete sentences written, summed over all devices.
+      std::uint64_t sentencesWritten() const;
+      std::size_t droppedDevices() const;
+
+    private:
+      // A point in the replay: an offset into the log text, within one of the repetitions.
+      struct Progress
+      {
+          unsigned int repetition = 0;
+          std::size_t offset = 0;
+      };
+
+      struct Device
+      {
+          int fd;
+          int originalFlags;
+          Progress progress;
+          std::size_t nextSentence = 0; // The first sentence not yet completely written.
+          bool dropped = false;
+      };
+
+      enum class WriteState { caughtUp, blocked, turnOver, dropped };
+
+      const ReplayLog& log;
+      const double speed;
+      const unsigned int repetitions;
+      const double loopPeriod;
+
+      std::vector<Device> devices;
+      std::atomic<bool> stopping {false};
+      std::atomic<std::uint64_t> sentences {0};
+      std::atomic<std::size_t> dropped {0};
+
+      Progress dueBy(double logTime) const;
+      double nextDueTime(double logTime) const;
+      WriteState writeDue(Device&, Progress due);
+  };
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef GPS_NMEA_TRACK_H
+#define GPS_NMEA_TRACK_H
+
+#include <optional>
+#include <vector>
+#include <istream>
+
+#include "waypoints.h"
+#include "nmea-formats.h"
+
+namespace GPS::NMEA
+{
+  /* Reads a stream of NMEA sentences (one sentence per line), and constructs a vector of
+   * TrackPoints, one per epoch that has both a position and a time of day, ignoring any lines
+   * that do not contain valid sentences.  The sentences of each epoch (e.g. a GGA and an RMC
+   * sentence) are fused into one point by an EpochFuser, so the elevation comes from GGA where
+   * available.  The TrackPoints can be passed directly to Analysis::Track.
+   *
+   * Only RMC and ZDA sentences carry a date.  Each point is dated with the most recent date, and
+   * the date advances by one day whenever the time of day goes backwards by more than twelve
+   * hours (i.e. when the time passes midnight).  Points that precede the first dated sentence
+   * are dated backwards from it in the same way.
+   *
+   * If the data contains no dated sentences, the points are dated forwards from the start date.
+   * Throws a std::domain_error exception if it contains neither dates nor a start date is given.
+   *
+   * TrackPoint times have a resolution of one second, so any fractions of a second are dropped.
+   */
+  std::vector<GPS::TrackPoint> readTrackPoints(std::istream&, std::optional<Date> startDate = {});
+
+
+  // The calendar day before or after the date.
+  Date previousDay(Date);
+  Date nextDay(Date);
+}
+
+#endif
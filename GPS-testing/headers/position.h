@@ -1,12 +1,18 @@
 #ifndef GPS_POSITION_H
 #define GPS_POSITION_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 #include "types.h"
+#include "geometry.h"
+#include "earth-constants.h"
 
 namespace GPS
 {
+  class GeodeticPoint;
+
   /* A Position object represents a location on, within, or above the Earth's surface.
    * The location is identifed by degrees latitude, degrees longitude, and elevation.
    * Elevation is relative to the Earth's mean radius, i.e. roughly, but not exactly, the Earth's surface.
@@ -20,7 +26,7 @@ namespace GPS
 
       /* Construct a Position from numeric degrees latitude, degrees longitude, and elevation in metres.
        */
-      Position(degrees lat, degrees lon, metres ele);
+      constexpr Position(degrees lat, degrees lon, metres ele);
 
       /* Construct a Position from strings containing a DDM (degrees and decimal minutes) representation of latitude and
        * longitude, with 'N'/'S' and 'E'/'W' characters to indicate bearing (positive or negative), and elevation in metres.
@@ -29,24 +35,116 @@ namespace GPS
                std::string ddmLonStr, char lonBearing,
                std::string eleStr);
 
-      degrees latitude() const;
-      degrees longitude() const;
-      metres  elevation() const;
+      constexpr degrees latitude() const;
+      constexpr degrees longitude() const;
+      constexpr metres  elevation() const;
 
       /* Computes an approximation of the horizontal distance between two Positions on the Earth's surface.
        * Does NOT take into account elevation.
        */
       static metres horizontalDistanceBetween(Position, Position);
 
+      // As above, without converting either point to radians or computing the cosines of their latitudes.
+      static metres horizontalDistanceBetween(const GeodeticPoint&, const GeodeticPoint&);
+
     private:
       degrees lat;
       degrees lon;
       metres  ele;
+
+      // Out-of-line, so that the numeric constructor can be evaluated in constant expressions.
+      [[noreturn]] static void throwInvalidLatitude();
+      [[noreturn]] static void throwInvalidLongitude();
+      [[noreturn]] static void throwInvalidElevation();
+  };
+
+  /* A Position's latitude and longitude in radians, and the cosine of its latitude, computed once
+   * on construction, for measuring many distances to or from the same point; e.g. each point
+   * along a route, which ends one segment and starts the next.
+   * Elevation is not stored, as it plays no part in horizontal distances.
+   */
+  class GeodeticPoint
+  {
+    public:
+      explicit GeodeticPoint(const Position&);
+
+      /* As above, from a latitude and longitude in degrees, which are not validated (so that
+       * batch computations behave the same whatever the coordinates; see haversine.h).
+       */
+      static GeodeticPoint fromDegrees(degrees lat, degrees lon);
+
+      radians latitude() const;
+      radians longitude() const;
+      double  cosLatitude() const;
+
+    private:
+      GeodeticPoint(radians lat, radians lon);
+
+      radians lat;
+      radians lon;
+      double  cosLat;
   };
 
   /* Convert a DDM (degrees and decimal minutes) string representation of an angle to a numeric DD (decimal degrees) value.
    */
   degrees ddmTodd(std::string);
+
+  /* Convert a DDM string (e.g. "5425.32": the last two digits before the point are whole minutes,
+   * and any digits before them are degrees) to decimal degrees, parsing the digits as integers.
+   * No floating-point parsing is done and no strings are constructed, and the result is the
+   * double nearest to the exact value (fraction digits beyond the 11th are ignored).
+   *
+   * Returns false, without throwing, unless the string has 1-5 digits before an optional
+   * point, only digits after it, and fewer than 60 whole minutes.  Signs are not accepted;
+   * a N/S or E/W bearing conveys the sign.
+   */
+  bool decodeDDM(std::string_view, degrees&);
+
+  // As decodeDDM(), producing a fixed-point value in units of 10^-7 degrees, rounded to the nearest unit.
+  bool decodeDDME7(std::string_view, std::int64_t& e7);
+
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  constexpr Position::Position(degrees lat, degrees lon, metres ele)
+    : lat{lat},
+      lon{lon},
+      ele{ele}
+  {
+      if (! isValidLatitude(lat)) throwInvalidLatitude();
+      if (! isValidLongitude(lon)) throwInvalidLongitude();
+      if (! Earth::isValidElevation(ele)) throwInvalidElevation();
+  }
+
+  constexpr degrees Position::latitude() const
+  {
+      return lat;
+  }
+
+  constexpr degrees Position::longitude() const
+  {
+      return lon;
+  }
+
+  constexpr metres Position::elevation() const
+  {
+      return ele;
+  }
+
+  inline radians GeodeticPoint::latitude() const
+  {
+      return lat;
+  }
+
+  inline radians GeodeticPoint::longitude() const
+  {
+      return lon;
+  }
+
+  inline double GeodeticPoint::cosLatitude() const
+  {
+      return cosLat;
+  }
 }
 
 #endif
@@ -25,6 +25,7 @@ class Element
     AttributeValue getAttribute(AttributeName) const;
     Element getSubElement(ElementName, std::size_t subElementNum = 0) const;
     LeafContent getLeafContent() const;
+    const SubElements& getAllSubElements() const;
 
     bool containsAttribute(AttributeName) const;
     bool containsSubElement(ElementName) const;
@@ -3,6 +3,7 @@
 #include <stdexcept>
 
 #include "geometry.h"
+#include "haversine.h"
 
 #include "analysis-route.h"
 
@@ -10,7 +11,8 @@ namespace GPS::Analysis
 {
 
 Route::Route(std::vector<RoutePoint> routePoints)
-    : routePoints{routePoints}
+    : routePoints{routePoints},
+      geodeticPoints{routePointsToGeodeticPoints(routePoints)}
 {}
 
 unsigned int Route::numPoints() const
@@ -23,10 +25,11 @@ metres Route::totalLength() const
     if (routePoints.empty()) throw std::domain_error("Cannot compute the length of an empty route.");
 
     metres lengthSoFar = 0;
+    const std::vector<metres> horizontalDifferences = horizontalDistances();
 
     for (unsigned int current = 0, next = 1; next < routePoints.size() ; ++current, ++next)
     {
-        metres horizontalDifference = Position::horizontalDistanceBetween(routePoints[current].position, routePoints[next].position);
+        metres horizontalDifference = horizontalDifferences[current];
         metres verticalDifference = routePoints[next].position.elevation() - routePoints[current].position.elevation();
         lengthSoFar += pythagoras(horizontalDifference,verticalDifference);
     }
@@ -38,7 +41,7 @@ metres Route::netLength() const
 {
     if (routePoints.empty()) throw std::domain_error("Cannot compute the length of an empty route.");
 
-    metres horizontalDifference = Position::horizontalDistanceBetween(routePoints.front().position, routePoints.back().position);
+    metres horizontalDifference = Position::horizontalDistanceBetween(geodeticPoints.front(), geodeticPoints.back());
     metres verticalDifference = routePoints.back().position.elevation() - routePoints.front().position.elevation();
     return pythagoras(horizontalDifference,verticalDifference);
 }
@@ -71,10 +74,11 @@ degrees Route::maxGradient() const
     if (routePoints.size() < 2) throw std::domain_error("Cannot compute gradients on a route of fewer than two points.");
 
     degrees maxGrad = -halfRotation/2; // minimum possible gradient value
+    const std::vector<metres> horizontalDifferences = horizontalDistances();
 
     for (unsigned int current = 0, next = 1; next < routePoints.size() ; ++current, ++next)
     {
-        metres horizontalDifference = Position::horizontalDistanceBetween(routePoints[current].position, routePoints[next].position);
+        metres horizontalDifference = horizontalDifferences[current];
         metres verticalDifference = routePoints[next].position.elevation() - routePoints[current].position.elevation();
         degrees grad = radToDeg(std::atan(verticalDifference/horizontalDifference));
         maxGrad = std::max(maxGrad,grad);
@@ -88,10 +92,11 @@ degrees Route::minGradient() const
     if (routePoints.size() < 2) throw std::domain_error("Cannot compute gradients on a route of fewer than two points.");
 
     degrees minGrad = halfRotation/2; // maximum possible gradient value
+    const std::vector<metres> horizontalDifferences = horizontalDistances();
 
     for (unsigned int current = 0, next = 1; next < routePoints.size() ; ++current, ++next)
     {
-        metres horizontalDifference = Position::horizontalDistanceBetween(routePoints[current].position, routePoints[next].position);
+        metres horizontalDifference = horizontalDifferences[current];
         metres verticalDifference = routePoints[next].position.elevation() - routePoints[current].position.elevation();
         degrees grad = radToDeg(std::atan(verticalDifference/horizontalDifference));
         minGrad = std::min(minGrad,grad);
@@ -105,10 +110,11 @@ degrees Route::steepestGradient() const
     if (routePoints.size() < 2) throw std::domain_error("Cannot compute gradients on a route of fewer than two points.");
 
     degrees steepestGrad = 0; // minimum possible gradient value
+    const std::vector<metres> horizontalDifferences = horizontalDistances();
 
     for (unsigned int current = 0, next = 1; next < routePoints.size() ; ++current, ++next)
     {
-        metres horizontalDifference = Position::horizontalDistanceBetween(routePoints[current].position, routePoints[next].position);
+        metres horizontalDifference = horizontalDifferences[current];
         metres verticalDifference = routePoints[next].position.elevation() - routePoints[current].position.elevation();
         degrees grad = radToDeg(std::atan(verticalDifference/horizontalDifference));
         if (std::abs(grad) > std::abs(steepestGrad))
@@ -244,11 +250,13 @@ RoutePoint Route::nearestPointTo(Position targetPosition) const
     if (routePoints.empty()) throw std::domain_error("Cannot locate nearest point in an empty route.");
 
     RoutePoint nearestPointSoFar = routePoints.front();
-    metres shortestDistanceSoFar = Position::horizontalDistanceBetween(nearestPointSoFar.position, targetPosition);
+    const std::vector<metres> horizontalDifferences = horizontalDistancesTo(targetPosition);
+    metres shortestDistanceSoFar = horizontalDifferences.front();
 
-    for (const RoutePoint& currentPoint : routePoints)
+    for (unsigned int i = 0; i < routePoints.size(); ++i)
     {
-        metres horizontalDifference = Position::horizontalDistanceBetween(currentPoint.position, targetPosition);
+        const RoutePoint& currentPoint = routePoints[i];
+        metres horizontalDifference = horizontalDifferences[i];
         metres verticalDifference = currentPoint.position.elevation() - targetPosition.elevation();
         metres currentDistance = pythagoras(horizontalDifference,verticalDifference);
         if (currentDistance < shortestDistanceSoFar)
@@ -266,11 +274,13 @@ RoutePoint Route::farthestPointFrom(Position avoidedPosition) const
     if (routePoints.empty()) throw std::domain_error("Cannot locate farthest point in an empty route.");
 
     RoutePoint farthestPointSoFar = routePoints.front();
-    metres longestDistanceSoFar = Position::horizontalDistanceBetween(farthestPointSoFar.position, avoidedPosition);
+    const std::vector<metres> horizontalDifferences = horizontalDistancesTo(avoidedPosition);
+    metres longestDistanceSoFar = horizontalDifferences.front();
 
-    for (const RoutePoint& currentPoint : routePoints)
+    for (unsigned int i = 0; i < routePoints.size(); ++i)
     {
-        metres horizontalDifference = Position::horizontalDistanceBetween(currentPoint.position, avoidedPosition);
+        const RoutePoint& currentPoint = routePoints[i];
+        metres horizontalDifference = horizontalDifferences[i];
         metres verticalDifference = currentPoint.position.elevation() - avoidedPosition.elevation();
         metres currentDistance = pythagoras(horizontalDifference,verticalDifference);
         if (currentDistance > longestDistanceSoFar)
@@ -286,10 +296,12 @@ RoutePoint Route::farthestPointFrom(Position avoidedPosition) const
 unsigned int Route::numPointsNear(Position targetPosition, metres nearDistance) const
 {
     unsigned int numNear = 0;
+    const std::vector<metres> horizontalDifferences = horizontalDistancesTo(targetPosition);
 
-    for (const RoutePoint& routePoint : routePoints)
+    for (unsigned int i = 0; i < routePoints.size(); ++i)
     {
-        metres horizontalDifference = Position::horizontalDistanceBetween(routePoint.position, targetPosition);
+        const RoutePoint& routePoint = routePoints[i];
+        metres horizontalDifference = horizontalDifferences[i];
         metres verticalDifference = routePoint.position.elevation() - targetPosition.elevation();
         metres currentDistance = pythagoras(horizontalDifference,verticalDifference);
         if (currentDistance < nearDistance) ++numNear;
@@ -334,5 +346,69 @@ RoutePoint Route::operator[](unsigned int index) const
     return routePoints[index];
 }
 
+std::vector<metres> Route::horizontalDistances() const
+{
+    std::vector<metres> distances;
+    if (bestDistanceKernel() == DistanceKernel::scalar)
+    {
+        distances.reserve(geodeticPoints.size());
+        for (std::size_t i = 1; i < geodeticPoints.size(); ++i)
+        {
+            distances.push_back(haversineDistance(geodeticPoints[i-1], geodeticPoints[i]));
+        }
+        return distances;
+    }
+
+    std::vector<degrees> latitudes, longitudes;
+    coordinateArrays(latitudes, longitudes);
+    consecutiveDistances(latitudes, longitudes, distances, DistanceKernel::avx2);
+    return distances;
+}
+
+std::vector<metres> Route::horizontalDistancesTo(Position target) const
+{
+    std::vector<metres> distances;
+    if (bestDistanceKernel() == DistanceKernel::scalar)
+    {
+        const GeodeticPoint targetPoint {target};
+        distances.reserve(geodeticPoints.size());
+        for (const GeodeticPoint& point : geodeticPoints)
+        {
+            distances.push_back(haversineDistance(point, targetPoint));
+        }
+        return distances;
+    }
+
+    std::vector<degrees> latitudes, longitudes;
+    coordinateArrays(latitudes, longitudes);
+    distancesTo(latitudes, longitudes, target.latitude(), target.longitude(), distances, DistanceKernel::avx2);
+    return distances;
+}
+
+void Route::coordinateArrays(std::vector<degrees>& latitudes, std::vector<degrees>& longitudes) const
+{
+    latitudes.reserve(routePoints.size());
+    longitudes.reserve(routePoints.size());
+
+    for (const RoutePoint& routePoint : routePoints)
+    {
+        latitudes.push_back(routePoint.position.latitude());
+        longitudes.push_back(routePoint.position.longitude());
+    }
+}
+
+std::vector<GeodeticPoint> Route::routePointsToGeodeticPoints(const std::vector<RoutePoint>& routePoints)
+{
+    std::vector<GeodeticPoint> geodeticPoints;
+    geodeticPoints.reserve(routePoints.size());
+
+    for (const RoutePoint& routePoint : routePoints)
+    {
+        geodeticPoints.emplace_back(routePoint.position);
+    }
+
+    return geodeticPoints;
+}
+
 
 }
@@ -43,7 +43,7 @@ seconds Track::restingTime() const
 
     for (unsigned int current = 0, next = 1; next < timeStamps.size() ; ++current, ++next)
     {
-        if (withinRestingRange(routePoints[current], routePoints[next]))
+        if (withinRestingRange(current, next))
         {
             if (timeStamps[next] < timeStamps[current]) throw std::domain_error("Track contains rests of negative time duration.");
 
@@ -61,7 +61,7 @@ seconds Track::travellingTime() const
 
     for (unsigned int current = 0, next = 1; next < timeStamps.size() ; ++current, ++next)
     {
-        if (! withinRestingRange(routePoints[current], routePoints[next]))
+        if (! withinRestingRange(current, next))
         {
             if (timeStamps[next] < timeStamps[current]) throw std::domain_error("Track contains travelling with negative time duration.");
 
@@ -81,7 +81,7 @@ seconds Track::longestRestingPeriod() const
 
     for (unsigned int current = 0, next = 1; next < timeStamps.size() ; ++current, ++next)
     {
-        if (withinRestingRange(routePoints[current], routePoints[next]))
+        if (withinRestingRange(current, next))
         {
             if (timeStamps[next] < timeStamps[current]) throw std::domain_error("Track contains rests of negative time duration.");
 
@@ -111,7 +111,7 @@ std::chrono::seconds Track::longestTravellingPeriod() const
 
     for (unsigned int current = 0, next = 1; next < timeStamps.size() ; ++current, ++next)
     {
-        if (! withinRestingRange(routePoints[current], routePoints[next]))
+        if (! withinRestingRange(current, next))
         {
             if (timeStamps[next] < timeStamps[current]) throw std::domain_error("Track contains travelling of negative time duration.");
 
@@ -140,7 +140,7 @@ seconds Track::averageRestingPeriod() const
 
     for (unsigned int current = 0, next = 1; next < timeStamps.size() ; ++current, ++next)
     {
-        if (withinRestingRange(routePoints[current], routePoints[next]))
+        if (withinRestingRange(current, next))
         {
             currentlyResting = true;
         }
@@ -165,7 +165,7 @@ seconds Track::averageTravellingPeriod() const
 
     for (unsigned int current = 0, next = 1; next < timeStamps.size() ; ++current, ++next)
     {
-        if (! withinRestingRange(routePoints[current], routePoints[next]))
+        if (! withinRestingRange(current, next))
         {
             currentlyTravelling = true;
         }
@@ -191,7 +191,9 @@ speed Track::maxSpeed() const
 
     for (unsigned int current = 0, next = 1; next < timeStamps.size() ; ++current, ++next)
     {
-        if (! withinRestingRange(routePoints[current], routePoints[next]))
+        metres distance = distanceBetween(current, next);
+
+        if (! (distance < restingRange))
         {
             if (timeStamps[next] < timeStamps[current]) throw std::domain_error("Track contains travelling of negative time duration.");
 
@@ -199,14 +201,6 @@ speed Track::maxSpeed() const
 
             if (timeDifference == seconds::zero()) throw std::domain_error("Cannot compute maximum speed in m/s when there is travelling of zero seconds duration.");
 
-            Position currentPos = routePoints[current].position;
-            Position nextPos = routePoints[next].position;
-
-            metres horizontalDifference = Position::horizontalDistanceBetween(currentPos,nextPos);
-            metres verticalDifference = nextPos.elevation() - currentPos.elevation();
-
-            metres distance = pythagoras(horizontalDifference,verticalDifference);
-
             speed currentSpeed = distance / timeDifference.count();
 
             maximumSpeed =  std::max(currentSpeed,maximumSpeed);
@@ -236,7 +230,9 @@ speed Track::averageTravellingSpeed() const
 
     for (unsigned int current = 0, next = 1; next < timeStamps.size() ; ++current, ++next)
     {
-        if (! withinRestingRange(routePoints[current], routePoints[next]))
+        metres distance = distanceBetween(current, next);
+
+        if (! (distance < restingRange))
         {
             if (timeStamps[next] < timeStamps[current]) throw std::domain_error("Track contains travelling of negative time duration.");
 
@@ -244,13 +240,7 @@ speed Track::averageTravellingSpeed() const
 
             if (timeDifference == seconds::zero()) throw std::domain_error("Cannot compute average speed in m/s when there is travelling of zero seconds duration.");
 
-            Position currentPos = routePoints[current].position;
-            Position nextPos = routePoints[next].position;
-
-            metres horizontalDifference = Position::horizontalDistanceBetween(currentPos,nextPos);
-            metres verticalDifference = nextPos.elevation() - currentPos.elevation();
-
-            distanceTravelled += pythagoras(horizontalDifference,verticalDifference);
+            distanceTravelled += distance;
 
             timeTravelling += timeDifference;
         }
@@ -271,7 +261,7 @@ speed Track::maxRateOfAscent() const
 
     for (unsigned int current = 0, next = 1; next < timeStamps.size() ; ++current, ++next)
     {
-        if (! withinRestingRange(routePoints[current], routePoints[next]))
+        if (! withinRestingRange(current, next))
         {
             if (timeStamps[next] < timeStamps[current]) throw std::domain_error("Track contains travelling of negative time duration.");
 
@@ -302,7 +292,7 @@ speed Track::maxRateOfDescent() const
 
     for (unsigned int current = 0, next = 1; next < timeStamps.size() ; ++current, ++next)
     {
-        if (! withinRestingRange(routePoints[current], routePoints[next]))
+        if (! withinRestingRange(current, next))
         {
             if (timeStamps[next] < timeStamps[current]) throw std::domain_error("Track contains travelling of negative time duration.");
 
@@ -349,12 +339,16 @@ std::vector<Track::TimeStamp> Track::trackPointsToTimeStamps(std::vector<TrackPo
     return timeStamps;
 }
 
-bool Track::withinRestingRange(RoutePoint pt1, RoutePoint pt2) const
+metres Track::distanceBetween(unsigned int first, unsigned int second) const
+{
+    metres horizontalDifference = Position::horizontalDistanceBetween(geodeticPoints[first],geodeticPoints[second]);
+    metres verticalDifference = routePoints[second].position.elevation() - routePoints[first].position.elevation();
+    return pythagoras(horizontalDifference,verticalDifference);
+}
+
+bool Track::withinRestingRange(unsigned int first, unsigned int second) const
 {
-    metres horizontalDifference = Position::horizontalDistanceBetween(pt1.position,pt2.position);
-    metres verticalDifference = pt2.position.elevation() - pt1.position.elevation();
-    metres distance = pythagoras(horizontalDifference,verticalDifference);
-    return (distance < restingRange);
+    return (distanceBetween(first, second) < restingRange);
 }
 
 Track::TimeStamp Track::tmToTimeStamp(std::tm dateTime)
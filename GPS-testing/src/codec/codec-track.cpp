@@ -0,0 +1,314 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "geometry.h"
+
+#include "codec-track.h"
+
+namespace GPS::Codec
+{
+  const char magic[] = {'G','P','S','z'};
+  const std::uint8_t formatVersion = 1;
+
+  void appendUnsigned(Bytes& bytes, std::uint64_t value)
+  {
+      while (value >= 0x80)
+      {
+          bytes.push_back(std::uint8_t(value | 0x80));
+          value >>= 7;
+      }
+      bytes.push_back(std::uint8_t(value));
+  }
+
+  void appendSigned(Bytes& bytes, std::int64_t value)
+  {
+      appendUnsigned(bytes, (std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63)); // zig-zag encoding
+  }
+
+  std::uint64_t readUnsigned(const std::uint8_t*& it, const std::uint8_t* end)
+  {
+      std::uint64_t value = 0;
+      for (unsigned int shift = 0; ; shift += 7)
+      {
+          if (it == end || shift > 63) throw std::domain_error("Malformed varint in encoded track.");
+          const std::uint8_t byte = *it++;
+          value |= std::uint64_t(byte & 0x7F) << shift;
+          if (byte < 0x80) return value;
+      }
+  }
+
+  void appendDouble(Bytes& bytes, double value)
+  {
+      std::uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      for (int i = 0; i < 8; ++i) bytes.push_back(std::uint8_t(bits >> (8*i)));
+  }
+
+  double readDouble(const std::uint8_t*& it, const std::uint8_t* end)
+  {
+      if (end - it < 8) throw std::domain_error("Truncated encoded track header.");
+      std::uint64_t bits = 0;
+      for (int i = 0; i < 8; ++i) bits |= std::uint64_t(*it++) << (8*i);
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+  }
+
+  std::int64_t quantize(double value, double resolution)
+  {
+      return std::llround(value / resolution);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  std::size_t Columns::size() const
+  {
+      return latitudes.size();
+  }
+
+  void Columns::clear()
+  {
+      latitudes.clear();
+      longitudes.clear();
+      elevations.clear();
+      times.clear();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  TrackEncoder::TrackEncoder(Resolution resolution, unsigned int pointsPerBlock)
+    : resolution{resolution},
+      pointsPerBlock{pointsPerBlock}
+  {
+      if (! (resolution.angle > 0) || ! (resolution.elevation > 0))
+          throw std::invalid_argument("Encoding resolutions must be positive.");
+
+      if (pointsPerBlock == 0)
+          throw std::invalid_argument("Encoded blocks must contain at least one point.");
+
+      for (char c : magic) output.push_back(std::uint8_t(c));
+      output.push_back(formatVersion);
+      appendDouble(output, resolution.angle);
+      appendDouble(output, resolution.elevation);
+  }
+
+  void TrackEncoder::add(const TrackPoint& trackPoint)
+  {
+      add(trackPoint.position.latitude(), trackPoint.position.longitude(), trackPoint.position.elevation(),
+          tmToSeconds(trackPoint.dateTime));
+  }
+
+  void TrackEncoder::add(degrees lat, degrees lon, metres ele, std::time_t time)
+  {
+      const std::int64_t qLat = quantize(lat, resolution.angle);
+      const std::int64_t qLon = quantize(lon, resolution.angle);
+      const std::int64_t qEle = quantize(ele, resolution.elevation);
+      const std::int64_t qTime = time;
+
+      // The first point of each block is stored relative to zero, so that blocks are self-contained.
+      appendSigned(block, qLat - prevLat);
+      appendSigned(block, qLon - prevLon);
+      appendSigned(block, qEle - prevEle);
+      appendSigned(block, qTime - prevTime);
+
+      prevLat = qLat;
+      prevLon = qLon;
+      prevEle = qEle;
+      prevTime = qTime;
+
+      if (++pointsInBlock == pointsPerBlock) flushBlock();
+  }
+
+  Bytes TrackEncoder::finish()
+  {
+      flushBlock();
+      return output;
+  }
+
+  void TrackEncoder::flushBlock()
+  {
+      if (pointsInBlock == 0) return;
+
+      appendUnsigned(output, pointsInBlock);
+      appendUnsigned(output, block.size());
+      output.insert(output.end(), block.begin(), block.end());
+
+      block.clear();
+      pointsInBlock = 0;
+      prevLat = prevLon = prevEle = prevTime = 0;
+  }
+
+  Bytes encodeTrack(const std::vector<TrackPoint>& trackPoints, Resolution resolution, unsigned int pointsPerBlock)
+  {
+      TrackEncoder encoder {resolution, pointsPerBlock};
+      for (const TrackPoint& trackPoint : trackPoints)
+      {
+          encoder.add(trackPoint);
+      }
+      return encoder.finish();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  TrackDecoder::TrackDecoder(const Bytes& bytes)
+    : TrackDecoder(bytes.data(), bytes.size())
+  {}
+
+  TrackDecoder::TrackDecoder(const std::uint8_t* data, std::size_t size)
+  {
+      const std::uint8_t* it = data;
+      const std::uint8_t* end = data + size;
+
+      if (size < sizeof(magic) + 1 || ! std::equal(std::begin(magic), std::end(magic), it))
+          throw std::domain_error("Missing encoded track header.");
+      it += sizeof(magic);
+
+      if (*it++ != formatVersion)
+          throw std::domain_error("Unsupported encoded track version.");
+
+      res.angle = readDouble(it, end);
+      res.elevation = readDouble(it, end);
+
+      while (it != end)
+      {
+          const std::uint64_t numPoints = readUnsigned(it, end);
+          const std::uint64_t payloadSize = readUnsigned(it, end);
+          if (payloadSize > std::uint64_t(end - it))
+              throw std::domain_error("Truncated encoded track block.");
+          if (numPoints > payloadSize / 4) // Every point occupies at least one byte per channel.
+              throw std::domain_error("Malformed encoded track block.");
+
+          blocks.push_back({it, it + payloadSize, numPoints});
+          totalPoints += numPoints;
+          it += payloadSize;
+      }
+  }
+
+  Resolution TrackDecoder::resolution() const
+  {
+      return res;
+  }
+
+  std::size_t TrackDecoder::numBlocks() const
+  {
+      return blocks.size();
+  }
+
+  std::size_t TrackDecoder::numPoints() const
+  {
+      return totalPoints;
+  }
+
+  void TrackDecoder::decodeBlock(std::size_t blockIndex, Columns& columns) const
+  {
+      const Block& b = blocks.at(blockIndex);
+
+      const std::size_t oldSize = columns.size();
+      const std::size_t newSize = oldSize + b.numPoints;
+      columns.latitudes.resize(newSize);
+      columns.longitudes.resize(newSize);
+      columns.elevations.resize(newSize);
+      columns.times.resize(newSize);
+
+      const std::uint8_t* it = b.begin;
+      std::int64_t lat = 0, lon = 0, ele = 0, time = 0;
+      for (std::size_t i = oldSize; i < newSize; ++i)
+      {
+          lat  += readSigned(it, b.end);
+          lon  += readSigned(it, b.end);
+          ele  += readSigned(it, b.end);
+          time += readSigned(it, b.end);
+          columns.latitudes[i]  = lat * res.angle;
+          columns.longitudes[i] = lon * res.angle;
+          columns.elevations[i] = ele * res.elevation;
+          columns.times[i]      = std::time_t(time);
+      }
+      if (it != b.end) throw std::domain_error("Encoded track block has trailing bytes.");
+  }
+
+  void TrackDecoder::decodeAll(Columns& columns) const
+  {
+      columns.latitudes.reserve(columns.size() + totalPoints);
+      columns.longitudes.reserve(columns.size() + totalPoints);
+      columns.elevations.reserve(columns.size() + totalPoints);
+      columns.times.reserve(columns.size() + totalPoints);
+
+      for (std::size_t i = 0; i < blocks.size(); ++i)
+      {
+          decodeBlock(i, columns);
+      }
+  }
+
+  std::vector<TrackPoint> TrackDecoder::toTrackPoints() const
+  {
+      std::vector<TrackPoint> trackPoints;
+      trackPoints.reserve(totalPoints);
+
+      forEachPoint([&trackPoints] (degrees lat, degrees lon, metres ele, std::time_t time)
+      {
+          // Quantization may round a boundary value fractionally outside the valid range.
+          lat = std::clamp(lat, -poleLatitude, poleLatitude);
+          lon = std::clamp(lon, -antiMeridianLongitude, antiMeridianLongitude);
+          trackPoints.push_back({Position(lat,lon,ele), "", secondsToTm(time)});
+      });
+
+      return trackPoints;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  /* Date conversions based on the civil calendar algorithms by Howard Hinnant.
+   * See: http://howardhinnant.github.io/date_algorithms.html
+   */
+
+  std::int64_t daysFromCivil(std::int64_t y, unsigned int m, unsigned int d)
+  {
+      y -= m <= 2;
+      const std::int64_t era = (y >= 0 ? y : y-399) / 400;
+      const unsigned int yoe = static_cast<unsigned int>(y - era * 400);
+      const unsigned int doy = (153*(m > 2 ? m-3 : m+9) + 2)/5 + d-1;
+      const unsigned int doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+      return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+  }
+
+  std::time_t tmToSeconds(const std::tm& dateTime)
+  {
+      const std::int64_t days = daysFromCivil(dateTime.tm_year + 1900, dateTime.tm_mon + 1, dateTime.tm_mday);
+      return days * 86400 + dateTime.tm_hour * 3600 + dateTime.tm_min * 60 + dateTime.tm_sec;
+  }
+
+  std::tm secondsToTm(std::time_t seconds)
+  {
+      std::int64_t days = seconds / 86400;
+      std::int64_t secondOfDay = seconds % 86400;
+      if (secondOfDay < 0)
+      {
+          secondOfDay += 86400;
+          --days;
+      }
+
+      const std::int64_t z = days + 719468;
+      const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+      const unsigned int doe = static_cast<unsigned int>(z - era * 146097);
+      const unsigned int yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+      const unsigned int doy = doe - (365*yoe + yoe/4 - yoe/100);
+      const unsigned int mp = (5*doy + 2)/153;
+      const unsigned int d = doy - (153*mp+2)/5 + 1;
+      const unsigned int m = mp < 10 ? mp+3 : mp-9;
+      const std::int64_t y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2);
+
+      std::tm dateTime {};
+      dateTime.tm_year = int(y - 1900);
+      dateTime.tm_mon = int(m - 1);
+      dateTime.tm_mday = int(d);
+      dateTime.tm_hour = int(secondOfDay / 3600);
+      dateTime.tm_min = int(secondOfDay / 60 % 60);
+      dateTime.tm_sec = int(secondOfDay % 60);
+      dateTime.tm_wday = int((days % 7 + 11) % 7); // 1970-01-01 was a Thursday
+      dateTime.tm_yday = int(days - daysFromCivil(y, 1, 1));
+      dateTime.tm_isdst = -1;
+      return dateTime;
+  }
+}
@@ -8,18 +8,6 @@ namespace GPS
 {
   namespace Earth
   {
-      const Position NorthPole = Position(poleLatitude,0,0);
-      const Position SouthPole = Position(-poleLatitude,0,0);
-      const Position EquatorialMeridian = Position(0,0,0);
-      const Position EquatorialAntiMeridian = Position(0,antiMeridianLongitude,0);
-      const Position CliftonCampus = Position(52.91249953,-1.18402513,58);
-      const Position CityCampus = Position(52.9581383,-1.1542364,53);
-      const Position Pontianak = Position(0,109.322134,0);
-
-      const metres meanRadius = 6371008.8;
-      const metres equatorialCircumference = 40075160;
-      const metres polarCircumference = 40008000;
-
       metres circumferenceAtLatitude(degrees lat)
       {
           assert (isValidLatitude(lat));
@@ -52,10 +40,5 @@ namespace GPS
           }
       }
 
-      bool isValidElevation(metres elevation)
-      {
-          return elevation >= -meanRadius;
-      }
-
   }
 }
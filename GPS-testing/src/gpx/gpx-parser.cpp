@@ -2,9 +2,21 @@
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <cstdlib>
+#include <cctype>
+#include <cmath>
+#include <string_view>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <boost/algorithm/string.hpp>
 
+#include "geometry.h"
+#include "earth.h"
 #include "xml-parser.h"
 
 #include "gpx-parser.h"
@@ -126,42 +138,263 @@ namespace GPS::GPX
   }
 
 
-  std::vector<GPS::TrackPoint> extractTrackPointsFrom(const XML::Element& element)
-  {
-      std::vector<GPS::TrackPoint> trackPoints;
+  void extractSensorValuesFromPt(const XML::Element& ptElement, SensorColumns&);
 
+  // If 'sensorColumns' is not null, a row of sensor values is also appended for each point.
+  void extractTrackPointsFrom(const XML::Element& element, std::vector<GPS::TrackPoint>& trackPoints,
+                              SensorColumns* sensorColumns)
+  {
       requireSubElementExists(element,"trkpt");
-      for (unsigned int i = 0; i < element.countSubElements("trkpt"); ++i)
+      for (const XML::Element& trkpt : element.getAllSubElements().at("trkpt"))
       {
-          XML::Element trkpt = element.getSubElement("trkpt",i);
           trackPoints.push_back(extractTrackPointFromTrkpt(trkpt));
+          if (sensorColumns) extractSensorValuesFromPt(trkpt, *sensorColumns);
+      }
+  }
+
+  std::vector<GPS::TrackPoint> extractTrackPointsFromTrk(const XML::Element& trk, SensorColumns* sensorColumns)
+  {
+      std::vector<GPS::TrackPoint> trackPoints;
+
+      if (trk.containsSubElement("trkseg"))
+      {
+          for (const XML::Element& trkseg : trk.getAllSubElements().at("trkseg"))
+          {
+              extractTrackPointsFrom(trkseg, trackPoints, sensorColumns);
+          }
+      }
+      else
+      {
+          extractTrackPointsFrom(trk, trackPoints, sensorColumns);
       }
 
       return trackPoints;
   }
 
-  std::vector<GPS::TrackPoint> extractTrackPointsFromTrk(const XML::Element& trk)
+  std::vector<GPS::TrackPoint> parseTrackWith(std::istream& gpxData, SensorColumns* sensorColumns)
   {
-      if (trk.containsSubElement("trkseg"))
+      XML::Parser parser {gpxData};
+
+      XML::Element gpx = parser.parseRootElement();
+      requireElementIs(gpx,"gpx");
+
+      requireSubElementExists(gpx,"trk");
+      XML::Element trk = gpx.getSubElement("trk");
+
+      return extractTrackPointsFromTrk(trk, sensorColumns);
+  }
+
+  std::vector<GPS::TrackPoint> parseTrack(std::istream& gpxData)
+  {
+      return parseTrackWith(gpxData, nullptr);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  /* The functions below support lenient parsing.  Rather than throwing, they report failure
+   * through their return values, so that dirty data does not pay for exception handling.
+   */
+
+  bool tryParseNumber(const std::string& text, double& value)
+  {
+      const char* begin = text.c_str();
+      char* end;
+      value = std::strtod(begin, &end);
+      if (end == begin) return false;
+      while (std::isspace(static_cast<unsigned char>(*end))) ++end;
+      return *end == '\0' && std::isfinite(value);
+  }
+
+  bool tryParseDigits(const std::string& text, std::size_t pos, unsigned int numDigits, int& value)
+  {
+      if (pos + numDigits > text.size()) return false;
+      value = 0;
+      for (std::size_t i = pos; i < pos + numDigits; ++i)
+      {
+          if (! std::isdigit(static_cast<unsigned char>(text[i]))) return false;
+          value = value * 10 + (text[i] - '0');
+      }
+      return true;
+  }
+
+  /* Accepts the same "%Y-%m-%dT%H:%M:%SZ" format as parseDateTime(), and additionally tolerates
+   * surrounding whitespace and fractional seconds (which are discarded), as emitted by many devices.
+   */
+  bool tryParseDateTime(const std::string& rawDateTime, std::tm& dateTime)
+  {
+      const std::string text = boost::algorithm::trim_copy(rawDateTime);
+
+      int year, month, day, hour, minute, second;
+      if (! (tryParseDigits(text,0,4,year)    && text.size() > 4  && text[4]  == '-' &&
+             tryParseDigits(text,5,2,month)   && text.size() > 7  && text[7]  == '-' &&
+             tryParseDigits(text,8,2,day)     && text.size() > 10 && text[10] == 'T' &&
+             tryParseDigits(text,11,2,hour)   && text.size() > 13 && text[13] == ':' &&
+             tryParseDigits(text,14,2,minute) && text.size() > 16 && text[16] == ':' &&
+             tryParseDigits(text,17,2,second)))
+      {
+          return false;
+      }
+
+      std::size_t pos = 19;
+      if (pos < text.size() && text[pos] == '.')
+      {
+          ++pos;
+          const std::size_t fractionStart = pos;
+          while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) ++pos;
+          if (pos == fractionStart) return false;
+      }
+      if (pos + 1 != text.size() || text[pos] != 'Z') return false;
+
+      if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) return false;
+
+      dateTime = std::tm{};
+      dateTime.tm_year = year - 1900;
+      dateTime.tm_mon = month - 1;
+      dateTime.tm_mday = day;
+      dateTime.tm_hour = hour;
+      dateTime.tm_min = minute;
+      dateTime.tm_sec = second;
+      dateTime.tm_isdst = -1;
+      return true;
+  }
+
+  bool tryExtractTrackPointFromTrkpt(const XML::Element& trkpt, std::vector<GPS::TrackPoint>& trackPoints, PointError& error)
+  {
+      if (! trkpt.containsAttribute("lat")) { error = PointError::missingLatitude; return false; }
+      if (! trkpt.containsAttribute("lon")) { error = PointError::missingLongitude; return false; }
+
+      degrees lat, lon;
+      metres ele = 0;
+      if (! tryParseNumber(trkpt.getAttribute("lat"), lat)) { error = PointError::malformedLatitude; return false; }
+      if (! tryParseNumber(trkpt.getAttribute("lon"), lon)) { error = PointError::malformedLongitude; return false; }
+      if (trkpt.containsSubElement("ele") && ! tryParseNumber(trkpt.getSubElement("ele").getLeafContent(), ele))
+      {
+          error = PointError::malformedElevation;
+          return false;
+      }
+
+      if (! isValidLatitude(lat))          { error = PointError::invalidLatitude; return false; }
+      if (! isValidLongitude(lon))         { error = PointError::invalidLongitude; return false; }
+      if (! Earth::isValidElevation(ele))  { error = PointError::invalidElevation; return false; }
+
+      if (! trkpt.containsSubElement("time")) { error = PointError::missingTime; return false; }
+
+      std::tm dateTime;
+      if (! tryParseDateTime(trkpt.getSubElement("time").getLeafContent(), dateTime))
+      {
+          error = PointError::malformedTime;
+          return false;
+      }
+
+      trackPoints.push_back({GPS::Position(lat,lon,ele), extractNameFromOptionalSubElementOf(trkpt), dateTime});
+      return true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  const std::vector<std::string> garminSensorFields = {"hr", "cad", "power", "atemp"};
+
+  SensorColumns::SensorColumns(std::vector<std::string> fieldNames)
+    : fieldNames{fieldNames},
+      values(fieldNames.size()),
+      valid(fieldNames.size())
+  {}
+
+  void SensorColumns::clear()
+  {
+      values.assign(fieldNames.size(), {});
+      valid.assign(fieldNames.size(), {});
+  }
+
+  std::size_t SensorColumns::fieldIndex(const std::string& fieldName) const
+  {
+      for (std::size_t i = 0; i < fieldNames.size(); ++i)
       {
-          std::vector<GPS::TrackPoint> trackPoints;
+          if (fieldNames[i] == fieldName) return i;
+      }
+      throw std::out_of_range("No sensor field named '" + fieldName + "'.");
+  }
+
+  // Compare element names ignoring any namespace prefix, e.g. "gpxtpx:hr" matches "hr" and "ns3:hr".
+  bool localNamesMatch(std::string_view name1, std::string_view name2)
+  {
+      const std::size_t colon1 = name1.rfind(':');
+      const std::size_t colon2 = name2.rfind(':');
+      if (colon1 != std::string_view::npos) name1.remove_prefix(colon1 + 1);
+      if (colon2 != std::string_view::npos) name2.remove_prefix(colon2 + 1);
+      return name1 == name2;
+  }
 
-          for (unsigned int i = 0; i < trk.countSubElements("trkseg"); ++i)
+  void collectSensorValues(const XML::Element& element, SensorColumns& columns)
+  {
+      for (const auto& [name, subElements] : element.getAllSubElements())
+      {
+          for (const XML::Element& subElement : subElements)
           {
-              XML::Element trkseg = trk.getSubElement("trkseg",i);
-              std::vector<GPS::TrackPoint> trackPointsInThisSegment = extractTrackPointsFrom(trkseg);
-              trackPoints.insert(trackPoints.end(), trackPointsInThisSegment.begin(), trackPointsInThisSegment.end());
+              if (! subElement.isLeaf())
+              {
+                  collectSensorValues(subElement, columns);
+                  continue;
+              }
+
+              for (std::size_t field = 0; field < columns.fieldNames.size(); ++field)
+              {
+                  // The first occurrence of a field wins.
+                  if (! columns.valid[field].back() && localNamesMatch(name, columns.fieldNames[field]))
+                  {
+                      double value;
+                      if (tryParseNumber(subElement.getLeafContent(), value))
+                      {
+                          columns.values[field].back() = value;
+                          columns.valid[field].back() = true;
+                      }
+                  }
+              }
           }
+      }
+  }
 
-          return trackPoints;
+  // Append one row to the sensor columns for this point; fields that are absent or malformed are marked invalid.
+  void extractSensorValuesFromPt(const XML::Element& ptElement, SensorColumns& columns)
+  {
+      for (std::size_t field = 0; field < columns.fieldNames.size(); ++field)
+      {
+          columns.values[field].push_back(0);
+          columns.valid[field].push_back(false);
       }
-      else
+
+      const XML::SubElements& subElements = ptElement.getAllSubElements();
+      const auto extensions = subElements.find("extensions");
+      if (extensions != subElements.end())
       {
-          return extractTrackPointsFrom(trk);
+          for (const XML::Element& extensionsElement : extensions->second)
+          {
+              collectSensorValues(extensionsElement, columns);
+          }
       }
   }
 
-  std::vector<GPS::TrackPoint> parseTrack(std::istream& gpxData)
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  void extractTrackPointsLenientlyFrom(const XML::Element& element, std::vector<GPS::TrackPoint>& trackPoints,
+                                       unsigned int& index, ParseReport& report, SensorColumns* sensorColumns)
+  {
+      for (unsigned int i = 0; i < element.countSubElements("trkpt"); ++i, ++index)
+      {
+          PointError error;
+          const XML::Element& trkpt = element.getAllSubElements().at("trkpt")[i];
+          if (tryExtractTrackPointFromTrkpt(trkpt, trackPoints, error))
+          {
+              if (sensorColumns) extractSensorValuesFromPt(trkpt, *sensorColumns);
+          }
+          else
+          {
+              report.rejectedPoints.push_back({index, error});
+          }
+      }
+  }
+
+  std::vector<GPS::TrackPoint> parseTrackLeniently(std::istream& gpxData, ParseReport& report, SensorColumns* sensorColumns)
   {
       XML::Parser parser {gpxData};
 
@@ -171,6 +404,291 @@ namespace GPS::GPX
       requireSubElementExists(gpx,"trk");
       XML::Element trk = gpx.getSubElement("trk");
 
-      return extractTrackPointsFromTrk(trk);
+      std::vector<GPS::TrackPoint> trackPoints;
+      unsigned int index = 0;
+
+      extractTrackPointsLenientlyFrom(trk, trackPoints, index, report, sensorColumns);
+      for (unsigned int i = 0; i < trk.countSubElements("trkseg"); ++i)
+      {
+          extractTrackPointsLenientlyFrom(trk.getSubElement("trkseg",i), trackPoints, index, report, sensorColumns);
+      }
+
+      return trackPoints;
+  }
+
+  std::vector<GPS::TrackPoint> parseTrackLenient(std::istream& gpxData, ParseReport& report)
+  {
+      return parseTrackLeniently(gpxData, report, nullptr);
+  }
+
+  std::vector<GPS::TrackPoint> parseTrackLenient(std::istream& gpxData, ParseReport& report, SensorColumns& sensorColumns)
+  {
+      sensorColumns.clear();
+      return parseTrackLeniently(gpxData, report, &sensorColumns);
+  }
+
+  std::vector<GPS::TrackPoint> parseTrack(std::istream& gpxData, SensorColumns& sensorColumns)
+  {
+      sensorColumns.clear();
+      return parseTrackWith(gpxData, &sensorColumns);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  std::vector<GPS::TrackPoint> parseTrack(std::istream& gpxData, IO::ProgressMonitor& monitor)
+  {
+      IO::MonitoredStream monitoredData {gpxData, monitor};
+      std::vector<GPS::TrackPoint> trackPoints = parseTrack(monitoredData);
+      monitor.addPoints(trackPoints.size());
+      monitor.check();
+      return trackPoints;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  std::size_t PointRange::size() const
+  {
+      return end - begin;
+  }
+
+  PointRange Document::Track::points() const
+  {
+      if (segments.empty()) return {};
+      return {segments.front().begin, segments.back().end};
+  }
+
+  std::vector<GPS::RoutePoint> Document::routePoints(std::size_t routeIndex) const
+  {
+      const PointRange range = routes.at(routeIndex).points;
+      return std::vector<GPS::RoutePoint>(points.begin() + range.begin, points.begin() + range.end);
+  }
+
+  std::vector<GPS::TrackPoint> Document::trackPoints(std::size_t trackIndex) const
+  {
+      const PointRange range = tracks.at(trackIndex).points();
+      std::vector<GPS::TrackPoint> trackPoints;
+      trackPoints.reserve(range.size());
+      for (std::size_t i = range.begin; i < range.end; ++i)
+      {
+          trackPoints.push_back({points[i].position, points[i].name, times[i]});
+      }
+      return trackPoints;
+  }
+
+  void appendPointToDocument(const XML::Element& ptElement, bool timeRequired, Document& document)
+  {
+      document.points.push_back(extractRoutePointFromRtept(ptElement));
+
+      const bool hasTime = timeRequired || ptElement.containsSubElement("time");
+      document.times.push_back(hasTime ? extractTimeFromPt(ptElement) : std::tm{});
+      document.hasTime.push_back(hasTime);
+  }
+
+  // Append all the sub-elements with the given name, returning the range they occupy.
+  PointRange appendPointsToDocument(const XML::Element& element, const std::string& ptName, bool timeRequired,
+                                    Document& document)
+  {
+      PointRange range {document.points.size(), document.points.size()};
+
+      const XML::SubElements& subElements = element.getAllSubElements();
+      const auto pts = subElements.find(ptName);
+      if (pts != subElements.end())
+      {
+          for (const XML::Element& ptElement : pts->second)
+          {
+              appendPointToDocument(ptElement, timeRequired, document);
+          }
+      }
+
+      range.end = document.points.size();
+      return range;
+  }
+
+  Document parseDocument(std::istream& gpxData)
+  {
+      XML::Parser parser {gpxData};
+
+      XML::Element gpx = parser.parseRootElement();
+      requireElementIs(gpx,"gpx");
+
+      const XML::SubElements& subElements = gpx.getAllSubElements();
+      Document document;
+
+      document.waypoints = appendPointsToDocument(gpx, "wpt", false, document);
+
+      if (gpx.containsSubElement("rte"))
+      {
+          for (const XML::Element& rte : subElements.at("rte"))
+          {
+              document.routes.push_back({extractNameFromOptionalSubElementOf(rte), appendPointsToDocument(rte, "rtept", false, document)});
+          }
+      }
+
+      if (gpx.containsSubElement("trk"))
+      {
+          for (const XML::Element& trk : subElements.at("trk"))
+          {
+              Document::Track track {extractNameFromOptionalSubElementOf(trk), {}};
+
+              // As for parseTrack(), a 'trk' without 'trkseg's is read as a single segment.
+              if (trk.containsSubElement("trkseg"))
+              {
+                  for (const XML::Element& trkseg : trk.getAllSubElements().at("trkseg"))
+                  {
+                      track.segments.push_back(appendPointsToDocument(trkseg, "trkpt", true, document));
+                  }
+              }
+              else
+              {
+                  track.segments.push_back(appendPointsToDocument(trk, "trkpt", true, document));
+              }
+
+              document.tracks.push_back(std::move(track));
+          }
+      }
+
+      return document;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  /* Finds the next opening tag with the given name (i.e. followed by whitespace, '>' or '/'), so
+   * that e.g. "<trk" does not match "<trkseg".  Returns npos if there is none in the data so far.
+   */
+  std::size_t findGPXTag(std::string_view data, std::string_view tagStart, std::size_t from)
+  {
+      for (std::size_t pos = data.find(tagStart, from); pos != std::string_view::npos; pos = data.find(tagStart, pos + 1))
+      {
+          const std::size_t next = pos + tagStart.size();
+          if (next == data.size()) return std::string_view::npos;  // Cannot tell yet.
+          const char c = data[next];
+          if (std::isspace(static_cast<unsigned char>(c)) || c == '>' || c == '/') return pos;
+      }
+      return std::string_view::npos;
+  }
+
+  // Enough data to hold the start of any tag searched for, so that a tag split between reads is still found.
+  constexpr std::size_t longestGPXTag = 8; // "</trkpt>"
+
+  TrackPointGenerator::TrackPointGenerator(int fd)
+    : fd{fd}
+  {
+      originalFlags = ::fcntl(fd, F_GETFL);
+      if (originalFlags < 0 || ::fcntl(fd, F_SETFL, originalFlags | O_NONBLOCK) < 0)
+      {
+          throw std::invalid_argument("Cannot read from file descriptor " + std::to_string(fd) + ".");
+      }
+  }
+
+  TrackPointGenerator::~TrackPointGenerator()
+  {
+      ::fcntl(fd, F_SETFL, originalFlags);
+  }
+
+  std::optional<GPS::TrackPoint> TrackPointGenerator::next()
+  {
+      while (true)
+      {
+          if (std::optional<GPS::TrackPoint> point = extractPoint())
+          {
+              ++pointsYielded;
+              return point;
+          }
+          if (section == Section::afterTrack) return {};
+          if (endOfInput)
+          {
+              checkComplete();
+              return {};
+          }
+          if (! readAvailable()) return {};
+      }
+  }
+
+  bool TrackPointGenerator::ended() const
+  {
+      return section == Section::afterTrack || endOfInput;
+  }
+
+  // Returns false if no data is available yet.
+  bool TrackPointGenerator::readAvailable()
+  {
+      buffer.erase(0, scanned);
+      scanned = 0;
+
+      constexpr std::size_t readSize = 64 * 1024;
+      const std::size_t oldSize = buffer.size();
+      while (true)
+      {
+          buffer.resize(oldSize + readSize);
+          const ssize_t bytesRead = ::read(fd, &buffer[oldSize], readSize);
+          buffer.resize(oldSize + std::max(bytesRead, ssize_t(0)));
+
+          if (bytesRead > 0) return true;
+          if (bytesRead == 0)
+          {
+              endOfInput = true;
+              return true;
+          }
+          if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+          if (errno != EINTR) throw std::runtime_error(std::string("Error reading GPX data: ") + std::strerror(errno));
+      }
+  }
+
+  std::optional<GPS::TrackPoint> TrackPointGenerator::extractPoint()
+  {
+      const std::string_view data = buffer;
+      const std::size_t unscannedTail = data.size() > longestGPXTag ? data.size() - longestGPXTag : 0;
+
+      if (section == Section::beforeTrack)
+      {
+          const std::size_t trk = findGPXTag(data, "<trk", scanned);
+          if (trk == std::string_view::npos)
+          {
+              scanned = std::max(scanned, unscannedTail);
+              return {};
+          }
+          section = Section::inTrack;
+          scanned = trk + 4;
+      }
+      if (section != Section::inTrack) return {};
+
+      // The end of the track, if it comes before the next point.
+      const std::size_t trkpt = findGPXTag(data, "<trkpt", scanned);
+      const std::size_t searchLength = trkpt == std::string_view::npos ? std::string_view::npos : trkpt - scanned;
+      if (data.substr(scanned, searchLength).find("</trk>") != std::string_view::npos)
+      {
+          section = Section::afterTrack;
+          if (pointsYielded == 0) throw std::domain_error("Missing 'trkpt' element.");
+          return {};
+      }
+      if (trkpt == std::string_view::npos)
+      {
+          scanned = std::max(scanned, unscannedTail);
+          return {};
+      }
+
+      // Wait until the whole element has arrived.
+      scanned = trkpt;
+      const std::size_t tagEnd = data.find('>', trkpt);
+      if (tagEnd == std::string_view::npos) return {};
+      std::size_t elementEnd = tagEnd + 1;
+      if (data[tagEnd - 1] != '/')
+      {
+          const std::size_t closingTag = data.find("</trkpt>", tagEnd);
+          if (closingTag == std::string_view::npos) return {};
+          elementEnd = closingTag + longestGPXTag;
+      }
+
+      std::istringstream trkptData {std::string(data.substr(trkpt, elementEnd - trkpt))};
+      XML::Parser parser {trkptData};
+      const GPS::TrackPoint point = extractTrackPointFromTrkpt(parser.parseRootElement());
+      scanned = elementEnd;
+      return point;
+  }
+
+  void TrackPointGenerator::checkComplete() const
+  {
+      if (section == Section::beforeTrack) throw std::domain_error("Missing 'trk' element.");
+      if (section == Section::inTrack) throw std::domain_error("Incomplete 'trk' element.");
   }
 }
@@ -4,6 +4,7 @@
 #include "xml-element.h"
 #include "xml-generator.h"
 #include "gridworld-model.h"
+#include "nmea-emitter.h"
 
 #include "gridworld-route.h"
 
@@ -59,8 +60,14 @@ std::string Route::toGPX() const
 
 std::string Route::toNMEA() const
 {
-    // Stub definition
-    return "";
+    NMEA::SentenceEmitter nmea;
+
+    for (const RoutePoint& routePoint : routePoints)
+    {
+        nmea.gga(routePoint.position);
+    }
+
+    return std::string(nmea.contents());
 }
 
 std::string Route::toString() const
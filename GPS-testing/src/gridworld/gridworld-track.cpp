@@ -10,6 +10,7 @@
 #include "xml-generator.h"
 #include "gridworld-model.h"
 #include "gridworld-route.h"
+#include "nmea-emitter.h"
 
 #include "gridworld-track.h"
 
@@ -76,6 +77,19 @@ std::string Track::toGPX() const
     return gpx.closeAllElementsAndExtractString();
 }
 
+std::string Track::toNMEA() const
+{
+    NMEA::SentenceEmitter nmea;
+
+    for (const TrackPoint& trackPoint : trackPoints)
+    {
+        nmea.gga(trackPoint.position, trackPoint.dateTime);
+        nmea.rmc(trackPoint.position, trackPoint.dateTime);
+    }
+
+    return std::string(nmea.contents());
+}
+
 std::string Track::toString() const
 {
     return trackString;
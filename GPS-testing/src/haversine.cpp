@@ -0,0 +1,303 @@
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GPS_HAVERSINE_X86
+#endif
+
+#include "geometry.h"
+#include "earth.h"
+#include "haversine.h"
+
+namespace GPS
+{
+  metres haversineDistance(degrees lat1Degs, degrees lon1Degs, degrees lat2Degs, degrees lon2Degs)
+  /*
+   * See: https://en.wikipedia.org/wiki/Haversine_formula
+   */
+  {
+      const radians lat1 = degToRad(lat1Degs);
+      const radians lat2 = degToRad(lat2Degs);
+      const radians lon1 = degToRad(lon1Degs);
+      const radians lon2 = degToRad(lon2Degs);
+
+      double h = sinSqr((lat2-lat1)/2) + std::cos(lat1)*std::cos(lat2)*sinSqr((lon2-lon1)/2);
+      return 2 * Earth::meanRadius * std::asin(std::sqrt(h));
+  }
+
+  metres haversineDistance(const GeodeticPoint& p1, const GeodeticPoint& p2)
+  {
+      double h = sinSqr((p2.latitude()-p1.latitude())/2) + p1.cosLatitude()*p2.cosLatitude()*sinSqr((p2.longitude()-p1.longitude())/2);
+      return 2 * Earth::meanRadius * std::asin(std::sqrt(h));
+  }
+
+  bool isSupported(DistanceKernel kernel)
+  {
+      switch (kernel)
+      {
+          case DistanceKernel::scalar: return true;
+#ifdef GPS_HAVERSINE_X86
+          case DistanceKernel::avx2:   return __builtin_cpu_supports("avx2");
+#endif
+          default:                     return false;
+      }
+  }
+
+  DistanceKernel bestDistanceKernel()
+  {
+      static const DistanceKernel best = isSupported(DistanceKernel::avx2) ? DistanceKernel::avx2 : DistanceKernel::scalar;
+      return best;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef GPS_HAVERSINE_X86
+  /* Sine, cosine and arcsine, 4 lanes at a time.  The polynomials and the reduction of the
+   * arguments are those of fdlibm (from which most C libraries' versions derive), each accurate
+   * to within 1 ulp; every branch is evaluated, and the results are blended per lane.
+   * The operations are performed in the same order as haversineDistance(), without fused
+   * multiply-adds, so that only the transcendental functions contribute differences.
+   */
+
+  // pi/2 in three parts: the first two have 33 significant bits, so their products with small integers are exact.
+  const double halfPiPart1 = 1.57079632673412561417e+00;
+  const double halfPiPart2 = 6.07710050630396597660e-11;
+  const double halfPiPart3 = 2.02226624879595063154e-21;
+  const double twoOverPi   = 6.36619772367581382433e-01;
+
+  __attribute__((target("avx2")))
+  __m256d polynomial(__m256d x, const double* coefficients, int degree)
+  {
+      // Horner's rule, with the coefficients in increasing order of power.
+      __m256d result = _mm256_set1_pd(coefficients[degree]);
+      for (int i = degree - 1; i >= 0; --i)
+      {
+          result = _mm256_add_pd(_mm256_set1_pd(coefficients[i]), _mm256_mul_pd(x, result));
+      }
+      return result;
+  }
+
+  // sin(r) for |r| <= pi/4.
+  __attribute__((target("avx2")))
+  __m256d sinKernel(__m256d r)
+  {
+      static const double s[] = { 8.33333333332248946124e-03, -1.98412698298579493134e-04, 2.75573137070700676789e-06,
+                                 -2.50507602534068634195e-08,  1.58969099521155010221e-10 };
+      const __m256d z = _mm256_mul_pd(r, r);
+      const __m256d v = _mm256_mul_pd(z, r);
+      const __m256d inner = _mm256_add_pd(_mm256_set1_pd(-1.66666666666666324348e-01), _mm256_mul_pd(z, polynomial(z, s, 4)));
+      return _mm256_add_pd(r, _mm256_mul_pd(v, inner));
+  }
+
+  // cos(r) for |r| <= pi/4.
+  __attribute__((target("avx2")))
+  __m256d cosKernel(__m256d r)
+  {
+      static const double c[] = { 4.16666666666666019037e-02, -1.38888888888741095749e-03, 2.48015872894767294178e-05,
+                                 -2.75573143513906633035e-07,  2.08757232129817482790e-09, -1.13596475577881948265e-11 };
+      const __m256d absR = _mm256_andnot_pd(_mm256_set1_pd(-0.0), r);
+      const __m256d z = _mm256_mul_pd(r, r);
+      const __m256d zr = _mm256_mul_pd(z, _mm256_mul_pd(z, polynomial(z, c, 5)));
+
+      /* For |r| >= 0.3, a quarter of |r| (truncated to its high 32 bits), or 0.28125 beyond 0.78125,
+       * is subtracted from both 1 and z/2, to preserve accuracy; below 0.3 nothing is.
+       */
+      const __m256d highBits = _mm256_castsi256_pd(_mm256_set1_epi64x(std::int64_t(0xFFFFFFFF00000000ull)));
+      __m256d quarter = _mm256_and_pd(_mm256_mul_pd(absR, _mm256_set1_pd(0.25)), highBits);
+      quarter = _mm256_blendv_pd(quarter, _mm256_set1_pd(0.28125), _mm256_cmp_pd(absR, _mm256_set1_pd(0.78125), _CMP_GT_OQ));
+      quarter = _mm256_and_pd(quarter, _mm256_cmp_pd(absR, _mm256_set1_pd(0.3), _CMP_GE_OQ));
+
+      const __m256d hz = _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(0.5), z), quarter);
+      const __m256d a = _mm256_sub_pd(_mm256_set1_pd(1.0), quarter);
+      return _mm256_sub_pd(a, _mm256_sub_pd(hz, zr));
+  }
+
+  /* Reduces x to r = x - k*pi/2 with |r| <= pi/4, for |x| up to a few multiples of pi, returning
+   * masks of the lanes in which k is odd (so that sine and cosine swap) and in which (k+1) mod 4
+   * is 2 or 3 (so that the cosine changes sign).
+   */
+  __attribute__((target("avx2")))
+  __m256d reduceQuarterTurns(__m256d x, __m256d& oddQuadrant, __m256d& negativeCosine)
+  {
+      const __m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(twoOverPi)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(halfPiPart1)));
+      r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(halfPiPart2)));
+      r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(halfPiPart3)));
+
+      const __m256i quadrant = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(k));
+      const __m256i one = _mm256_set1_epi64x(1);
+      const __m256i two = _mm256_set1_epi64x(2);
+      oddQuadrant = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(quadrant, one), one));
+      negativeCosine = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(_mm256_add_epi64(quadrant, one), two), two));
+      return r;
+  }
+
+  __attribute__((target("avx2")))
+  __m256d sinSqrAVX2(__m256d x)
+  {
+      __m256d oddQuadrant, negativeCosine;
+      const __m256d r = reduceQuarterTurns(x, oddQuadrant, negativeCosine);
+      const __m256d s = _mm256_blendv_pd(sinKernel(r), cosKernel(r), oddQuadrant);
+      return _mm256_mul_pd(s, s);
+  }
+
+  __attribute__((target("avx2")))
+  __m256d cosAVX2(__m256d x)
+  {
+      __m256d oddQuadrant, negativeCosine;
+      const __m256d r = reduceQuarterTurns(x, oddQuadrant, negativeCosine);
+      const __m256d c = _mm256_blendv_pd(cosKernel(r), sinKernel(r), oddQuadrant);
+      return _mm256_xor_pd(c, _mm256_and_pd(negativeCosine, _mm256_set1_pd(-0.0)));
+  }
+
+  // asin(x) for 0 <= x <= 1.
+  __attribute__((target("avx2")))
+  __m256d asinAVX2(__m256d x)
+  {
+      static const double p[] = { 1.66666666666666657415e-01, -3.25565818622400915405e-01, 2.01212532134862925881e-01,
+                                 -4.00555345006794114027e-02,  7.91534994289814532176e-04, 3.47933107596021167570e-05 };
+      static const double q[] = { 1.0, -2.40339491173441421878e+00, 2.02094576023350569471e+00,
+                                 -6.88283971605453293030e-01,  7.70381505559019352791e-02 };
+      const __m256d halfPiHigh    = _mm256_set1_pd(1.57079632679489655800e+00);
+      const __m256d halfPiLow     = _mm256_set1_pd(6.12323399573676603587e-17);
+      const __m256d quarterPiHigh = _mm256_set1_pd(7.85398163397448278999e-01);
+      const __m256d half = _mm256_set1_pd(0.5);
+      const __m256d two = _mm256_set1_pd(2.0);
+
+      // Below 0.5, asin(x) = x + x*R(x^2); above it, asin(x) = pi/2 - 2*asin(sqrt((1-x)/2)).
+      const __m256d small = _mm256_cmp_pd(x, half, _CMP_LT_OQ);
+      const __m256d t = _mm256_blendv_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), x), half), _mm256_mul_pd(x, x), small);
+      const __m256d ratio = _mm256_div_pd(_mm256_mul_pd(t, polynomial(t, p, 5)), polynomial(t, q, 4));
+
+      const __m256d smallResult = _mm256_add_pd(x, _mm256_mul_pd(x, ratio));
+
+      // Above 0.975, directly; between 0.5 and 0.975, with sqrt(t) split to preserve accuracy.
+      const __m256d s = _mm256_sqrt_pd(t);
+      const __m256d nearOneResult = _mm256_sub_pd(halfPiHigh,
+          _mm256_sub_pd(_mm256_mul_pd(two, _mm256_add_pd(s, _mm256_mul_pd(s, ratio))), halfPiLow));
+
+      const __m256d highBits = _mm256_castsi256_pd(_mm256_set1_epi64x(std::int64_t(0xFFFFFFFF00000000ull)));
+      const __m256d w = _mm256_and_pd(s, highBits);
+      const __m256d c = _mm256_div_pd(_mm256_sub_pd(t, _mm256_mul_pd(w, w)), _mm256_add_pd(s, w));
+      const __m256d pp = _mm256_sub_pd(_mm256_mul_pd(_mm256_mul_pd(two, s), ratio), _mm256_sub_pd(halfPiLow, _mm256_mul_pd(two, c)));
+      const __m256d qq = _mm256_sub_pd(quarterPiHigh, _mm256_mul_pd(two, w));
+      const __m256d middleResult = _mm256_sub_pd(quarterPiHigh, _mm256_sub_pd(pp, qq));
+
+      const __m256d nearOne = _mm256_cmp_pd(x, _mm256_set1_pd(0.975), _CMP_GE_OQ);
+      return _mm256_blendv_pd(_mm256_blendv_pd(middleResult, nearOneResult, nearOne), smallResult, small);
+  }
+
+  __attribute__((target("avx2")))
+  __m256d haversineAVX2(__m256d lat1Degs, __m256d lon1Degs, __m256d lat2Degs, __m256d lon2Degs)
+  {
+      const __m256d pi = _mm256_set1_pd(GPS::pi);
+      const __m256d halfTurn = _mm256_set1_pd(halfRotation);
+      const __m256d two = _mm256_set1_pd(2.0);
+
+      // As degToRad().
+      const __m256d lat1 = _mm256_div_pd(_mm256_mul_pd(lat1Degs, pi), halfTurn);
+      const __m256d lat2 = _mm256_div_pd(_mm256_mul_pd(lat2Degs, pi), halfTurn);
+      const __m256d lon1 = _mm256_div_pd(_mm256_mul_pd(lon1Degs, pi), halfTurn);
+      const __m256d lon2 = _mm256_div_pd(_mm256_mul_pd(lon2Degs, pi), halfTurn);
+
+      const __m256d latTerm = sinSqrAVX2(_mm256_div_pd(_mm256_sub_pd(lat2, lat1), two));
+      const __m256d lonTerm = sinSqrAVX2(_mm256_div_pd(_mm256_sub_pd(lon2, lon1), two));
+      const __m256d h = _mm256_add_pd(latTerm, _mm256_mul_pd(_mm256_mul_pd(cosAVX2(lat1), cosAVX2(lat2)), lonTerm));
+
+      return _mm256_mul_pd(_mm256_set1_pd(2 * Earth::meanRadius), asinAVX2(_mm256_sqrt_pd(h)));
+  }
+
+  __attribute__((target("avx2")))
+  void consecutiveDistancesAVX2(const degrees* lats, const degrees* lons, std::size_t numDistances, metres* distances)
+  {
+      std::size_t i = 0;
+      for (; i + 4 <= numDistances; i += 4)
+      {
+          const __m256d result = haversineAVX2(_mm256_loadu_pd(lats + i), _mm256_loadu_pd(lons + i),
+                                               _mm256_loadu_pd(lats + i + 1), _mm256_loadu_pd(lons + i + 1));
+          _mm256_storeu_pd(distances + i, result);
+      }
+      for (; i < numDistances; ++i) distances[i] = haversineDistance(lats[i], lons[i], lats[i+1], lons[i+1]);
+  }
+
+  __attribute__((target("avx2")))
+  void distancesToAVX2(const degrees* lats, const degrees* lons, std::size_t count, degrees targetLat, degrees targetLon, metres* distances)
+  {
+      const __m256d targetLats = _mm256_set1_pd(targetLat);
+      const __m256d targetLons = _mm256_set1_pd(targetLon);
+
+      std::size_t i = 0;
+      for (; i + 4 <= count; i += 4)
+      {
+          const __m256d result = haversineAVX2(_mm256_loadu_pd(lats + i), _mm256_loadu_pd(lons + i), targetLats, targetLons);
+          _mm256_storeu_pd(distances + i, result);
+      }
+      for (; i < count; ++i) distances[i] = haversineDistance(lats[i], lons[i], targetLat, targetLon);
+  }
+#endif
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  void checkCoordinateArrays(const std::vector<degrees>& lats, const std::vector<degrees>& lons, DistanceKernel kernel)
+  {
+      if (lats.size() != lons.size()) throw std::invalid_argument("There must be a longitude for each latitude.");
+      if (! isSupported(kernel)) throw std::invalid_argument("Distance kernel not supported on this processor.");
+  }
+
+  void consecutiveDistances(const std::vector<degrees>& lats, const std::vector<degrees>& lons,
+                            std::vector<metres>& distances, DistanceKernel kernel)
+  {
+      checkCoordinateArrays(lats, lons, kernel);
+      distances.resize(lats.empty() ? 0 : lats.size() - 1);
+
+#ifdef GPS_HAVERSINE_X86
+      if (kernel == DistanceKernel::avx2)
+      {
+          consecutiveDistancesAVX2(lats.data(), lons.data(), distances.size(), distances.data());
+          return;
+      }
+#endif
+      if (distances.empty()) return;
+
+      // Each point ends one segment and starts the next, so is converted only once.
+      GeodeticPoint current = GeodeticPoint::fromDegrees(lats[0], lons[0]);
+      for (std::size_t i = 0; i < distances.size(); ++i)
+      {
+          const GeodeticPoint next = GeodeticPoint::fromDegrees(lats[i+1], lons[i+1]);
+          distances[i] = haversineDistance(current, next);
+          current = next;
+      }
+  }
+
+  void distancesTo(const std::vector<degrees>& lats, const std::vector<degrees>& lons,
+                   degrees targetLat, degrees targetLon, std::vector<metres>& distances, DistanceKernel kernel)
+  {
+      checkCoordinateArrays(lats, lons, kernel);
+      distances.resize(lats.size());
+
+#ifdef GPS_HAVERSINE_X86
+      if (kernel == DistanceKernel::avx2)
+      {
+          distancesToAVX2(lats.data(), lons.data(), lats.size(), targetLat, targetLon, distances.data());
+          return;
+      }
+#endif
+      const GeodeticPoint target = GeodeticPoint::fromDegrees(targetLat, targetLon);
+      for (std::size_t i = 0; i < distances.size(); ++i)
+      {
+          distances[i] = haversineDistance(GeodeticPoint::fromDegrees(lats[i], lons[i]), target);
+      }
+  }
+
+  void consecutiveDistances(const std::vector<degrees>& lats, const std::vector<degrees>& lons, std::vector<metres>& distances)
+  {
+      consecutiveDistances(lats, lons, distances, bestDistanceKernel());
+  }
+
+  void distancesTo(const std::vector<degrees>& lats, const std::vector<degrees>& lons,
+                   degrees targetLat, degrees targetLon, std::vector<metres>& distances)
+  {
+      distancesTo(lats, lons, targetLat, targetLon, distances, bestDistanceKernel());
+  }
+}
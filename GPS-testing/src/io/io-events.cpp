@@ -0,0 +1,82 @@
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "io-events.h"
+
+namespace GPS::IO
+{
+  void EventLoop::watch(int fd, Handler handler)
+  {
+      newDescriptors.push_back({fd, POLLIN, 0});
+      newHandlers.push_back(std::move(handler));
+  }
+
+  void EventLoop::run(std::chrono::milliseconds stopLatency)
+  {
+      while (! stopping)
+      {
+          descriptors.insert(descriptors.end(), newDescriptors.begin(), newDescriptors.end());
+          for (Handler& handler : newHandlers) handlers.push_back(std::move(handler));
+          newDescriptors.clear();
+          newHandlers.clear();
+
+          if (descriptors.empty()) return;
+
+          if (::poll(descriptors.data(), descriptors.size(), stopLatency.count()) < 0)
+          {
+              if (errno == EINTR) continue;
+              throw std::runtime_error(std::string("Error waiting for input: ") + std::strerror(errno));
+          }
+
+          // Handlers that have finished are removed by moving the later ones down.
+          std::size_t kept = 0;
+          for (std::size_t i = 0; i < descriptors.size(); ++i)
+          {
+              bool keep = true;
+              if (descriptors[i].revents != 0)
+              {
+                  try
+                  {
+                      keep = handlers[i]();
+                  }
+                  catch (...)
+                  {
+                      // Drop this handler, keeping those not yet called.
+                      for (std::size_t later = i + 1; later < descriptors.size(); ++later, ++kept)
+                      {
+                          descriptors[kept] = descriptors[later];
+                          handlers[kept] = std::move(handlers[later]);
+                      }
+                      descriptors.resize(kept);
+                      handlers.resize(kept);
+                      throw;
+                  }
+              }
+
+              if (keep)
+              {
+                  if (kept != i)
+                  {
+                      descriptors[kept] = descriptors[i];
+                      handlers[kept] = std::move(handlers[i]);
+                  }
+                  ++kept;
+              }
+          }
+          descriptors.resize(kept);
+          handlers.resize(kept);
+      }
+  }
+
+  void EventLoop::stop()
+  {
+      stopping = true;
+  }
+
+  std::size_t EventLoop::size() const
+  {
+      return descriptors.size() + newDescriptors.size();
+  }
+}
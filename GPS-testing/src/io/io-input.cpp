@@ -0,0 +1,209 @@
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+#include <zlib.h>
+
+#include "io-input.h"
+
+namespace GPS::IO
+{
+  const int gzipMagic1 = 0x1f;
+  const int gzipMagic2 = 0x8b;
+
+  bool isGzip(std::istream& source)
+  {
+      if (source.peek() != gzipMagic1) return false;
+      source.get();
+      const bool magicMatches = source.peek() == gzipMagic2;
+      source.unget();
+      return magicMatches;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  DecompressingStreambuf::DecompressingStreambuf(std::istream& compressedSource, std::size_t bufferSize)
+    : source{compressedSource}
+  {
+      if (bufferSize == 0) throw std::invalid_argument("Decompression buffers must not be empty.");
+
+      buffers[0].data.resize(putbackSize + bufferSize);
+      buffers[1].data.resize(putbackSize + bufferSize);
+
+      decompressor = std::thread(&DecompressingStreambuf::decompress, this);
+  }
+
+  DecompressingStreambuf::~DecompressingStreambuf()
+  {
+      {
+          std::lock_guard<std::mutex> lock {mutex};
+          stopping = true;
+      }
+      bufferStateChanged.notify_all();
+      decompressor.join();
+  }
+
+  DecompressingStreambuf::int_type DecompressingStreambuf::underflow()
+  {
+      if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+      std::unique_lock<std::mutex> lock {mutex};
+
+      // The tail of the exhausted buffer is carried over, so that it can still be put back.
+      char putback[putbackSize];
+      std::size_t putbackCount = 0;
+
+      if (current >= 0)
+      {
+          if (buffers[current].size == 0) return traits_type::eof(); // The end-of-data marker is never released.
+
+          putbackCount = std::min<std::size_t>(putbackSize, egptr() - eback());
+          std::memcpy(putback, egptr() - putbackCount, putbackCount);
+
+          // Hand the exhausted buffer back to the decompressor, and move on to the other one.
+          buffers[current].ready = false;
+          bufferStateChanged.notify_all();
+          current ^= 1;
+      }
+      else
+      {
+          current = 0;
+      }
+
+      bufferStateChanged.wait(lock, [this] {return buffers[current].ready || ! error.empty();});
+
+      if (! buffers[current].ready) throw std::domain_error(error);
+
+      Buffer& buffer = buffers[current];
+      if (buffer.size == 0) return traits_type::eof();
+
+      char* const start = buffer.data.data() + putbackSize;
+      std::memcpy(start - putbackCount, putback, putbackCount);
+      setg(start - putbackCount, start, start + buffer.size);
+      return traits_type::to_int_type(*gptr());
+  }
+
+  void DecompressingStreambuf::decompress()
+  {
+      z_stream zs {};
+      if (inflateInit2(&zs, 15 + 16) != Z_OK) // 15 window bits, plus 16 to expect a gzip header.
+      {
+          std::lock_guard<std::mutex> lock {mutex};
+          error = "Could not initialise gzip decompression.";
+          bufferStateChanged.notify_all();
+          return;
+      }
+
+      std::vector<unsigned char> input(64 * 1024);
+      bool endOfData = false;
+      std::string failure;
+
+      for (int fill = 0; ; fill ^= 1)
+      {
+          {
+              std::unique_lock<std::mutex> lock {mutex};
+              bufferStateChanged.wait(lock, [this,fill] {return ! buffers[fill].ready || stopping;});
+              if (stopping) break;
+          }
+
+          // The reader never touches a buffer that is not ready, so it can be filled without the lock.
+          Buffer& buffer = buffers[fill];
+          zs.next_out = reinterpret_cast<unsigned char*>(buffer.data.data() + putbackSize);
+          zs.avail_out = static_cast<uInt>(buffer.data.size() - putbackSize);
+
+          while (zs.avail_out > 0 && ! endOfData)
+          {
+              if (zs.avail_in == 0)
+              {
+                  source.read(reinterpret_cast<char*>(input.data()), input.size());
+                  zs.next_in = input.data();
+                  zs.avail_in = static_cast<uInt>(source.gcount());
+                  if (zs.avail_in == 0)
+                  {
+                      failure = "Truncated gzip data.";
+                      break;
+                  }
+              }
+
+              const int status = inflate(&zs, Z_NO_FLUSH);
+
+              if (status == Z_STREAM_END)
+              {
+                  // Another gzip member may follow; anything else after a member is ignored.
+                  // The next member's header may straddle the chunk, so keep any leftover byte and read on.
+                  if (zs.avail_in < 2 && source.peek() != std::char_traits<char>::eof())
+                  {
+                      std::memmove(input.data(), zs.next_in, zs.avail_in);
+                      source.read(reinterpret_cast<char*>(input.data() + zs.avail_in), input.size() - zs.avail_in);
+                      zs.next_in = input.data();
+                      zs.avail_in += static_cast<uInt>(source.gcount());
+                  }
+
+                  if (zs.avail_in >= 2 && zs.next_in[0] == gzipMagic1 && zs.next_in[1] == gzipMagic2)
+                  {
+                      inflateReset(&zs);
+                  }
+                  else
+                  {
+                      endOfData = true;
+                  }
+              }
+              else if (status != Z_OK && status != Z_BUF_ERROR)
+              {
+                  failure = std::string("Malformed gzip data: ") + (zs.msg ? zs.msg : "unknown error.");
+                  break;
+              }
+          }
+
+          std::lock_guard<std::mutex> lock {mutex};
+          if (! failure.empty())
+          {
+              error = failure;
+              bufferStateChanged.notify_all();
+              break;
+          }
+
+          buffer.size = buffer.data.size() - putbackSize - zs.avail_out;
+          buffer.ready = true;
+          bufferStateChanged.notify_all();
+
+          if (endOfData && buffer.size == 0) break; // An empty buffer marks the end of the data.
+      }
+
+      inflateEnd(&zs);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  InputStream::InputStream(const std::string& filepath)
+    : std::istream(nullptr),
+      file{std::make_unique<std::ifstream>(filepath, std::ios::binary)}
+  {
+      if (! file->is_open()) throw std::invalid_argument("Could not open input file: " + filepath);
+      attach(*file);
+  }
+
+  InputStream::InputStream(std::istream& source)
+    : std::istream(nullptr)
+  {
+      attach(source);
+  }
+
+  void InputStream::attach(std::istream& source)
+  {
+      if (isGzip(source))
+      {
+          decompressor = std::make_unique<DecompressingStreambuf>(source);
+          rdbuf(decompressor.get());
+      }
+      else
+      {
+          rdbuf(source.rdbuf());
+      }
+  }
+
+  bool InputStream::isCompressed() const
+  {
+      return decompressor != nullptr;
+  }
+}
@@ -0,0 +1,72 @@
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "io-mapped.h"
+
+namespace GPS::IO
+{
+  MappedFile::MappedFile(const std::string& filepath)
+  {
+      const int fd = ::open(filepath.c_str(), O_RDONLY);
+      if (fd < 0) throw std::invalid_argument("Could not open input file: " + filepath);
+
+      struct stat status;
+      if (::fstat(fd, &status) != 0 || ! S_ISREG(status.st_mode))
+      {
+          ::close(fd);
+          throw std::invalid_argument("Not a regular file: " + filepath);
+      }
+
+      size = static_cast<std::size_t>(status.st_size);
+      if (size > 0) // Empty mappings are not allowed.
+      {
+          void* const mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (mapping == MAP_FAILED)
+          {
+              ::close(fd);
+              throw std::invalid_argument("Could not map input file: " + filepath);
+          }
+          ::madvise(mapping, size, MADV_SEQUENTIAL);
+          data = static_cast<const char*>(mapping);
+      }
+      ::close(fd); // The mapping remains valid after the file is closed.
+  }
+
+  MappedFile::~MappedFile()
+  {
+      if (data) ::munmap(const_cast<char*>(data), size);
+  }
+
+  std::string_view MappedFile::contents() const
+  {
+      return {data, size};
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  std::vector<std::string_view> splitIntoLineChunks(std::string_view text, std::size_t maxChunks)
+  {
+      std::vector<std::string_view> chunks;
+      if (maxChunks == 0) maxChunks = 1;
+      const std::size_t targetSize = (text.size() + maxChunks - 1) / maxChunks;
+
+      std::size_t start = 0;
+      while (start < text.size())
+      {
+          std::size_t end = text.size();
+          if (chunks.size() + 1 < maxChunks && start + targetSize < text.size())
+          {
+              // Extend the chunk to the end of the line that its target size falls within.
+              const std::size_t newline = text.find('\n', start + targetSize - 1);
+              if (newline != std::string_view::npos) end = newline + 1;
+          }
+          chunks.push_back(text.substr(start, end - start));
+          start = end;
+      }
+      return chunks;
+  }
+}
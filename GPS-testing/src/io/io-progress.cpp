@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstring>
+
+#include "io-progress.h"
+
+namespace GPS::IO
+{
+  Cancelled::Cancelled()
+    : std::runtime_error("Parse cancelled.")
+  {}
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  ProgressMonitor::ProgressMonitor(ProgressCallback callback, std::size_t checkInterval)
+    : callback{std::move(callback)},
+      checkInterval{checkInterval},
+      start{std::chrono::steady_clock::now()},
+      nextCheck{checkInterval}
+  {
+      if (checkInterval == 0) throw std::invalid_argument("The progress check interval must not be zero.");
+  }
+
+  void ProgressMonitor::cancel()
+  {
+      cancelled = true;
+  }
+
+  bool ProgressMonitor::isCancelled() const
+  {
+      return cancelled;
+  }
+
+  Progress ProgressMonitor::progress() const
+  {
+      return {bytesConsumed, pointsProduced, std::chrono::steady_clock::now() - start};
+  }
+
+  void ProgressMonitor::addBytes(std::size_t numBytes)
+  {
+      bytesConsumed += numBytes;
+      if (bytesConsumed >= nextCheck)
+      {
+          nextCheck = bytesConsumed + checkInterval;
+          check();
+      }
+  }
+
+  void ProgressMonitor::addPoints(std::size_t numPoints)
+  {
+      pointsProduced += numPoints;
+  }
+
+  void ProgressMonitor::check()
+  {
+      if (! cancelled && callback && ! callback(progress())) cancelled = true;
+      if (cancelled) throw Cancelled();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  MonitoredStream::Streambuf::Streambuf(std::streambuf* source, ProgressMonitor& monitor)
+    : source{source},
+      monitor{monitor},
+      buffer(putbackSize + blockSize)
+  {
+      char* const start = buffer.data() + putbackSize;
+      setg(start, start, start);
+  }
+
+  MonitoredStream::Streambuf::int_type MonitoredStream::Streambuf::underflow()
+  {
+      if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+      // Keep the tail of the previous block, so that it can still be put back.
+      const std::size_t putbackCount = std::min<std::size_t>(putbackSize, gptr() - eback());
+      char* const start = buffer.data() + putbackSize;
+      std::memmove(start - putbackCount, gptr() - putbackCount, putbackCount);
+
+      const std::streamsize numRead = source->sgetn(start, blockSize);
+      setg(start - putbackCount, start, start + std::max<std::streamsize>(numRead, 0));
+      if (numRead <= 0) return traits_type::eof();
+
+      monitor.addBytes(numRead);
+      return traits_type::to_int_type(*gptr());
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  MonitoredStream::MonitoredStream(std::istream& source, ProgressMonitor& monitor)
+    : std::istream(nullptr),
+      streambuf{source.rdbuf(), monitor}
+  {
+      rdbuf(&streambuf);
+      exceptions(std::ios::badbit); // So that Cancelled reaches the caller, instead of setting badbit.
+  }
+}
@@ -0,0 +1,217 @@
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GPS_NMEA_BATCH_X86
+#endif
+
+#include "nmea-batch.h"
+
+namespace GPS::NMEA
+{
+  bool isSupported(SimdLevel level)
+  {
+      switch (level)
+      {
+          case SimdLevel::scalar: return true;
+#ifdef GPS_NMEA_BATCH_X86
+          case SimdLevel::sse2:   return __builtin_cpu_supports("sse2");
+          case SimdLevel::avx2:   return __builtin_cpu_supports("avx2");
+#endif
+          default:                return false;
+      }
+  }
+
+  SimdLevel bestSimdLevel()
+  {
+      static const SimdLevel best = isSupported(SimdLevel::avx2) ? SimdLevel::avx2
+                                  : isSupported(SimdLevel::sse2) ? SimdLevel::sse2
+                                  : SimdLevel::scalar;
+      return best;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  /* Each line is scanned from its second character up to the first '*', '$' or '\n' (the "stop"),
+   * accumulating the XOR of the characters passed over, which is the checksum if the stop is the '*'.
+   * The functions below find the stop, at different SIMD widths.
+   */
+  using FindStop = std::size_t (*)(const char* text, std::size_t pos, std::size_t end, unsigned char& checksum);
+
+  std::size_t findStopScalar(const char* text, std::size_t pos, std::size_t end, unsigned char& checksum)
+  {
+      for (; pos < end; ++pos)
+      {
+          const char c = text[pos];
+          if (c == '*' || c == '$' || c == '\n') break;
+          checksum ^= c;
+      }
+      return pos;
+  }
+
+#ifdef GPS_NMEA_BATCH_X86
+  // Loading 16 or 32 bytes from (prefixMasks + 32 - n) gives a mask selecting the first n bytes.
+  alignas(64) const signed char prefixMasks[64] =
+  {
+      -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+       0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  };
+
+  __attribute__((target("sse2")))
+  unsigned char xorReduce(__m128i bytes)
+  {
+      bytes = _mm_xor_si128(bytes, _mm_srli_si128(bytes, 8));
+      bytes = _mm_xor_si128(bytes, _mm_srli_si128(bytes, 4));
+      bytes = _mm_xor_si128(bytes, _mm_srli_si128(bytes, 2));
+      bytes = _mm_xor_si128(bytes, _mm_srli_si128(bytes, 1));
+      return static_cast<unsigned char>(_mm_cvtsi128_si32(bytes));
+  }
+
+  __attribute__((target("sse2")))
+  std::size_t findStopSSE2(const char* text, std::size_t pos, std::size_t end, unsigned char& checksum)
+  {
+      const __m128i star = _mm_set1_epi8('*');
+      const __m128i dollar = _mm_set1_epi8('$');
+      const __m128i newline = _mm_set1_epi8('\n');
+      __m128i accumulated = _mm_setzero_si128();
+
+      for (; pos + 16 <= end; pos += 16)
+      {
+          const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + pos));
+          const __m128i stops = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, star),
+                                                          _mm_cmpeq_epi8(block, dollar)),
+                                             _mm_cmpeq_epi8(block, newline));
+          const unsigned int stopMask = _mm_movemask_epi8(stops);
+          if (stopMask != 0)
+          {
+              const unsigned int n = __builtin_ctz(stopMask);
+              const __m128i firstN = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prefixMasks + 32 - n));
+              accumulated = _mm_xor_si128(accumulated, _mm_and_si128(block, firstN));
+              checksum ^= xorReduce(accumulated);
+              return pos + n;
+          }
+          accumulated = _mm_xor_si128(accumulated, block);
+      }
+
+      checksum ^= xorReduce(accumulated);
+      return findStopScalar(text, pos, end, checksum);
+  }
+
+  __attribute__((target("avx2")))
+  std::size_t findStopAVX2(const char* text, std::size_t pos, std::size_t end, unsigned char& checksum)
+  {
+      const __m256i star = _mm256_set1_epi8('*');
+      const __m256i dollar = _mm256_set1_epi8('$');
+      const __m256i newline = _mm256_set1_epi8('\n');
+      __m256i accumulated = _mm256_setzero_si256();
+      std::size_t stop = end;
+
+      for (; pos + 32 <= end; pos += 32)
+      {
+          const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + pos));
+          const __m256i stops = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, star),
+                                                                _mm256_cmpeq_epi8(block, dollar)),
+                                                _mm256_cmpeq_epi8(block, newline));
+          const unsigned int stopMask = _mm256_movemask_epi8(stops);
+          if (stopMask != 0)
+          {
+              const unsigned int n = __builtin_ctz(stopMask);
+              const __m256i firstN = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prefixMasks + 32 - n));
+              accumulated = _mm256_xor_si256(accumulated, _mm256_and_si256(block, firstN));
+              stop = pos + n;
+              break;
+          }
+          accumulated = _mm256_xor_si256(accumulated, block);
+      }
+
+      checksum ^= xorReduce(_mm_xor_si128(_mm256_castsi256_si128(accumulated), _mm256_extracti128_si256(accumulated, 1)));
+      return stop != end ? stop : findStopScalar(text, pos, end, checksum);
+  }
+#endif
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  bool isHexDigitChar(char c)
+  {
+      return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
+  }
+
+  unsigned int hexCharValue(char c)
+  {
+      if (c >= '0' && c <= '9') return c - '0';
+      if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+      return c - 'a' + 10;
+  }
+
+  // The checks of scanSentence(), given the position of the stop within the line and the checksum up to it.
+  ScanResult checkLine(std::string_view line, std::size_t stop, unsigned char checksum)
+  {
+      Talker talker;
+      if (line.size() < 7 || line[0] != '$' || ! findTalker(line[1], line[2], talker)) return ScanResult::invalidStructure;
+      for (std::size_t i = 3; i < 6; ++i)
+      {
+          if (line[i] < 'A' || line[i] > 'Z') return ScanResult::invalidStructure;
+      }
+      if (line[6] != ',') return ScanResult::invalidStructure;
+
+      // The stop must be the '*', followed by exactly two hexadecimal digits.
+      if (stop + 3 != line.size() || line[stop] != '*') return ScanResult::invalidStructure;
+      if (! isHexDigitChar(line[stop+1]) || ! isHexDigitChar(line[stop+2])) return ScanResult::invalidStructure;
+
+      if (checksum != 16 * hexCharValue(line[stop+1]) + hexCharValue(line[stop+2])) return ScanResult::checksumMismatch;
+
+      return ScanResult::valid;
+  }
+
+  void validateLinesWith(FindStop findStop, std::string_view text, std::vector<LineCheck>& results)
+  {
+      std::size_t lineStart = 0;
+      while (lineStart < text.size())
+      {
+          if (text[lineStart] == '\n')
+          {
+              results.push_back({lineStart, 0, ScanResult::invalidStructure});
+              ++lineStart;
+              continue;
+          }
+
+          unsigned char checksum = 0;
+          const std::size_t stop = findStop(text.data(), lineStart + 1, text.size(), checksum);
+
+          // The stop is usually the '*' near the end of the line, so the newline is close by.
+          std::size_t lineEnd = stop;
+          if (stop < text.size() && text[stop] != '\n')
+          {
+              const void* newline = std::memchr(text.data() + stop, '\n', text.size() - stop);
+              lineEnd = newline ? static_cast<const char*>(newline) - text.data() : text.size();
+          }
+          const std::size_t nextLineStart = lineEnd < text.size() ? lineEnd + 1 : lineEnd;
+          if (text[lineEnd-1] == '\r') --lineEnd;
+
+          const std::string_view line = text.substr(lineStart, lineEnd - lineStart);
+          results.push_back({lineStart, line.size(), checkLine(line, stop - lineStart, checksum)});
+
+          lineStart = nextLineStart;
+      }
+  }
+
+  void validateLines(std::string_view text, std::vector<LineCheck>& results, SimdLevel level)
+  {
+      if (! isSupported(level)) throw std::invalid_argument("The SIMD level is not supported by this processor.");
+
+      switch (level)
+      {
+#ifdef GPS_NMEA_BATCH_X86
+          case SimdLevel::avx2: validateLinesWith(findStopAVX2, text, results); break;
+          case SimdLevel::sse2: validateLinesWith(findStopSSE2, text, results); break;
+#endif
+          default:              validateLinesWith(findStopScalar, text, results); break;
+      }
+  }
+
+  void validateLines(std::string_view text, std::vector<LineCheck>& results)
+  {
+      validateLines(text, results, bestSimdLevel());
+  }
+}
@@ -0,0 +1,216 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "nmea-emitter.h"
+
+namespace GPS::NMEA
+{
+  // Writes the value as exactly 'width' decimal digits, with leading zeros.
+  char* emitDigits(char* out, std::uint64_t value, int width)
+  {
+      for (int i = width - 1; i >= 0; --i)
+      {
+          out[i] = char('0' + value % 10);
+          value /= 10;
+      }
+      return out + width;
+  }
+
+  // Writes the value with as many decimal digits as it needs.
+  char* emitUnsigned(char* out, std::uint64_t value)
+  {
+      int width = 1;
+      for (std::uint64_t remaining = value / 10; remaining > 0; remaining /= 10) ++width;
+      return emitDigits(out, value, width);
+  }
+
+  /* Writes an angle as "ddmm.mmmm" (or "dddmm.mmmm" for longitudes), followed by a comma and the
+   * bearing character.  The angle is rounded once, to whole ten-thousandths of a minute, so that
+   * rounding up to 60 minutes carries into the degrees.
+   */
+  char* emitDDM(char* out, degrees angle, int degreesWidth, char positiveBearing, char negativeBearing)
+  {
+      constexpr std::uint64_t unitsPerMinute = 10000;
+      constexpr std::uint64_t unitsPerDegree = 60 * unitsPerMinute;
+
+      const std::uint64_t units = std::llround(std::fabs(angle) * unitsPerDegree);
+      const std::uint64_t minuteUnits = units % unitsPerDegree;
+
+      out = emitDigits(out, units / unitsPerDegree, degreesWidth);
+      out = emitDigits(out, minuteUnits / unitsPerMinute, 2);
+      *out++ = '.';
+      out = emitDigits(out, minuteUnits % unitsPerMinute, 4);
+      *out++ = ',';
+      *out++ = angle < 0 ? negativeBearing : positiveBearing;
+      return out;
+  }
+
+  char* emitPosition(char* out, const Position& position)
+  {
+      out = emitDDM(out, position.latitude(), 2, 'N', 'S');
+      *out++ = ',';
+      return emitDDM(out, position.longitude(), 3, 'E', 'W');
+  }
+
+  char* emitTimeOfDay(char* out, const std::tm& time)
+  {
+      out = emitDigits(out, time.tm_hour, 2);
+      out = emitDigits(out, time.tm_min, 2);
+      out = emitDigits(out, time.tm_sec, 2);
+      *out++ = '.';
+      return emitDigits(out, 0, 3);
+  }
+
+  char* emitElevation(char* out, metres elevation)
+  {
+      constexpr metres maxElevation = 1e7;
+      if (! (std::fabs(elevation) < maxElevation))
+      {
+          throw std::domain_error("Elevation too large to be written in an NMEA sentence.");
+      }
+
+      const std::int64_t tenths = std::llround(elevation * 10);
+      if (tenths < 0) *out++ = '-';
+      const std::uint64_t magnitude = std::abs(tenths);
+      out = emitUnsigned(out, magnitude / 10);
+      *out++ = '.';
+      return emitDigits(out, magnitude % 10, 1);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  // The length of "$GPxxx,".
+  constexpr std::size_t headerLength = 7;
+
+  SentenceEmitter::SentenceEmitter(std::size_t bufferCapacity)
+    : sink{nullptr},
+      buffer(bufferCapacity)
+  {
+      if (bufferCapacity < maxSentenceLength)
+      {
+          throw std::invalid_argument("The emitter buffer is too small to hold a sentence.");
+      }
+  }
+
+  SentenceEmitter::SentenceEmitter(std::ostream& sink, std::size_t bufferCapacity)
+    : SentenceEmitter(bufferCapacity)
+  {
+      this->sink = &sink;
+  }
+
+  SentenceEmitter::~SentenceEmitter()
+  {
+      if (sink) sink->write(buffer.data(), used);
+  }
+
+  std::string_view SentenceEmitter::contents() const
+  {
+      return {buffer.data(), used};
+  }
+
+  void SentenceEmitter::clear()
+  {
+      used = 0;
+  }
+
+  void SentenceEmitter::flush()
+  {
+      if (sink) sink->write(buffer.data(), used);
+      used = 0;
+  }
+
+  char* SentenceEmitter::beginSentence(const char* format)
+  {
+      if (buffer.size() - used < maxSentenceLength)
+      {
+          if (sink) flush();
+          else buffer.resize(2 * buffer.size());
+      }
+
+      char* const begin = buffer.data() + used;
+      char* out = begin;
+      *out++ = '$';
+      *out++ = 'G';
+      *out++ = 'P';
+      for (; *format != '\0'; ++format) *out++ = *format;
+      *out = ',';
+      return begin;
+  }
+
+  void SentenceEmitter::endSentence(char* begin, char* end)
+  {
+      // The checksum covers everything between the '$' and the '*'.
+      unsigned char checksum = 0;
+      for (const char* c = begin + 1; c != end; ++c) checksum ^= *c;
+
+      constexpr char hexDigits[] = "0123456789ABCDEF";
+      *end++ = '*';
+      *end++ = hexDigits[checksum >> 4];
+      *end++ = hexDigits[checksum & 0xF];
+      *end++ = '\r';
+      *end++ = '\n';
+
+      used = end - buffer.data();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  // e.g. "$GPGLL,5425.3100,N,10703.0000,W,082610.000*hh"
+  void SentenceEmitter::gll(const Position& position, const std::optional<std::tm>& time)
+  {
+      char* const begin = beginSentence("GLL");
+      char* out = emitPosition(begin + headerLength, position);
+      *out++ = ',';
+      if (time) out = emitTimeOfDay(out, *time);
+      endSentence(begin, out);
+  }
+
+  // e.g. "$GPGGA,094627.000,3723.1622,N,00559.5788,W,1,08,1.0,30.0,M,0.0,M,,*hh"
+  void SentenceEmitter::gga(const Position& position, const std::optional<std::tm>& time, const GGAQuality& quality)
+  {
+      const std::int64_t hdopTenths = std::llround(quality.hdop * 10);
+      if (quality.quality > 9 || quality.satellites > 99 || ! (quality.hdop >= 0 && hdopTenths <= 999))
+      {
+          throw std::domain_error("GGA quality fields out of range.");
+      }
+
+      char* const begin = beginSentence("GGA");
+      char* out = begin + headerLength;
+      if (time) out = emitTimeOfDay(out, *time);
+      *out++ = ',';
+      out = emitPosition(out, position);
+      *out++ = ',';
+      out = emitDigits(out, quality.quality, 1);
+      *out++ = ',';
+      out = emitDigits(out, quality.satellites, 2);
+      *out++ = ',';
+      out = emitUnsigned(out, hdopTenths / 10);
+      *out++ = '.';
+      out = emitDigits(out, hdopTenths % 10, 1);
+      *out++ = ',';
+      out = emitElevation(out, position.elevation());
+      for (char c : std::string_view{",M,0.0,M,,"}) *out++ = c;
+      endSentence(begin, out);
+  }
+
+  // e.g. "$GPRMC,094627.000,A,3723.1622,N,00559.5788,W,,,150914,,,A*hh"
+  void SentenceEmitter::rmc(const Position& position, const std::tm& dateTime)
+  {
+      char* const begin = beginSentence("RMC");
+      char* out = emitTimeOfDay(begin + headerLength, dateTime);
+      *out++ = ',';
+      *out++ = 'A';
+      *out++ = ',';
+      out = emitPosition(out, position);
+      *out++ = ',';
+      *out++ = ',';
+      *out++ = ',';
+      out = emitDigits(out, dateTime.tm_mday, 2);
+      out = emitDigits(out, dateTime.tm_mon + 1, 2);
+      out = emitDigits(out, dateTime.tm_year % 100, 2);
+      for (char c : std::string_view{",,,A"}) *out++ = c;
+      endSentence(begin, out);
+  }
+}
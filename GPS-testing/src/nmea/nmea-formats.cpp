@@ -0,0 +1,292 @@
+#include <charconv>
+#include <cmath>
+
+#include "geometry.h"
+#include "earth.h"
+
+#include "nmea-formats.h"
+
+namespace GPS::NMEA
+{
+  const double metresPerSecondPerKnot = 1852.0 / 3600;
+
+  /* The functions below decode individual fields without allocating or throwing, so that dirty
+   * logs do not pay for exception handling.  They leave the Fix member empty if the field is
+   * empty, and return false only if a non-empty field is invalid.
+   */
+
+  // Parse the whole field as a decimal number.
+  bool tryParseNumber(std::string_view field, double& value)
+  {
+      if (field.empty()) return false;
+      const char* const end = field.data() + field.size();
+      const auto [parsedUpTo, error] = std::from_chars(field.data(), end, value);
+      return error == std::errc{} && parsedUpTo == end;
+  }
+
+  // Parse the whole field as an unsigned integer.
+  bool tryParseUnsigned(std::string_view field, unsigned int& value)
+  {
+      if (field.empty()) return false;
+      const char* const end = field.data() + field.size();
+      const auto [parsedUpTo, error] = std::from_chars(field.data(), end, value);
+      return error == std::errc{} && parsedUpTo == end;
+  }
+
+  // Decode a DDM angle with its N/S or E/W bearing field, as the Position constructor does (but with integer parsing).
+  DecodeStatus decodeAngle(std::string_view ddmField, std::string_view bearingField, char positive, char negative, degrees& angle)
+  {
+      if (bearingField.size() != 1 || (bearingField[0] != positive && bearingField[0] != negative)) return DecodeStatus::badBearing;
+
+      if (! decodeDDM(ddmField, angle)) return DecodeStatus::malformedNumber;
+      if (bearingField[0] == negative) angle = -angle;
+
+      return DecodeStatus::ok;
+  }
+
+  bool decodeNumber(std::string_view field, std::optional<double>& value)
+  {
+      if (field.empty()) return true;
+      double number;
+      if (! tryParseNumber(field, number)) return false;
+      value = number;
+      return true;
+  }
+
+  bool decodeCount(std::string_view field, std::optional<unsigned int>& value)
+  {
+      if (field.empty()) return true;
+      unsigned int count;
+      if (! tryParseUnsigned(field, count)) return false;
+      value = count;
+      return true;
+  }
+
+  // Times are "hhmmss" with optional decimal seconds; leading zeros are sometimes omitted.
+  bool decodeTimeOfDay(std::string_view field, std::optional<double>& timeOfDay)
+  {
+      if (field.empty()) return true;
+      double hhmmss;
+      if (! tryParseNumber(field, hhmmss) || hhmmss < 0) return false;
+
+      const double hours = std::floor(hhmmss / 10000);
+      const double minutes = std::floor(hhmmss / 100) - 100 * hours;
+      const double seconds = hhmmss - 10000 * hours - 100 * minutes;
+      if (hours >= 24 || minutes >= 60 || seconds >= 61) return false; // Allowing for a leap second.
+
+      timeOfDay = 3600 * hours + 60 * minutes + seconds;
+      return true;
+  }
+
+  bool isValidDate(const Date& date)
+  {
+      return date.month >= 1 && date.month <= 12 && date.day >= 1 && date.day <= 31;
+  }
+
+  // RMC dates are "ddmmyy".  Two-digit years from 80 onwards are taken to be in the 20th century.
+  bool decodeShortDate(std::string_view field, std::optional<Date>& date)
+  {
+      if (field.empty()) return true;
+      unsigned int ddmmyy;
+      if (field.size() != 6 || ! tryParseUnsigned(field, ddmmyy)) return false;
+
+      const unsigned int yy = ddmmyy % 100;
+      const Date decoded {yy < 80 ? 2000 + yy : 1900 + yy, (ddmmyy / 100) % 100, ddmmyy / 10000};
+      if (! isValidDate(decoded)) return false;
+
+      date = decoded;
+      return true;
+  }
+
+  bool decodeSpeedInKnots(std::string_view field, std::optional<speed>& groundSpeed)
+  {
+      std::optional<double> knots;
+      if (! decodeNumber(field, knots) || (knots && *knots < 0)) return false;
+      if (knots) groundSpeed = *knots * metresPerSecondPerKnot;
+      return true;
+  }
+
+  bool decodeCourse(std::string_view field, std::optional<degrees>& course)
+  {
+      return decodeNumber(field, course) && (! course || (*course >= 0 && *course <= fullRotation));
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  // The format-specific fields.
+
+  bool decodeRMC(const std::vector<std::string_view>& fields, Fix& fix)
+  {
+      return decodeSpeedInKnots(fields[6], fix.groundSpeed)
+          && decodeCourse(fields[7], fix.course)
+          && decodeShortDate(fields[8], fix.date);
+  }
+
+  bool decodeGGA(const std::vector<std::string_view>& fields, Fix& fix)
+  {
+      return decodeCount(fields[5], fix.quality)
+          && decodeCount(fields[6], fix.satellitesUsed)
+          && decodeNumber(fields[7], fix.hdop);
+  }
+
+  bool decodeVTG(const std::vector<std::string_view>& fields, Fix& fix)
+  {
+      return decodeCourse(fields[0], fix.course)
+          && decodeSpeedInKnots(fields[4], fix.groundSpeed);
+  }
+
+  bool decodeGSA(const std::vector<std::string_view>& fields, Fix& fix)
+  {
+      // Fields 2-13 hold the IDs of the satellites used, with unused slots left empty.
+      unsigned int satellitesUsed = 0;
+      for (std::size_t i = 2; i <= 13; ++i)
+      {
+          if (! fields[i].empty()) ++satellitesUsed;
+      }
+      fix.satellitesUsed = satellitesUsed;
+
+      return decodeNumber(fields[14], fix.pdop)
+          && decodeNumber(fields[15], fix.hdop)
+          && decodeNumber(fields[16], fix.vdop);
+  }
+
+  bool decodeGSV(const std::vector<std::string_view>& fields, Fix& fix)
+  {
+      return decodeCount(fields[2], fix.satellitesInView);
+  }
+
+  bool decodeZDA(const std::vector<std::string_view>& fields, Fix& fix)
+  {
+      if (fields[1].empty() && fields[2].empty() && fields[3].empty()) return true;
+
+      Date date;
+      if (! tryParseUnsigned(fields[1], date.day) || ! tryParseUnsigned(fields[2], date.month) ||
+          fields[3].size() != 4 || ! tryParseUnsigned(fields[3], date.year) || ! isValidDate(date))
+      {
+          return false;
+      }
+      fix.date = date;
+      return true;
+  }
+
+  bool decodeGNS(const std::vector<std::string_view>& fields, Fix& fix)
+  {
+      return decodeCount(fields[6], fix.satellitesUsed)
+          && decodeNumber(fields[7], fix.hdop);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  //                           format minFields maxFields time lat ele qual sats hdop  other fields
+  const FormatSpec formatGLL = { "GLL",  5,  5,  4,  0, -1, -1, -1, -1, nullptr   };
+  const FormatSpec formatRMC = { "RMC", 11, 13,  0,  2, -1, -1, -1, -1, decodeRMC };
+  const FormatSpec formatGGA = { "GGA", 14, 14,  0,  1,  8,  5,  6,  7, decodeGGA };
+  const FormatSpec formatVTG = { "VTG",  8,  9, -1, -1, -1, -1, -1, -1, decodeVTG };
+  const FormatSpec formatGSA = { "GSA", 17, 18, -1, -1, -1, -1, -1, -1, decodeGSA };
+  const FormatSpec formatGSV = { "GSV",  3, 20, -1, -1, -1, -1, -1, -1, decodeGSV };
+  const FormatSpec formatZDA = { "ZDA",  6,  6,  0, -1, -1, -1, -1, -1, decodeZDA };
+  const FormatSpec formatGNS = { "GNS", 12, 13,  0,  1,  8, -1,  6,  7, decodeGNS };
+
+  const FormatSpec* findFormat(std::string_view format)
+  {
+      switch (packFormatCode(format))
+      {
+          case packFormatCode("GLL"): return &formatGLL;
+          case packFormatCode("RMC"): return &formatRMC;
+          case packFormatCode("GGA"): return &formatGGA;
+          case packFormatCode("VTG"): return &formatVTG;
+          case packFormatCode("GSA"): return &formatGSA;
+          case packFormatCode("GSV"): return &formatGSV;
+          case packFormatCode("ZDA"): return &formatZDA;
+          case packFormatCode("GNS"): return &formatGNS;
+          default:                    return nullptr;
+      }
+  }
+
+  const std::vector<FormatSpec>& supportedFormats()
+  {
+      static const std::vector<FormatSpec> formats =
+        { formatGLL, formatRMC, formatGGA, formatVTG, formatGSA, formatGSV, formatZDA, formatGNS };
+      return formats;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  DecodeStatus decodePosition(const FormatSpec& spec, const SentenceView& sentence, degrees& lat, degrees& lon, metres& ele)
+  {
+      if (spec.latitudeField < 0) return DecodeStatus::noPosition;
+
+      const std::vector<std::string_view>& fields = sentence.dataFields;
+      const std::size_t first = spec.latitudeField;
+
+      ele = 0; // For formats that do not contain elevation data.
+      if (spec.elevationField >= 0 && ! tryParseNumber(fields[spec.elevationField], ele)) return DecodeStatus::malformedNumber;
+
+      if (const DecodeStatus status = decodeAngle(fields[first], fields[first+1], 'N', 'S', lat); status != DecodeStatus::ok) return status;
+      if (const DecodeStatus status = decodeAngle(fields[first+2], fields[first+3], 'E', 'W', lon); status != DecodeStatus::ok) return status;
+
+      if (! isValidLatitude(lat) || ! isValidLongitude(lon) || ! Earth::isValidElevation(ele)) return DecodeStatus::outOfRange;
+
+      return DecodeStatus::ok;
+  }
+
+  DecodeStatus checkQuality(const FormatSpec& spec, const SentenceView& sentence, const QualityFilter& filter)
+  {
+      const std::vector<std::string_view>& fields = sentence.dataFields;
+
+      // Each field is only parsed if its threshold can reject anything.
+      if (filter.minQuality > 0 && spec.qualityField >= 0 && ! fields[spec.qualityField].empty())
+      {
+          unsigned int quality;
+          if (! tryParseUnsigned(fields[spec.qualityField], quality)) return DecodeStatus::malformedNumber;
+          if (quality < filter.minQuality) return DecodeStatus::poorQuality;
+      }
+      if (filter.minSatellites > 0 && spec.satellitesField >= 0 && ! fields[spec.satellitesField].empty())
+      {
+          unsigned int satellites;
+          if (! tryParseUnsigned(fields[spec.satellitesField], satellites)) return DecodeStatus::malformedNumber;
+          if (satellites < filter.minSatellites) return DecodeStatus::poorQuality;
+      }
+      if (! std::isinf(filter.maxHdop) && spec.hdopField >= 0 && ! fields[spec.hdopField].empty())
+      {
+          double hdop;
+          if (! tryParseNumber(fields[spec.hdopField], hdop)) return DecodeStatus::malformedNumber;
+          if (! (hdop <= filter.maxHdop)) return DecodeStatus::poorQuality;
+      }
+
+      return DecodeStatus::ok;
+  }
+
+  bool meetsQuality(const Fix& fix, const QualityFilter& filter)
+  {
+      return (! fix.quality || *fix.quality >= filter.minQuality)
+          && (! fix.satellitesUsed || *fix.satellitesUsed >= filter.minSatellites)
+          && (! fix.hdop || *fix.hdop <= filter.maxHdop);
+  }
+
+  bool decodeFix(const SentenceView& sentence, Fix& fix)
+  {
+      const FormatSpec* const spec = findFormat(sentence.format);
+      if (! spec) return false;
+
+      const std::vector<std::string_view>& fields = sentence.dataFields;
+      if (fields.size() < spec->minFields || fields.size() > spec->maxFields) return false;
+
+      fix = Fix{};
+      fix.format = spec->format;
+      fix.talker = sentence.talker;
+
+      if (spec->timeField >= 0 && ! decodeTimeOfDay(fields[spec->timeField], fix.timeOfDay)) return false;
+
+      // Receivers without a fix leave the position fields empty.
+      if (spec->latitudeField >= 0 && ! (fields[spec->latitudeField].empty() && fields[spec->latitudeField + 2].empty()))
+      {
+          degrees lat, lon;
+          metres ele;
+          if (decodePosition(*spec, sentence, lat, lon, ele) != DecodeStatus::ok) return false;
+          fix.position.emplace(lat, lon, ele);
+      }
+
+      return ! spec->decodeOtherFields || spec->decodeOtherFields(fields, fix);
+  }
+}
@@ -0,0 +1,144 @@
+#include <stdexcept>
+#include <string_view>
+#include <iterator>
+
+#include "nmea-parser.h"
+#include "nmea-fusion.h"
+
+namespace GPS::NMEA
+{
+  const double secondsPerDay = 24 * 60 * 60;
+
+  /* Whether time of day 'a' is later than 'b', allowing for midnight: a time that is more than
+   * twelve hours earlier is taken to be on the following day.
+   */
+  bool isLaterTimeOfDay(double a, double b)
+  {
+      double difference = a - b;
+      if (difference < -secondsPerDay / 2) difference += secondsPerDay;
+      if (difference > secondsPerDay / 2) difference -= secondsPerDay;
+      return difference > 0;
+  }
+
+  bool carriesElevation(const Fix& fix)
+  {
+      const FormatSpec* const spec = findFormat(fix.format);
+      return spec && spec->elevationField >= 0;
+  }
+
+  template <typename T>
+  void mergeMember(std::optional<T>& into, const std::optional<T>& from)
+  {
+      if (! into) into = from;
+  }
+
+  void mergeFix(Fix& into, const Fix& from)
+  {
+      if (from.position && (! into.position || (carriesElevation(from) && ! carriesElevation(into))))
+      {
+          into.position = from.position;
+          into.format = from.format; // So that later merges can tell whether this position has an elevation.
+          into.talker = from.talker;
+      }
+      mergeMember(into.timeOfDay, from.timeOfDay);
+      mergeMember(into.date, from.date);
+      mergeMember(into.groundSpeed, from.groundSpeed);
+      mergeMember(into.course, from.course);
+      mergeMember(into.quality, from.quality);
+      mergeMember(into.satellitesUsed, from.satellitesUsed);
+      mergeMember(into.satellitesInView, from.satellitesInView);
+      mergeMember(into.pdop, from.pdop);
+      mergeMember(into.hdop, from.hdop);
+      mergeMember(into.vdop, from.vdop);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  EpochFuser::EpochFuser(std::size_t maxPendingEpochs)
+    : maxPendingEpochs{maxPendingEpochs}
+  {
+      if (maxPendingEpochs == 0) throw std::invalid_argument("The epoch buffer must hold at least one epoch.");
+  }
+
+  void EpochFuser::add(const Fix& fix, std::vector<Fix>& fused)
+  {
+      if (! fix.timeOfDay)
+      {
+          if (pending.empty())
+          {
+              fused.push_back(fix);
+          }
+          else
+          {
+              mergeFix(pending.back(), fix);
+          }
+          return;
+      }
+
+      // Search from the newest epoch, as that is where a partner sentence usually belongs.
+      auto it = pending.end();
+      while (it != pending.begin())
+      {
+          auto previous = std::prev(it);
+          if (*previous->timeOfDay == *fix.timeOfDay)
+          {
+              mergeFix(*previous, fix);
+              return;
+          }
+          if (isLaterTimeOfDay(*fix.timeOfDay, *previous->timeOfDay)) break;
+          it = previous;
+      }
+
+      if (lastEmitted && ! isLaterTimeOfDay(*fix.timeOfDay, *lastEmitted))
+      {
+          // Its epoch has already been emitted.
+          ++late;
+          fused.push_back(fix);
+          return;
+      }
+
+      pending.insert(it, fix);
+      if (pending.size() > maxPendingEpochs)
+      {
+          lastEmitted = pending.front().timeOfDay;
+          fused.push_back(pending.front());
+          pending.pop_front();
+      }
+  }
+
+  void EpochFuser::flush(std::vector<Fix>& fused)
+  {
+      if (! pending.empty()) lastEmitted = pending.back().timeOfDay;
+      fused.insert(fused.end(), pending.begin(), pending.end());
+      pending.clear();
+  }
+
+  std::size_t EpochFuser::pendingEpochs() const
+  {
+      return pending.size();
+  }
+
+  std::size_t EpochFuser::lateFixes() const
+  {
+      return late;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  std::vector<Fix> readFusedFixes(std::istream& input, std::size_t maxPendingEpochs)
+  {
+      EpochFuser fuser {maxPendingEpochs};
+      std::vector<Fix> fused;
+
+      SentenceView sentence;
+      Fix fix;
+      forEachLine(input, [&](std::string_view line)
+      {
+          if (! line.empty() && line.back() == '\r') line.remove_suffix(1);
+          if (scanSentence(line, sentence) == ScanResult::valid && decodeFix(sentence, fix)) fuser.add(fix, fused);
+      });
+      fuser.flush(fused);
+
+      return fused;
+  }
+}
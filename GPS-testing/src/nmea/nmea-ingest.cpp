@@ -0,0 +1,248 @@
+#include <stdexcept>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "nmea-ingest.h"
+
+namespace GPS::NMEA
+{
+  // The number of reads from one device before moving on to the next.
+  const std::size_t readsPerTurn = 4;
+
+  IngestEngine::Device::Device(int fd, std::size_t shard, std::size_t queueCapacity)
+    : fd{fd},
+      shardIndex{shard},
+      fixes{queueCapacity}
+  {}
+
+  bool IngestEngine::Device::tryPop(Fix& fix)
+  {
+      return fixes.tryPop(fix);
+  }
+
+  bool IngestEngine::Device::ended() const
+  {
+      return inputEnded.load(std::memory_order_acquire);
+  }
+
+  std::size_t IngestEngine::Device::droppedFixes() const
+  {
+      return dropped.load(std::memory_order_relaxed);
+  }
+
+  std::size_t IngestEngine::Device::shard() const
+  {
+      return shardIndex;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  IngestEngine::IngestEngine(std::size_t shardCount, std::size_t queueCapacity)
+    : queueCapacity{queueCapacity}
+  {
+      if (queueCapacity == 0) throw std::invalid_argument("The fix queues must have a non-zero capacity.");
+      if (shardCount == 0) shardCount = std::max(1u, std::thread::hardware_concurrency());
+
+      for (std::size_t i = 0; i < shardCount; ++i)
+      {
+          auto shard = std::make_unique<Shard>();
+          if (::pipe(shard->wakePipe) != 0)
+          {
+              stop();
+              throw std::runtime_error(std::string("Could not create an ingest shard: ") + std::strerror(errno));
+          }
+          ::fcntl(shard->wakePipe[0], F_SETFL, O_NONBLOCK);
+          ::fcntl(shard->wakePipe[1], F_SETFL, O_NONBLOCK);
+          shards.push_back(std::move(shard));
+          shards.back()->thread = std::thread(&IngestEngine::serve, this, std::ref(*shards.back()));
+      }
+  }
+
+  IngestEngine::~IngestEngine()
+  {
+      stop();
+  }
+
+  IngestEngine::Device& IngestEngine::addDevice(int fd)
+  {
+      if (stopping) throw std::logic_error("Devices cannot be added to a stopped ingest engine.");
+
+      // The shard with the fewest devices.
+      std::size_t targetIndex = 0;
+      std::size_t fewestDevices = std::numeric_limits<std::size_t>::max();
+      for (std::size_t i = 0; i < shards.size(); ++i)
+      {
+          std::lock_guard<std::mutex> lock {shards[i]->mutex};
+          if (shards[i]->numDevices < fewestDevices)
+          {
+              fewestDevices = shards[i]->numDevices;
+              targetIndex = i;
+          }
+      }
+      Shard& target = *shards[targetIndex];
+
+      auto device = std::make_unique<Device>(fd, targetIndex, queueCapacity);
+      Device* const devicePtr = device.get();
+      device->reader = std::make_unique<LiveReader>(fd, [devicePtr](const Fix& fix)
+      {
+          if (! devicePtr->fixes.tryPush(fix)) devicePtr->dropped.fetch_add(1, std::memory_order_relaxed);
+      });
+
+      {
+          std::lock_guard<std::mutex> lock {devicesMutex};
+          devices.push_back(std::move(device));
+      }
+      {
+          std::lock_guard<std::mutex> lock {target.mutex};
+          target.newDevices.push_back(devicePtr);
+          ++target.numDevices;
+      }
+      wake(target);
+      return *devicePtr;
+  }
+
+  void IngestEngine::removeDevice(Device& device)
+  {
+      {
+          std::lock_guard<std::mutex> lock {devicesMutex};
+          const bool found = std::any_of(devices.begin(), devices.end(),
+                                         [&device](const std::unique_ptr<Device>& d) { return d.get() == &device; });
+          if (! found) throw std::invalid_argument("The device does not belong to this ingest engine.");
+      }
+
+      // Wait for the shard's thread to let go of the device.
+      Shard& shard = *shards[device.shardIndex];
+      {
+          std::unique_lock<std::mutex> lock {shard.mutex};
+          shard.removedDevices.push_back(&device);
+          if (! shard.finished) wake(shard); // Once finished, the wake pipe may have been closed.
+          shard.released.wait(lock, [&] { return device.released || shard.finished; });
+      }
+
+      std::lock_guard<std::mutex> lock {devicesMutex};
+      devices.erase(std::find_if(devices.begin(), devices.end(),
+                                 [&device](const std::unique_ptr<Device>& d) { return d.get() == &device; }));
+  }
+
+  void IngestEngine::stop()
+  {
+      if (stopping.exchange(true)) return;
+
+      for (const std::unique_ptr<Shard>& shard : shards)
+      {
+          wake(*shard);
+          if (shard->thread.joinable()) shard->thread.join();
+          ::close(shard->wakePipe[0]);
+          ::close(shard->wakePipe[1]);
+      }
+  }
+
+  std::size_t IngestEngine::shardCount() const
+  {
+      return shards.size();
+  }
+
+  void IngestEngine::wake(Shard& shard)
+  {
+      const char byte = 0;
+      [[maybe_unused]] const ssize_t written = ::write(shard.wakePipe[1], &byte, 1); // If the pipe is full, the shard is already awake.
+  }
+
+  void IngestEngine::serve(Shard& shard)
+  {
+      std::vector<Device*> active;
+      std::vector<pollfd> descriptors;
+
+      while (! stopping.load(std::memory_order_acquire))
+      {
+          {
+              std::lock_guard<std::mutex> lock {shard.mutex};
+              active.insert(active.end(), shard.newDevices.begin(), shard.newDevices.end());
+              shard.newDevices.clear();
+
+              if (! shard.removedDevices.empty())
+              {
+                  for (Device* device : shard.removedDevices)
+                  {
+                      // Ended devices have already left 'active'.
+                      const auto found = std::find(active.begin(), active.end(), device);
+                      if (found != active.end())
+                      {
+                          active.erase(found);
+                          --shard.numDevices;
+                      }
+                      device->released = true;
+                  }
+                  shard.removedDevices.clear();
+                  shard.released.notify_all();
+              }
+          }
+
+          // The wake pipe comes first, followed by the devices in the same order as 'active'.
+          descriptors.clear();
+          descriptors.push_back({shard.wakePipe[0], POLLIN, 0});
+          for (Device* device : active) descriptors.push_back({device->fd, POLLIN, 0});
+
+          if (::poll(descriptors.data(), descriptors.size(), -1) < 0 && errno != EINTR)
+          {
+              // Nothing more can be read; this thread cannot throw, so the devices are ended instead.
+              for (Device* device : active) endDevice(*device);
+              break;
+          }
+
+          if (descriptors[0].revents != 0)
+          {
+              char bytes[64];
+              while (::read(shard.wakePipe[0], bytes, sizeof(bytes)) > 0) {}
+          }
+
+          std::size_t remaining = 0;
+          for (std::size_t i = 0; i < active.size(); ++i)
+          {
+              Device* const device = active[i];
+              bool open = true;
+              if (descriptors[i+1].revents != 0)
+              {
+                  try
+                  {
+                      open = device->reader->readSome(readsPerTurn);
+                  }
+                  catch (const std::runtime_error&) // A read error ends only that device.
+                  {
+                      open = false;
+                  }
+              }
+
+              if (open)
+              {
+                  active[remaining++] = device;
+              }
+              else
+              {
+                  endDevice(*device);
+                  std::lock_guard<std::mutex> lock {shard.mutex};
+                  --shard.numDevices;
+              }
+          }
+          active.resize(remaining);
+      }
+
+      std::lock_guard<std::mutex> lock {shard.mutex};
+      shard.finished = true;
+      shard.released.notify_all();
+  }
+
+  void IngestEngine::endDevice(Device& device)
+  {
+      // The reader restores the descriptor's flags, which must happen before the caller can see
+      // that the device has ended (and so may close the descriptor).
+      device.reader.reset();
+      device.inputEnded.store(true, std::memory_order_release);
+  }
+}
@@ -0,0 +1,197 @@
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "nmea-parser.h"
+#include "nmea-live.h"
+
+namespace GPS::NMEA
+{
+  LiveReader::LiveReader(int fd, FixCallback onFix, std::size_t bufferSize)
+    : fd{fd},
+      onFix{std::move(onFix)},
+      ring(bufferSize)
+  {
+      if (bufferSize == 0) throw std::invalid_argument("The live reader's buffer must not be empty.");
+
+      originalFlags = ::fcntl(fd, F_GETFL);
+      if (originalFlags < 0 || ::fcntl(fd, F_SETFL, originalFlags | O_NONBLOCK) < 0)
+      {
+          throw std::invalid_argument("Cannot read from file descriptor " + std::to_string(fd) + ".");
+      }
+  }
+
+  LiveReader::~LiveReader()
+  {
+      ::fcntl(fd, F_SETFL, originalFlags);
+  }
+
+  bool LiveReader::poll()
+  {
+      return readSome(std::numeric_limits<std::size_t>::max());
+  }
+
+  bool LiveReader::readSome(std::size_t maxReads)
+  {
+      for (std::size_t reads = 0; ! endOfInput; ++reads)
+      {
+          if (reads == maxReads) return true;
+
+          if (count == ring.size())
+          {
+              // The buffer is full without a complete line, so the line is too long to be a sentence.
+              if (! discarding) ++discarded;
+              discarding = true;
+              head = 0;
+              count = 0;
+          }
+
+          // Read into the free space after the data, up to the end of the ring.
+          const std::size_t tail = (head + count) % ring.size();
+          const std::size_t space = std::min(ring.size() - count, ring.size() - tail);
+          const ssize_t bytesRead = ::read(fd, ring.data() + tail, space);
+
+          if (bytesRead > 0)
+          {
+              count += bytesRead;
+              consumeLines(tail, bytesRead);
+          }
+          else if (bytesRead == 0 || errno == EIO) // EIO: the other end of a pseudo-terminal was closed.
+          {
+              finish();
+          }
+          else if (errno == EAGAIN || errno == EWOULDBLOCK)
+          {
+              return true;
+          }
+          else if (errno != EINTR)
+          {
+              throw std::runtime_error(std::string("Error reading NMEA data: ") + std::strerror(errno));
+          }
+      }
+      return false;
+  }
+
+  bool LiveReader::poll(std::chrono::milliseconds timeout)
+  {
+      if (endOfInput) return false;
+
+      pollfd request {fd, POLLIN, 0};
+      const int status = ::poll(&request, 1, static_cast<int>(timeout.count()));
+      if (status < 0 && errno != EINTR)
+      {
+          throw std::runtime_error(std::string("Error waiting for NMEA data: ") + std::strerror(errno));
+      }
+      return poll();
+  }
+
+  void LiveReader::run(std::chrono::milliseconds stopLatency)
+  {
+      while (! stopping && poll(stopLatency)) {}
+  }
+
+  void LiveReader::stop()
+  {
+      stopping = true;
+  }
+
+  bool LiveReader::ended() const
+  {
+      return endOfInput;
+  }
+
+  std::size_t LiveReader::discardedLines() const
+  {
+      return discarded;
+  }
+
+  // The unconsumed data before the new data contains no '\n', so only the new data is searched.
+  void LiveReader::consumeLines(std::size_t newDataStart, std::size_t newDataSize)
+  {
+      const char* const newData = ring.data() + newDataStart;
+      for (const char* newline = static_cast<const char*>(std::memchr(newData, '\n', newDataSize));
+           newline != nullptr;
+           newline = static_cast<const char*>(std::memchr(newline + 1, '\n', newData + newDataSize - (newline + 1))))
+      {
+          const std::size_t lineEnd = newline - ring.data();
+          const std::size_t length = (lineEnd + ring.size() - head) % ring.size();
+
+          if (discarding)
+          {
+              discarding = false;
+          }
+          else
+          {
+              processLine(head, length);
+          }
+
+          head = (lineEnd + 1) % ring.size();
+          count -= length + 1;
+      }
+  }
+
+  void LiveReader::processLine(std::size_t start, std::size_t length)
+  {
+      std::string_view line;
+      if (start + length <= ring.size())
+      {
+          line = std::string_view(ring.data() + start, length);
+      }
+      else
+      {
+          const std::size_t firstPart = ring.size() - start;
+          wrappedLine.assign(ring.data() + start, firstPart);
+          wrappedLine.append(ring.data(), length - firstPart);
+          line = wrappedLine;
+      }
+
+      if (! line.empty() && line.back() == '\r') line.remove_suffix(1);
+      if (scanSentence(line, sentence) == ScanResult::valid && decodeFix(sentence, fix)) onFix(fix);
+  }
+
+  void LiveReader::finish()
+  {
+      endOfInput = true;
+      if (count > 0 && ! discarding) processLine(head, count);
+      head = 0;
+      count = 0;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  FixGenerator::FixGenerator(int fd, std::size_t bufferSize)
+    : reader{fd, [this](const Fix& fix) { decoded.push_back(fix); }, bufferSize}
+  {}
+
+  std::optional<Fix> FixGenerator::next()
+  {
+      if (decoded.empty())
+      {
+          // Having yielded what the last read decoded, hand back to the caller before reading again.
+          if (yielded)
+          {
+              yielded = false;
+              return {};
+          }
+          if (! reader.ended()) reader.readSome(readsPerResume);
+          if (decoded.empty()) return {};
+      }
+
+      const Fix fix = decoded.front();
+      decoded.pop_front();
+      yielded = true;
+      return fix;
+  }
+
+  bool FixGenerator::ended() const
+  {
+      return decoded.empty() && reader.ended();
+  }
+}
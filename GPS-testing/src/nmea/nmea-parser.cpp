@@ -1,171 +1,325 @@
 // #include <iostream> // For debugging
 #include <stdexcept>
+#include <string_view>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <algorithm>
 
+#include "io-mapped.h"
+#include "nmea-formats.h"
 #include "nmea-parser.h"
 
 namespace GPS::NMEA
 {
-  bool isSupportedFormat(std::string)
+  bool isSupportedFormat(std::string format)
   {
-      // Stub definition, needs implementing
-      return false;
+      return findFormat(format) != nullptr;
   }
 
-  bool hasValidSentenceStructure(std::string s)
+  /* The functions below work on std::string_views, so that readSentences() can check and
+   * decode each line in place, without copying the line or its fields.
+   */
+
+  bool isHexDigit(char c)
   {
-      char c;
-      unsigned int i;
-      if (s.empty()) return false; // Need this or next line could crash
-      if (s[0] != '$') return false;
-      if (s.size() < 3) return false; // Need this or next line could crash
-      if (s[1] != 'G') return false;
-      if (s[2] != 'P') return false;
-      // cout << "Debug A" << endl;
-      if (s.size() < 6) return false; // Need this or next line could crash
-      c = s[3];
-      if (c < 65 || c > 90) return false;
-      c = s[4];
-      if (c < 65 || c > 90) return false;
-      c = s[5];
-      if (c < 'A' || c > 'Z') return false; // Hey Ken: we can do it like this instead of using the ASCII codes.  Shall I change the previous two like this as well?
-      // cout << "Debug B" << endl;
-      if (s.size() < 7) return false; // Need this or next line could crash.
-      if (s[6] != ',') return false;
-      // cout << "Debug C" << endl;
-      /*
-      i = 7;
-      while (true)
+      return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
+  }
+
+  unsigned int hexDigitValue(char c)
+  {
+      if (c >= '0' && c <= '9') return c - '0';
+      if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+      return c - 'a' + 10;
+  }
+
+  ScanResult scanSentence(std::string_view s, SentenceView& sentence)
+  {
+      sentence.format = {};
+      sentence.dataFields.clear();
+
+      if (s.size() < 7 || s[0] != '$' || ! findTalker(s[1], s[2], sentence.talker)) return ScanResult::invalidStructure;
+
+      unsigned char checksum = s[1] ^ s[2];
+      for (std::size_t i = 3; i < 6; ++i)
+      {
+          if (s[i] < 'A' || s[i] > 'Z') return ScanResult::invalidStructure;
+          checksum ^= s[i];
+      }
+      if (s[6] != ',') return ScanResult::invalidStructure;
+      checksum ^= ',';
+
+      // The data fields: each character is checked, added to the checksum, and tested for a field boundary.
+      std::size_t fieldStart = 7;
+      std::size_t i = 7;
+      for (; i < s.size() && s[i] != '*'; ++i)
       {
-          if (i == potentialSentence.size()) return false;
-          if (potentialSentence[i] == '$') return false; // Not allowed here.
-          if (potentialSentence[i] == '*') break;
-          ++i;
+          const char c = s[i];
+          if (c == '$') return ScanResult::invalidStructure;
+          checksum ^= c;
+          if (c == ',')
+          {
+              sentence.dataFields.push_back(s.substr(fieldStart, i - fieldStart));
+              fieldStart = i + 1;
+          }
       }
-      */
-      // Nadia: for-loop is better.
-      for (i = 7; true; ++i)
+      sentence.dataFields.push_back(s.substr(fieldStart, i - fieldStart));
+
+      // The '*' must be followed by exactly two hexadecimal digits.
+      if (i + 3 != s.size() || ! isHexDigit(s[i+1]) || ! isHexDigit(s[i+2]))
       {
-          if (i == s.size()) return false;
-          if (s[i] == '$') return false; // Not allowed here.
-          if (s[i] == '*') break;
+          sentence.dataFields.clear();
+          return ScanResult::invalidStructure;
       }
-      // cout << "Debug D" << endl;
-      if (s.size() < i+3) return false; // Note: i+3 NOT i+2.  This is confusing.
-      c = s[i+1];
-      if ((c < 48) || (c > 57 && c < 65) || (c > 70 && c < 97) || (c > 102)) return false;
-      c = s[i+2];
-      if ((c < 48) || (c > 57 && c < 65) || (c > 70 && c < 97) || (c > 102)) return false;
-      // cout << "Debug E" << endl;
-      // cout << potentialSentence.size() << endl;
-      // cout << i << endl;
-      if (s.size() != i+3) return false; // Note: i+3 NOT i+2.  This is confusing.
-      // Alice: It's because indexing starts at 0, so the index number is one less.
-      // Nadia: No, it's because we're using '<' rather than '<='.  We need a char at i+2, so we say < i+3.
-      // Ken: But indexing normally starts at 0, and we normally use <. So why is this different?
-      return true;
+
+      sentence.format = s.substr(3,3);
+
+      if (checksum != 16 * hexDigitValue(s[i+1]) + hexDigitValue(s[i+2])) return ScanResult::checksumMismatch;
+
+      return ScanResult::valid;
   }
 
-  bool checksumMatches(std::string)
+  bool hasValidSentenceStructure(std::string s)
   {
-      // Stub definition, needs implementing
-      return false;
+      SentenceView sentence;
+      return scanSentence(s, sentence) != ScanResult::invalidStructure;
   }
 
-  SentenceData parseSentence(std::string)
+  bool checksumMatches(std::string s)
   {
-      // Stub definition, needs implementing
-      return {"",{}};
+      SentenceView sentence;
+      return scanSentence(s, sentence) == ScanResult::valid;
   }
 
-  bool hasCorrectNumberOfFields(SentenceData)
+  SentenceData parseSentence(std::string s)
   {
-      // Stub definition, needs implementing
-      return true;
+      SentenceView sentence;
+      scanSentence(s, sentence);
+      return {std::string(sentence.format), std::vector<std::string>(sentence.dataFields.begin(), sentence.dataFields.end()), sentence.talker};
+  }
+
+  bool hasCorrectNumberOfFields(SentenceData d)
+  {
+      const FormatSpec* const spec = findFormat(d.format);
+      return spec && d.dataFields.size() >= spec->minFields && d.dataFields.size() <= spec->maxFields;
   }
 
   Position positionFromSentenceData(SentenceData d)
   {
-      using namespace std; // Ken: Writing 'std::' everywhere is irritating.
-      string la, lo, ns, ew, e;
-      char ns0, ew0;
-      Position p = Position(0,0,0); // Dummy object becasue there's no default constructor available for Postion
-      if (d.format == "GLL")
+      const FormatSpec* const spec = findFormat(d.format);
+      if (! spec || spec->latitudeField < 0)
       {
-          la = d.dataFields[0];
-          lo = d.dataFields[2];
-          ns = d.dataFields[1];
-          ew = d.dataFields[3];
-          e = "0"; // no ele
-          if (ns.size() == 1) {
-              ns0 = ns[0];
-          } else {
-              throw domain_error(string("Ill-formed bearing in GLL sentence field: ") + ns + ". Bearings must be a single character.");
-          }
-          if (ew.size() == 1) {
-              ew0 = ew[0];
-          } else {
-              throw domain_error(string("Ill-formed bearing in GLL sentence field: ") + ew + ". Bearings must be a single character.");
-          }
-          try
-          {
-                p = Position(la,ns0,lo,ew0,e);
-          }
-          catch (const invalid_argument& e)
+          throw std::domain_error(d.format + " sentences do not contain a position.");
+      }
+
+      const std::size_t first = spec->latitudeField;
+      const std::string& ns = d.dataFields[first+1];
+      const std::string& ew = d.dataFields[first+3];
+      for (const std::string& bearing : {ns, ew})
+      {
+          if (bearing.size() != 1)
           {
-                throw domain_error(string("Ill-formed GLL sentence field: ") + e.what());
+              throw std::domain_error("Ill-formed bearing in " + d.format + " sentence field: " + bearing + ". Bearings must be a single character.");
           }
       }
-      else if (d.format == "RMC")
+
+      const std::string ele = spec->elevationField >= 0 ? d.dataFields[spec->elevationField] : "0";
+
+      try
       {
-          la = d.dataFields[2];
-          lo = d.dataFields[4];
-          ns = d.dataFields[3];
-          ew = d.dataFields[5];
-          e = "0"; // no ele
-          if (ns.size() != 1) {
-              throw domain_error(string("Ill-formed bearing in RMC sentence field: ") + ns + ". Bearings must be a single character.");
-          } else {
-              ns0 = ns[0];
-          }
-          if (ew.size() != 1) {
-              throw domain_error(string("Ill-formed bearing in RMC sentence field: ") + ew + ". Bearings must be a single character.");
-          } else {
-              ew0 = ew[0];
-          }
-          try {
-            p = Position(la,ns0,lo,ew0,e);
-          }
-          catch (const invalid_argument& e) {
-            throw domain_error(string("Ill-formed RMC sentence field: ") + e.what());
-          }
-      } else if (d.format == "GGA")
+          return Position(d.dataFields[first], ns[0], d.dataFields[first+2], ew[0], ele);
+      }
+      catch (const std::invalid_argument& e)
       {
-          la = d.dataFields[1];
-          lo = d.dataFields[3];
-          ns = d.dataFields[2];
-          ew = d.dataFields[4];
-          e = d.dataFields[8];
-          if (ns.size() != 1) {
-              throw domain_error(string("Ill-formed bearing in GGA sentence field: ") + ns + ". Bearings must be a single character.");
-          }
-          ns0 = ns[0];
-          if (ew.size() != 1) {
-              throw domain_error(string("Ill-formed bearing in GGA sentence field: ") + ew + ". Bearings must be a single character.");
+          throw std::domain_error("Ill-formed " + d.format + " sentence field: " + e.what());
+      }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  std::uint64_t DecodeCounters::rejected() const
+  {
+      std::uint64_t total = 0;
+      for (std::size_t status = 0; status < numDecodeStatuses; ++status) total += counts[status];
+      return total - counts[static_cast<std::size_t>(DecodeStatus::ok)];
+  }
+
+  DecodeCounters& DecodeCounters::operator+=(const DecodeCounters& other)
+  {
+      for (std::size_t status = 0; status < numDecodeStatuses; ++status) counts[status] += other.counts[status];
+      return *this;
+  }
+
+  // Accepts every sentence, without examining its quality fields.
+  const QualityFilter anyQuality {0};
+
+  DecodeStatus decodePositionSentence(std::string_view line, SentenceView& sentence, degrees& lat, degrees& lon, metres& ele)
+  {
+      return decodePositionSentence(line, sentence, anyQuality, lat, lon, ele);
+  }
+
+  DecodeStatus decodePositionSentence(std::string_view line, SentenceView& sentence, const QualityFilter& filter,
+                                      degrees& lat, degrees& lon, metres& ele)
+  {
+      if (! line.empty() && line.back() == '\r') line.remove_suffix(1); // NMEA lines usually end with "\r\n".
+
+      switch (scanSentence(line, sentence))
+      {
+          case ScanResult::invalidStructure: return DecodeStatus::invalidStructure;
+          case ScanResult::checksumMismatch: return DecodeStatus::checksumMismatch;
+          case ScanResult::valid:            break;
+      }
+
+      const FormatSpec* const spec = findFormat(sentence.format);
+      if (! spec) return DecodeStatus::unsupportedFormat;
+      if (spec->latitudeField < 0) return DecodeStatus::noPosition; // Only formats that carry a position are read.
+      if (sentence.dataFields.size() < spec->minFields || sentence.dataFields.size() > spec->maxFields) return DecodeStatus::wrongNumberOfFields;
+
+      if (const DecodeStatus status = checkQuality(*spec, sentence, filter); status != DecodeStatus::ok) return status;
+
+      return decodePosition(*spec, sentence, lat, lon, ele);
+  }
+
+  // Check and decode one line, appending its Position if it contains a valid sentence.
+  bool tryReadSentence(std::string_view line, SentenceView& sentence, std::vector<Position>& positions,
+                       const QualityFilter& filter = anyQuality, DecodeCounters* counters = nullptr)
+  {
+      degrees lat, lon;
+      metres ele;
+      const DecodeStatus status = decodePositionSentence(line, sentence, filter, lat, lon, ele);
+      if (counters && ! (line.empty() || line == "\r")) counters->record(status);
+      if (status != DecodeStatus::ok) return false;
+
+      positions.emplace_back(lat, lon, ele);
+      return true;
+  }
+
+  /* Reads the input in large blocks, and passes each line to the function in place within the
+   * block.  A line that straddles two blocks is moved to the front of the buffer before the
+   * next block is read after it; the buffer only grows if a single line exceeds its size.
+   */
+  void forEachLine(std::istream & input, const std::function<void(std::string_view)> & processLine)
+  {
+      std::vector<char> buffer(64 * 1024);
+      std::size_t carried = 0; // The length of the incomplete line at the front of the buffer.
+
+      while (true)
+      {
+          if (carried == buffer.size()) buffer.resize(2 * buffer.size());
+
+          input.read(buffer.data() + carried, buffer.size() - carried);
+          const std::size_t available = carried + input.gcount();
+          const bool endOfInput = input.gcount() == 0;
+
+          std::string_view block {buffer.data(), available};
+          std::size_t lineStart = 0;
+          for (std::size_t lineEnd = block.find('\n'); lineEnd != std::string_view::npos; lineEnd = block.find('\n', lineStart))
+          {
+              processLine(block.substr(lineStart, lineEnd - lineStart));
+              lineStart = lineEnd + 1;
           }
-          ew0 = ew[0];
-          try {
-            p = Position(la,ns0,lo,ew0,e);
-          } catch (const invalid_argument& e)
+
+          if (endOfInput)
           {
-              throw domain_error(string("Ill-formed GGA sentence field: ") + e.what());
+              // The final line need not be terminated.
+              if (lineStart < available) processLine(block.substr(lineStart));
+              return;
           }
+
+          carried = available - lineStart;
+          std::memmove(buffer.data(), buffer.data() + lineStart, carried);
       }
-      return p;
   }
 
-  std::vector<Position> readSentences(std::istream &)
+  void readSentencesInto(std::istream & input, std::vector<Position>& positions, IO::ProgressMonitor* monitor,
+                         const QualityFilter& filter = anyQuality, DecodeCounters* counters = nullptr)
   {
-      // Stub definition, needs implementing
-      return {};
+      SentenceView sentence;
+      forEachLine(input, [&](std::string_view line)
+      {
+          if (tryReadSentence(line, sentence, positions, filter, counters) && monitor) monitor->addPoints(1);
+      });
+  }
+
+  std::vector<Position> readSentences(std::istream & input)
+  {
+      std::vector<Position> positions;
+      readSentencesInto(input, positions, nullptr);
+      return positions;
+  }
+
+  std::vector<Position> readSentences(std::istream & input, DecodeCounters & counters)
+  {
+      std::vector<Position> positions;
+      readSentencesInto(input, positions, nullptr, anyQuality, &counters);
+      return positions;
+  }
+
+  std::vector<Position> readSentences(std::istream & input, const QualityFilter & filter)
+  {
+      std::vector<Position> positions;
+      readSentencesInto(input, positions, nullptr, filter);
+      return positions;
+  }
+
+  std::vector<Position> readSentences(std::istream & input, const QualityFilter & filter, DecodeCounters & counters)
+  {
+      std::vector<Position> positions;
+      readSentencesInto(input, positions, nullptr, filter, &counters);
+      return positions;
+  }
+
+  std::vector<Position> readSentences(std::istream & input, IO::ProgressMonitor & monitor)
+  {
+      IO::MonitoredStream monitoredInput {input, monitor};
+      std::vector<Position> positions;
+      readSentencesInto(monitoredInput, positions, &monitor);
+      monitor.check();
+      return positions;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  // Read every line of a chunk, which must hold only whole lines (perhaps without the final '\n').
+  void readSentencesInChunk(std::string_view chunk, std::vector<Position>& positions)
+  {
+      SentenceView sentence;
+      std::size_t lineStart = 0;
+      while (lineStart < chunk.size())
+      {
+          std::size_t lineEnd = chunk.find('\n', lineStart);
+          if (lineEnd == std::string_view::npos) lineEnd = chunk.size();
+          tryReadSentence(chunk.substr(lineStart, lineEnd - lineStart), sentence, positions);
+          lineStart = lineEnd + 1;
+      }
+  }
+
+  std::vector<Position> readSentencesParallel(const std::string& filepath, unsigned int threadCount)
+  {
+      if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+      const IO::MappedFile file {filepath};
+      const std::vector<std::string_view> chunks = IO::splitIntoLineChunks(file.contents(), threadCount);
+
+      // Each chunk is read into its own vector, by its own thread (the first by this thread).
+      std::vector<std::vector<Position>> chunkPositions(chunks.size());
+      std::vector<std::thread> threads;
+      for (std::size_t i = 1; i < chunks.size(); ++i)
+      {
+          threads.emplace_back(readSentencesInChunk, chunks[i], std::ref(chunkPositions[i]));
+      }
+      if (! chunks.empty()) readSentencesInChunk(chunks[0], chunkPositions[0]);
+      for (std::thread& thread : threads) thread.join();
+
+      std::size_t total = 0;
+      for (const std::vector<Position>& positions : chunkPositions) total += positions.size();
+
+      std::vector<Position> positions;
+      positions.reserve(total);
+      for (const std::vector<Position>& part : chunkPositions)
+      {
+          positions.insert(positions.end(), part.begin(), part.end());
+      }
+      return positions;
   }
 }
@@ -0,0 +1,302 @@
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <cmath>
+#include <cerrno>
+#include <ctime>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "codec-track.h"
+#include "nmea-parser.h"
+#include "nmea-formats.h"
+#include "nmea-emitter.h"
+#include "nmea-replay.h"
+
+namespace GPS::NMEA
+{
+  // Returns the time of day carried by the line, if it is a valid sentence that carries one.
+  std::optional<double> replayTimeOfDay(std::string_view line, SentenceView& sentence)
+  {
+      Fix fix;
+      if (scanSentence(line, sentence) != ScanResult::valid || ! decodeFix(sentence, fix)) return {};
+      return fix.timeOfDay;
+  }
+
+  ReplayLog ReplayLog::fromNMEA(std::istream& input)
+  {
+      constexpr double secondsPerDay = 24 * 60 * 60;
+
+      ReplayLog log;
+      SentenceView sentence;
+      std::optional<double> firstTime; // The time of day of the first timed sentence.
+      double lastTime = 0;   // The time of day of the most recent timed sentence.
+      double dayOffset = 0;  // Seconds added for each midnight passed.
+      double lastDue = 0;
+
+      forEachLine(input, [&](std::string_view line)
+      {
+          if (! line.empty() && line.back() == '\r') line.remove_suffix(1);
+          if (line.empty()) return;
+
+          const std::optional<double> time = replayTimeOfDay(line, sentence);
+          if (time)
+          {
+              if (! firstTime) firstTime = lastTime = *time;
+
+              double adjustedTime = *time + dayOffset;
+              if (*time < lastTime - secondsPerDay / 2)
+              {
+                  // Passed midnight.
+                  dayOffset += secondsPerDay;
+                  adjustedTime += secondsPerDay;
+                  lastTime = *time;
+              }
+              else if (*time > lastTime + secondsPerDay / 2)
+              {
+                  // A late sentence from before midnight.
+                  adjustedTime -= secondsPerDay;
+              }
+              else
+              {
+                  lastTime = *time;
+              }
+              lastDue = std::max(lastDue, adjustedTime - *firstTime);
+          }
+          log.append(line, lastDue);
+      });
+
+      return log;
+  }
+
+  ReplayLog ReplayLog::fromTrack(const std::vector<TrackPoint>& trackPoints)
+  {
+      ReplayLog log;
+      if (trackPoints.empty()) return log;
+
+      // Track point times are UTC, so are converted without reference to the local time zone.
+      SentenceEmitter emitter;
+      const std::time_t start = Codec::tmToSeconds(trackPoints.front().dateTime);
+      double lastDue = 0;
+
+      for (const TrackPoint& trackPoint : trackPoints)
+      {
+          lastDue = std::max(lastDue, std::difftime(Codec::tmToSeconds(trackPoint.dateTime), start));
+
+          emitter.gga(trackPoint.position, trackPoint.dateTime);
+          log.ends.push_back(emitter.contents().size());
+          log.dueTimes.push_back(lastDue);
+
+          emitter.rmc(trackPoint.position, trackPoint.dateTime);
+          log.ends.push_back(emitter.contents().size());
+          log.dueTimes.push_back(lastDue);
+      }
+      log.sentences = emitter.contents();
+
+      return log;
+  }
+
+  void ReplayLog::append(std::string_view sentence, double dueTime)
+  {
+      sentences += sentence;
+      sentences += "\r\n";
+      ends.push_back(sentences.size());
+      dueTimes.push_back(dueTime);
+  }
+
+  std::string_view ReplayLog::text() const
+  {
+      return sentences;
+  }
+
+  std::size_t ReplayLog::sentenceCount() const
+  {
+      return ends.size();
+  }
+
+  double ReplayLog::duration() const
+  {
+      return dueTimes.empty() ? 0 : dueTimes.back();
+  }
+
+  double ReplayLog::dueTime(std::size_t sentenceIndex) const
+  {
+      return dueTimes.at(sentenceIndex);
+  }
+
+  std::size_t ReplayLog::sentenceEnd(std::size_t sentenceIndex) const
+  {
+      return ends.at(sentenceIndex);
+  }
+
+  std::size_t ReplayLog::sentencesDueBy(double time) const
+  {
+      return std::upper_bound(dueTimes.begin(), dueTimes.end(), time) - dueTimes.begin();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  // Writes per device before moving on to the next, so that no device can monopolise the replay.
+  constexpr std::size_t writesPerTurn = 4;
+  constexpr std::size_t maxWriteSize = 64 * 1024;
+
+  Replayer::Replayer(const ReplayLog& log, double speed, unsigned int repetitions)
+    : log{log},
+      speed{speed},
+      repetitions{repetitions},
+      loopPeriod{log.duration() + 1}
+  {
+      if (! (speed >= 0)) throw std::invalid_argument("The replay speed must not be negative.");
+      if (repetitions == 0) throw std::invalid_argument("The log must be replayed at least once.");
+  }
+
+  Replayer::~Replayer()
+  {
+      for (const Device& device : devices) ::fcntl(device.fd, F_SETFL, device.originalFlags);
+  }
+
+  void Replayer::addDevice(int fd)
+  {
+      const int originalFlags = ::fcntl(fd, F_GETFL);
+      if (originalFlags < 0 || ::fcntl(fd, F_SETFL, originalFlags | O_NONBLOCK) < 0)
+      {
+          throw std::invalid_argument("Cannot write to file descriptor " + std::to_string(fd) + ".");
+      }
+      devices.push_back({fd, originalFlags, Progress{}, 0, false});
+  }
+
+  void Replayer::run(std::chrono::milliseconds stopLatency)
+  {
+      const auto start = std::chrono::steady_clock::now();
+      std::vector<pollfd> blocked;
+
+      while (! stopping)
+      {
+          const double logTime = speed * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+          const Progress due = dueBy(logTime);
+
+          blocked.clear();
+          bool finished = true;
+          bool turnOver = false;
+          for (Device& device : devices)
+          {
+              if (device.dropped) continue;
+
+              const WriteState state = writeDue(device, due);
+              if (state == WriteState::blocked) blocked.push_back({device.fd, POLLOUT, 0});
+              if (state == WriteState::turnOver) turnOver = true;
+
+              if (! device.dropped && device.progress.repetition < repetitions) finished = false;
+          }
+          if (finished) return;
+          if (turnOver) continue;
+
+          // Wait until a blocked device can accept more data, or until more sentences are due.
+          std::chrono::milliseconds timeout = stopLatency;
+          if (speed > 0)
+          {
+              const double wait = (nextDueTime(logTime) - logTime) / speed;
+              if (wait < timeout.count() / 1000.0) timeout = std::chrono::milliseconds(long(std::ceil(wait * 1000)));
+          }
+          ::poll(blocked.data(), blocked.size(), std::max(0L, long(timeout.count())));
+      }
+  }
+
+  void Replayer::stop()
+  {
+      stopping = true;
+  }
+
+  std::uint64_t Replayer::sentencesWritten() const
+  {
+      return sentences;
+  }
+
+  std::size_t Replayer::droppedDevices() const
+  {
+      return dropped;
+  }
+
+  Replayer::Progress Replayer::dueBy(double logTime) const
+  {
+      if (speed == 0) return {repetitions, 0}; // Everything is due at once.
+
+      const double repetition = std::floor(logTime / loopPeriod);
+      if (repetition >= repetitions) return {repetitions, 0};
+
+      const std::size_t dueCount = log.sentencesDueBy(logTime - repetition * loopPeriod);
+      return {static_cast<unsigned int>(repetition), dueCount == 0 ? 0 : log.sentenceEnd(dueCount - 1)};
+  }
+
+  double Replayer::nextDueTime(double logTime) const
+  {
+      constexpr double never = std::numeric_limits<double>::infinity();
+
+      const double repetition = std::floor(logTime / loopPeriod);
+      if (repetition >= repetitions) return never;
+
+      const std::size_t dueCount = log.sentencesDueBy(logTime - repetition * loopPeriod);
+      if (dueCount < log.sentenceCount()) return repetition * loopPeriod + log.dueTime(dueCount);
+      return repetition + 1 < repetitions ? (repetition + 1) * loopPeriod : never;
+  }
+
+  Replayer::WriteState Replayer::writeDue(Device& device, Progress due)
+  {
+      const std::string_view text = log.text();
+      Progress& progress = device.progress;
+
+      for (std::size_t writes = 0; ; )
+      {
+          if (progress.repetition > due.repetition ||
+              (progress.repetition == due.repetition && progress.offset >= due.offset))
+          {
+              return WriteState::caughtUp;
+          }
+
+          const std::size_t end = progress.repetition < due.repetition ? text.size() : due.offset;
+          if (progress.offset == end)
+          {
+              // The end of an earlier repetition.
+              ++progress.repetition;
+              progress.offset = 0;
+              device.nextSentence = 0;
+              continue;
+          }
+
+          if (writes == writesPerTurn) return WriteState::turnOver;
+          ++writes;
+
+          const ssize_t bytesWritten = ::write(device.fd, text.data() + progress.offset,
+                                               std::min(end - progress.offset, maxWriteSize));
+          if (bytesWritten > 0)
+          {
+              progress.offset += bytesWritten;
+              std::uint64_t completed = 0;
+              for (; device.nextSentence < log.sentenceCount() &&
+                     log.sentenceEnd(device.nextSentence) <= progress.offset; ++device.nextSentence)
+              {
+                  ++completed;
+              }
+              sentences.fetch_add(completed, std::memory_order_relaxed);
+          }
+          else if (bytesWritten < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+          {
+              return WriteState::blocked;
+          }
+          else if (bytesWritten < 0 && errno == EINTR)
+          {
+              continue;
+          }
+          else
+          {
+              // EPIPE: the reader has gone away; EIO: the other end of a pseudo-terminal was closed.
+              device.dropped = true;
+              ++dropped;
+              return WriteState::dropped;
+          }
+      }
+  }
+}
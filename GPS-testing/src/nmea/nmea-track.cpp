@@ -0,0 +1,125 @@
+#include <stdexcept>
+#include <cmath>
+#include <string_view>
+
+#include "nmea-parser.h"
+#include "nmea-fusion.h"
+#include "nmea-track.h"
+
+namespace GPS::NMEA
+{
+  bool isLeapYear(unsigned int year)
+  {
+      return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  }
+
+  unsigned int daysInMonth(unsigned int year, unsigned int month)
+  {
+      static const unsigned int days[12] = {31,28,31,30,31,30,31,31,30,31,30,31};
+      return (month == 2 && isLeapYear(year)) ? 29 : days[month-1];
+  }
+
+  Date previousDay(Date date)
+  {
+      if (date.day > 1) return {date.year, date.month, date.day - 1};
+      if (date.month > 1) return {date.year, date.month - 1, daysInMonth(date.year, date.month - 1)};
+      return {date.year - 1, 12, 31};
+  }
+
+  Date nextDay(Date date)
+  {
+      if (date.day < daysInMonth(date.year, date.month)) return {date.year, date.month, date.day + 1};
+      if (date.month < 12) return {date.year, date.month + 1, 1};
+      return {date.year + 1, 1, 1};
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  // A jump back in time of more than this is taken to be a midnight rollover, rather than out-of-order data.
+  const double rolloverThreshold = 12 * 60 * 60;
+
+  void setDateTime(std::tm& dateTime, Date date, double timeOfDay)
+  {
+      const int seconds = static_cast<int>(std::floor(timeOfDay));
+      dateTime = std::tm{};
+      dateTime.tm_year = date.year - 1900;
+      dateTime.tm_mon = date.month - 1;
+      dateTime.tm_mday = date.day;
+      dateTime.tm_hour = seconds / 3600;
+      dateTime.tm_min = seconds / 60 % 60;
+      dateTime.tm_sec = seconds % 60;
+      dateTime.tm_isdst = -1;
+  }
+
+  std::vector<TrackPoint> readTrackPoints(std::istream& input, std::optional<Date> startDate)
+  {
+      std::vector<TrackPoint> trackPoints;
+      std::vector<double> undatedTimes; // The times of the points at the front of 'trackPoints' that precede any date.
+
+      std::optional<Date> currentDate = startDate;
+      double previousTime = 0;
+
+      auto addTrackPoint = [&](const Fix& fix)
+      {
+          if (! fix.timeOfDay) return;
+
+          if (fix.date)
+          {
+              if (! currentDate)
+              {
+                  // Date the earlier points, working backwards from this one.
+                  Date date = *fix.date;
+                  double laterTime = *fix.timeOfDay;
+                  for (std::size_t i = undatedTimes.size(); i-- > 0; )
+                  {
+                      if (undatedTimes[i] > laterTime + rolloverThreshold) date = previousDay(date);
+                      setDateTime(trackPoints[i].dateTime, date, undatedTimes[i]);
+                      laterTime = undatedTimes[i];
+                  }
+                  undatedTimes.clear();
+              }
+              currentDate = fix.date;
+          }
+          else if (currentDate && *fix.timeOfDay + rolloverThreshold < previousTime)
+          {
+              currentDate = nextDay(*currentDate);
+          }
+          previousTime = *fix.timeOfDay;
+
+          if (! fix.position) return;
+
+          trackPoints.push_back({*fix.position, "", std::tm{}});
+          if (currentDate)
+          {
+              setDateTime(trackPoints.back().dateTime, *currentDate, *fix.timeOfDay);
+          }
+          else
+          {
+              undatedTimes.push_back(*fix.timeOfDay);
+          }
+      };
+
+      EpochFuser fuser;
+      std::vector<Fix> fused;
+      SentenceView sentence;
+      Fix fix;
+      forEachLine(input, [&](std::string_view line)
+      {
+          if (! line.empty() && line.back() == '\r') line.remove_suffix(1);
+          if (scanSentence(line, sentence) != ScanResult::valid || ! decodeFix(sentence, fix)) return;
+
+          fuser.add(fix, fused);
+          for (const Fix& epoch : fused) addTrackPoint(epoch);
+          fused.clear();
+      });
+      fuser.flush(fused);
+      for (const Fix& epoch : fused) addTrackPoint(epoch);
+
+      if (! undatedTimes.empty())
+      {
+          throw std::domain_error("The NMEA data contains no dates (RMC or ZDA sentences), and no start date was given.");
+      }
+
+      return trackPoints;
+  }
+}
@@ -5,24 +5,24 @@
 
 #include "geometry.h"
 #include "earth.h"
+#include "haversine.h"
 #include "position.h"
 
 namespace GPS
 {
-  Position::Position(degrees lat, degrees lon, metres ele)
+  void Position::throwInvalidLatitude()
   {
-      if (! isValidLatitude(lat))
-          throw std::invalid_argument("Latitude values must not exceed " + std::to_string(poleLatitude) + " degrees.");
-
-      if (! isValidLongitude(lon))
-          throw std::invalid_argument("Longitude values must not exceed " + std::to_string(antiMeridianLongitude) + " degrees.");
+      throw std::invalid_argument("Latitude values must not exceed " + std::to_string(poleLatitude) + " degrees.");
+  }
 
-      if (! Earth::isValidElevation(ele))
-          throw std::invalid_argument("Negative elevation values must not exceed the Earth's mean radius (i.e. must not be below the centre of the Earth).");
+  void Position::throwInvalidLongitude()
+  {
+      throw std::invalid_argument("Longitude values must not exceed " + std::to_string(antiMeridianLongitude) + " degrees.");
+  }
 
-      this->lat = lat;
-      this->lon = lon;
-      this->ele = ele;
+  void Position::throwInvalidElevation()
+  {
+      throw std::invalid_argument("Negative elevation values must not exceed the Earth's mean radius (i.e. must not be below the centre of the Earth).");
   }
 
   Position::Position(std::string ddmLatStr, char latBearing,
@@ -52,33 +52,29 @@ namespace GPS
 
   }
 
-  degrees Position::latitude() const
+  metres Position::horizontalDistanceBetween(Position p1, Position p2)
   {
-      return lat;
+      return haversineDistance(p1.latitude(), p1.longitude(), p2.latitude(), p2.longitude());
   }
 
-  degrees Position::longitude() const
+  metres Position::horizontalDistanceBetween(const GeodeticPoint& p1, const GeodeticPoint& p2)
   {
-      return lon;
+      return haversineDistance(p1, p2);
   }
 
-  metres Position::elevation() const
-  {
-      return ele;
-  }
+  GeodeticPoint::GeodeticPoint(const Position& position)
+    : GeodeticPoint(degToRad(position.latitude()), degToRad(position.longitude()))
+  {}
 
-  metres Position::horizontalDistanceBetween(Position p1, Position p2)
-  /*
-   * See: https://en.wikipedia.org/wiki/Haversine_formula
-   */
-  {
-      const radians lat1 = degToRad(p1.latitude());
-      const radians lat2 = degToRad(p2.latitude());
-      const radians lon1 = degToRad(p1.longitude());
-      const radians lon2 = degToRad(p2.longitude());
+  GeodeticPoint::GeodeticPoint(radians lat, radians lon)
+    : lat{lat},
+      lon{lon},
+      cosLat{std::cos(lat)}
+  {}
 
-      double h = sinSqr((lat2-lat1)/2) + std::cos(lat1)*std::cos(lat2)*sinSqr((lon2-lon1)/2);
-      return 2 * Earth::meanRadius * std::asin(std::sqrt(h));
+  GeodeticPoint GeodeticPoint::fromDegrees(degrees lat, degrees lon)
+  {
+      return GeodeticPoint(degToRad(lat), degToRad(lon));
   }
 
   degrees ddmTodd(std::string ddmStr)
@@ -88,4 +84,72 @@ namespace GPS
       double mins = ddm - 100 * degs;
       return degs + mins / minutesPerDegree; // converts minutes to decimal fractions of a degree
   }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  const std::size_t maxDDMFractionDigits = 11; // So that the numerator in decodeDDM() is exact in a double.
+
+  const std::uint64_t powersOfTen[] =
+      {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000, 10000000000, 100000000000};
+
+  /* Split a DDM string into whole degrees, and minutes scaled up by 10^(number of fraction digits),
+   * e.g. "5425.31" gives 54 degrees and 2531 hundredths of a minute.
+   */
+  bool parseDDMDigits(std::string_view ddm, std::uint64_t& degs, std::uint64_t& scaledMins, std::size_t& fractionDigits)
+  {
+      const std::size_t point = ddm.find('.');
+      const std::string_view whole = ddm.substr(0, point);
+      const std::string_view fraction = point == std::string_view::npos ? std::string_view{} : ddm.substr(point + 1);
+      if (whole.empty() || whole.size() > 5) return false;
+
+      std::uint64_t wholeValue = 0;
+      for (char c : whole)
+      {
+          if (c < '0' || c > '9') return false;
+          wholeValue = 10 * wholeValue + (c - '0');
+      }
+
+      degs = wholeValue / 100;
+      scaledMins = wholeValue % 100;
+      if (scaledMins >= minutesPerDegree) return false;
+
+      fractionDigits = 0;
+      for (char c : fraction)
+      {
+          if (c < '0' || c > '9') return false;
+          if (fractionDigits == maxDDMFractionDigits) continue;
+          scaledMins = 10 * scaledMins + (c - '0');
+          ++fractionDigits;
+      }
+      return true;
+  }
+
+  bool decodeDDM(std::string_view ddm, degrees& dd)
+  {
+      std::uint64_t degs, scaledMins;
+      std::size_t fractionDigits;
+      if (! parseDDMDigits(ddm, degs, scaledMins, fractionDigits)) return false;
+
+      // Both are integers below 2^53, so exact as doubles, and the division is correctly rounded.
+      const std::uint64_t denominator = 60 * powersOfTen[fractionDigits];
+      dd = double(degs * denominator + scaledMins) / double(denominator);
+      return true;
+  }
+
+  bool decodeDDME7(std::string_view ddm, std::int64_t& e7)
+  {
+      std::uint64_t degs, scaledMins;
+      std::size_t fractionDigits;
+      if (! parseDDMDigits(ddm, degs, scaledMins, fractionDigits)) return false;
+
+      // The fraction of a degree in units of 10^-7 is scaledMins * 10^7 / (60 * 10^fractionDigits), rounded;
+      // the powers of ten are cancelled first, so that nothing overflows.
+      std::uint64_t numerator = scaledMins;
+      std::uint64_t denominator = 60;
+      if (fractionDigits <= 7) numerator *= powersOfTen[7 - fractionDigits];
+      else denominator *= powersOfTen[fractionDigits - 7];
+
+      e7 = static_cast<std::int64_t>(degs * 10000000 + (numerator + denominator / 2) / denominator);
+      return true;
+  }
 }
@@ -73,4 +73,9 @@ LeafContent Element::getLeafContent() const
     return leafContent;
 }
 
+const SubElements& Element::getAllSubElements() const
+{
+    return subElements;
+}
+
 }
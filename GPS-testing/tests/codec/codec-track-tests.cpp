@@ -0,0 +1,173 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include "types.h"
+#include "waypoints.h"
+#include "codec-track.h"
+#include "analysis-track.h"
+#include "gridworld-track.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( Codec_Track )
+
+const metres gridUnit = 1000;
+const GridWorld::Model gwNearEquator {Earth::Pontianak,gridUnit,gridUnit,gridUnit};
+
+const Codec::Resolution defaultResolution {};
+const double angleTolerance = defaultResolution.angle;
+const double elevationTolerance = defaultResolution.elevation;
+
+std::vector<TrackPoint> exampleTrack()
+{
+    return GridWorld::Track("A1B5Q1W6E2Y3M10M7A",gwNearEquator).toTrackPoints();
+}
+
+void checkPointsMatch(const std::vector<TrackPoint>& actual, const std::vector<TrackPoint>& expected)
+{
+    BOOST_REQUIRE_EQUAL( actual.size(), expected.size() );
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+        BOOST_CHECK_SMALL( actual[i].position.latitude() - expected[i].position.latitude(), angleTolerance );
+        BOOST_CHECK_SMALL( actual[i].position.longitude() - expected[i].position.longitude(), angleTolerance );
+        BOOST_CHECK_SMALL( actual[i].position.elevation() - expected[i].position.elevation(), elevationTolerance );
+        BOOST_CHECK_EQUAL( Codec::tmToSeconds(actual[i].dateTime), Codec::tmToSeconds(expected[i].dateTime) );
+    }
+}
+
+// Typical case: a track survives an encode/decode round trip to within the quantization resolution.
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    const std::vector<TrackPoint> trackPoints = exampleTrack();
+
+    Codec::Bytes encoded = Codec::encodeTrack(trackPoints);
+    std::vector<TrackPoint> decoded = Codec::TrackDecoder(encoded).toTrackPoints();
+
+    checkPointsMatch(decoded, trackPoints);
+}
+
+// Multiple blocks must decode to the same points as a single block, and each block on its own.
+BOOST_AUTO_TEST_CASE( IndependentBlocks )
+{
+    const std::vector<TrackPoint> trackPoints = exampleTrack();
+    const unsigned int pointsPerBlock = 3;
+
+    Codec::Bytes encoded = Codec::encodeTrack(trackPoints, defaultResolution, pointsPerBlock);
+    Codec::TrackDecoder decoder {encoded};
+
+    BOOST_REQUIRE_EQUAL( decoder.numPoints(), trackPoints.size() );
+    BOOST_REQUIRE_EQUAL( decoder.numBlocks(), (trackPoints.size() + pointsPerBlock - 1) / pointsPerBlock );
+
+    // Decode the last block first, to show it does not depend on its predecessors.
+    Codec::Columns lastBlock;
+    decoder.decodeBlock(decoder.numBlocks() - 1, lastBlock);
+    const std::size_t firstIndexOfLastBlock = (decoder.numBlocks() - 1) * pointsPerBlock;
+    BOOST_REQUIRE_EQUAL( lastBlock.size(), trackPoints.size() - firstIndexOfLastBlock );
+    BOOST_CHECK_SMALL( lastBlock.latitudes[0] - trackPoints[firstIndexOfLastBlock].position.latitude(), angleTolerance );
+    BOOST_CHECK_SMALL( lastBlock.longitudes[0] - trackPoints[firstIndexOfLastBlock].position.longitude(), angleTolerance );
+
+    checkPointsMatch(decoder.toTrackPoints(), trackPoints);
+}
+
+// Decoded points can be streamed straight into the analysis classes.
+BOOST_AUTO_TEST_CASE( AnalysisOfDecodedTrack )
+{
+    const std::vector<TrackPoint> trackPoints = exampleTrack();
+    const Analysis::Track original {trackPoints};
+
+    const Analysis::Track decoded {Codec::TrackDecoder(Codec::encodeTrack(trackPoints)).toTrackPoints()};
+
+    BOOST_CHECK_EQUAL( decoded.totalTime().count(), original.totalTime().count() );
+    BOOST_CHECK_CLOSE( decoded.totalLength(), original.totalLength(), 0.0001 );
+}
+
+// Consecutive fixes of a real track should cost only a few bytes each.
+BOOST_AUTO_TEST_CASE( CompressionRatio )
+{
+    Codec::TrackEncoder encoder;
+    const unsigned int numPoints = 10000;
+    for (unsigned int i = 0; i < numPoints; ++i)
+    {
+        encoder.add(52.9 + i * 1e-5, -1.18 + i * 2e-5, 58 + (i % 10) * 0.1, 1600000000 + i);
+    }
+
+    Codec::Bytes encoded = encoder.finish();
+
+    BOOST_CHECK_LT( encoded.size(), numPoints * 8 );
+    BOOST_CHECK_EQUAL( Codec::TrackDecoder(encoded).numPoints(), numPoints );
+}
+
+BOOST_AUTO_TEST_CASE( EmptyTrack )
+{
+    Codec::Bytes encoded = Codec::encodeTrack({});
+    Codec::TrackDecoder decoder {encoded};
+
+    BOOST_CHECK_EQUAL( decoder.numBlocks(), 0 );
+    BOOST_CHECK_EQUAL( decoder.numPoints(), 0 );
+    BOOST_CHECK( decoder.toTrackPoints().empty() );
+}
+
+BOOST_AUTO_TEST_CASE( CustomResolution )
+{
+    const Codec::Resolution coarse {0.001, 1};
+    Codec::TrackEncoder encoder {coarse};
+    encoder.add(10.0004, 20.0006, 100.4, 0);
+
+    Codec::TrackDecoder decoder {encoder.finish()};
+    Codec::Columns columns;
+    decoder.decodeAll(columns);
+
+    BOOST_CHECK_CLOSE( decoder.resolution().angle, coarse.angle, 0.0001 );
+    BOOST_REQUIRE_EQUAL( columns.size(), 1 );
+    BOOST_CHECK_CLOSE( columns.latitudes[0], 10.000, 0.0001 );
+    BOOST_CHECK_CLOSE( columns.longitudes[0], 20.001, 0.0001 );
+    BOOST_CHECK_CLOSE( columns.elevations[0], 100, 0.0001 );
+}
+
+BOOST_AUTO_TEST_CASE( TimeConversions )
+{
+    std::tm dateTime {};
+    dateTime.tm_year = 2020 - 1900;
+    dateTime.tm_mon = 2;
+    dateTime.tm_mday = 23;
+    dateTime.tm_hour = 13;
+    dateTime.tm_min = 0;
+    dateTime.tm_sec = 1;
+
+    const std::time_t seconds = Codec::tmToSeconds(dateTime);
+    const std::tm roundTrip = Codec::secondsToTm(seconds);
+
+    BOOST_CHECK_EQUAL( seconds, 1584968401 );
+    BOOST_CHECK_EQUAL( roundTrip.tm_year, dateTime.tm_year );
+    BOOST_CHECK_EQUAL( roundTrip.tm_mon, dateTime.tm_mon );
+    BOOST_CHECK_EQUAL( roundTrip.tm_mday, dateTime.tm_mday );
+    BOOST_CHECK_EQUAL( roundTrip.tm_hour, dateTime.tm_hour );
+    BOOST_CHECK_EQUAL( roundTrip.tm_min, dateTime.tm_min );
+    BOOST_CHECK_EQUAL( roundTrip.tm_sec, dateTime.tm_sec );
+    BOOST_CHECK_EQUAL( roundTrip.tm_wday, 1 ); // Monday
+}
+
+BOOST_AUTO_TEST_CASE( InvalidResolution )
+{
+    BOOST_CHECK_THROW( Codec::TrackEncoder(Codec::Resolution{0, 1}), std::invalid_argument );
+    BOOST_CHECK_THROW( Codec::TrackEncoder(Codec::Resolution{1e-7, -1}), std::invalid_argument );
+    BOOST_CHECK_THROW( Codec::TrackEncoder(defaultResolution, 0), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( MalformedData )
+{
+    Codec::Bytes encoded = Codec::encodeTrack(exampleTrack());
+
+    Codec::Bytes badMagic = encoded;
+    badMagic[0] = 'X';
+    BOOST_CHECK_THROW( Codec::TrackDecoder{badMagic}, std::domain_error );
+
+    Codec::Bytes truncated {encoded.begin(), encoded.end() - 1};
+    BOOST_CHECK_THROW( Codec::TrackDecoder{truncated}, std::domain_error );
+
+    BOOST_CHECK_THROW( Codec::TrackDecoder(Codec::Bytes{}), std::domain_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
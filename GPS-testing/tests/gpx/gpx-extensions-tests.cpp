@@ -0,0 +1,139 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include "dataFiles.h"
+#include "gpx-parser.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( GPX_SensorExtensions )
+
+const double percentageTolerance = 0.000001;
+
+// Sensor fields nested inside a Garmin TrackPointExtension, and directly under <extensions>, are both found.
+BOOST_AUTO_TEST_CASE( GarminExtensionsFile )
+{
+    const std::string filepath = DataFiles::GPXTracksDir + "ThreePointTrack-Extensions.gpx";
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open log file: " + filepath + "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::fstream gpxData {filepath};
+    GPX::SensorColumns sensors {GPX::garminSensorFields};
+
+    std::vector<TrackPoint> trackPoints = GPX::parseTrack(gpxData, sensors);
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 3 );
+    const std::size_t hr = sensors.fieldIndex("hr");
+    const std::size_t cad = sensors.fieldIndex("cad");
+    const std::size_t power = sensors.fieldIndex("power");
+    const std::size_t atemp = sensors.fieldIndex("atemp");
+
+    for (std::size_t field = 0; field < sensors.fieldNames.size(); ++field)
+    {
+        BOOST_REQUIRE_EQUAL( sensors.values[field].size(), trackPoints.size() );
+        BOOST_REQUIRE_EQUAL( sensors.valid[field].size(), trackPoints.size() );
+    }
+
+    BOOST_CHECK( sensors.valid[hr][0] );
+    BOOST_CHECK_CLOSE( sensors.values[hr][0], 121, percentageTolerance );
+    BOOST_CHECK( sensors.valid[cad][0] );
+    BOOST_CHECK_CLOSE( sensors.values[cad][0], 85, percentageTolerance );
+    BOOST_CHECK( sensors.valid[power][0] );
+    BOOST_CHECK_CLOSE( sensors.values[power][0], 210, percentageTolerance );
+    BOOST_CHECK( sensors.valid[atemp][0] );
+    BOOST_CHECK_CLOSE( sensors.values[atemp][0], 21.5, percentageTolerance );
+
+    // Second point: no cadence or power.
+    BOOST_CHECK( sensors.valid[hr][1] );
+    BOOST_CHECK_CLOSE( sensors.values[hr][1], 125, percentageTolerance );
+    BOOST_CHECK( ! sensors.valid[cad][1] );
+    BOOST_CHECK( ! sensors.valid[power][1] );
+
+    // Third point: no extensions at all.
+    for (std::size_t field = 0; field < sensors.fieldNames.size(); ++field)
+    {
+        BOOST_CHECK( ! sensors.valid[field][2] );
+    }
+}
+
+// Only the requested fields are extracted, and prefixed or unprefixed names both match.
+BOOST_AUTO_TEST_CASE( SelectedFields )
+{
+    std::stringstream gpxData
+      {"<gpx><trk><trkpt lat=\"0\" lon=\"0\"><time>2020-03-23T13:00:01Z</time><extensions><ns3:hr>99</ns3:hr><ns3:cad>60</ns3:cad></extensions></trkpt></trk></gpx>"};
+    GPX::SensorColumns sensors {{"gpxtpx:hr"}};
+
+    std::vector<TrackPoint> trackPoints = GPX::parseTrack(gpxData, sensors);
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 1 );
+    BOOST_REQUIRE_EQUAL( sensors.values.size(), 1 );
+    BOOST_CHECK( sensors.valid[0][0] );
+    BOOST_CHECK_CLOSE( sensors.values[0][0], 99, percentageTolerance );
+}
+
+BOOST_AUTO_TEST_CASE( NonNumericValueIsInvalid )
+{
+    std::stringstream gpxData
+      {"<gpx><trk><trkpt lat=\"0\" lon=\"0\"><time>2020-03-23T13:00:01Z</time><extensions><hr>fast</hr></extensions></trkpt></trk></gpx>"};
+    GPX::SensorColumns sensors {{"hr"}};
+
+    GPX::parseTrack(gpxData, sensors);
+
+    BOOST_REQUIRE_EQUAL( sensors.valid[0].size(), 1 );
+    BOOST_CHECK( ! sensors.valid[0][0] );
+}
+
+// In lenient mode, the sensor columns stay aligned with the accepted points only.
+BOOST_AUTO_TEST_CASE( AlignedWithLenientParse )
+{
+    std::stringstream gpxData
+      {"<gpx><trk>"
+       "<trkpt lat=\"0\" lon=\"0\"><time>2020-03-23T13:00:01Z</time><extensions><hr>100</hr></extensions></trkpt>"
+       "<trkpt lat=\"99\" lon=\"0\"><time>2020-03-23T13:00:02Z</time><extensions><hr>101</hr></extensions></trkpt>"
+       "<trkpt lat=\"0\" lon=\"0\"><time>2020-03-23T13:00:03Z</time><extensions><hr>102</hr></extensions></trkpt>"
+       "</trk></gpx>"};
+    GPX::ParseReport report;
+    GPX::SensorColumns sensors {{"hr"}};
+
+    std::vector<TrackPoint> trackPoints = GPX::parseTrackLenient(gpxData, report, sensors);
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 2 );
+    BOOST_REQUIRE_EQUAL( sensors.values[0].size(), 2 );
+    BOOST_CHECK_CLOSE( sensors.values[0][0], 100, percentageTolerance );
+    BOOST_CHECK_CLOSE( sensors.values[0][1], 102, percentageTolerance );
+    BOOST_CHECK_EQUAL( report.rejectedPoints.size(), 1 );
+}
+
+// Parsing a second track replaces the columns from the first, rather than appending to them.
+BOOST_AUTO_TEST_CASE( ReusedColumns )
+{
+    std::stringstream firstTrack
+      {"<gpx><trk><trkpt lat=\"0\" lon=\"0\"><time>2020-03-23T13:00:01Z</time><extensions><hr>100</hr></extensions></trkpt>"
+       "<trkpt lat=\"0\" lon=\"0\"><time>2020-03-23T13:00:02Z</time><extensions><hr>101</hr></extensions></trkpt></trk></gpx>"};
+    std::stringstream secondTrack
+      {"<gpx><trk><trkpt lat=\"0\" lon=\"0\"><time>2020-03-23T13:00:01Z</time><extensions><hr>120</hr></extensions></trkpt></trk></gpx>"};
+    GPX::SensorColumns sensors {{"hr"}};
+
+    GPX::parseTrack(firstTrack, sensors);
+    GPX::parseTrack(secondTrack, sensors);
+
+    BOOST_REQUIRE_EQUAL( sensors.values[0].size(), 1 );
+    BOOST_REQUIRE_EQUAL( sensors.valid[0].size(), 1 );
+    BOOST_CHECK_CLOSE( sensors.values[0][0], 120, percentageTolerance );
+
+    // The columns are assignable, so can be replaced by a set for different fields.
+    sensors = GPX::SensorColumns {GPX::garminSensorFields};
+    BOOST_CHECK_EQUAL( sensors.values.size(), GPX::garminSensorFields.size() );
+}
+
+BOOST_AUTO_TEST_CASE( UnknownFieldName )
+{
+    GPX::SensorColumns sensors {{"hr"}};
+
+    BOOST_CHECK_THROW( sensors.fieldIndex("cad"), std::out_of_range );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
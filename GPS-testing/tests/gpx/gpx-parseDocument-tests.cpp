@@ -0,0 +1,131 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include "dataFiles.h"
+#include "gpx-parser.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( GPX_ParseDocument )
+
+const double percentageTolerance = 0.000001;
+
+BOOST_AUTO_TEST_CASE( MultipleFeaturesFile )
+{
+    const std::string filepath = DataFiles::GPXTracksDir + "MultipleFeatures.gpx";
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open log file: " + filepath + "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::fstream gpxData {filepath};
+
+    GPX::Document document = GPX::parseDocument(gpxData);
+
+    BOOST_REQUIRE_EQUAL( document.points.size(), 12 );
+    BOOST_CHECK_EQUAL( document.times.size(), document.points.size() );
+    BOOST_CHECK_EQUAL( document.hasTime.size(), document.points.size() );
+
+    // Waypoints
+    BOOST_REQUIRE_EQUAL( document.waypoints.size(), 2 );
+    BOOST_CHECK_EQUAL( document.points[document.waypoints.begin].name, "Start" );
+    BOOST_CHECK( document.hasTime[document.waypoints.begin] );
+    BOOST_CHECK_EQUAL( document.times[document.waypoints.begin].tm_year, 100 );
+    BOOST_CHECK_EQUAL( document.points[document.waypoints.begin + 1].name, "Finish" );
+    BOOST_CHECK( ! document.hasTime[document.waypoints.begin + 1] );
+
+    // Routes
+    BOOST_REQUIRE_EQUAL( document.routes.size(), 2 );
+    BOOST_CHECK_EQUAL( document.routes[0].name, "Outward" );
+    BOOST_CHECK_EQUAL( document.routes[0].points.size(), 2 );
+    BOOST_CHECK_EQUAL( document.routes[1].name, "Return" );
+    BOOST_CHECK_EQUAL( document.routes[1].points.size(), 3 );
+    std::vector<RoutePoint> returnRoute = document.routePoints(1);
+    BOOST_REQUIRE_EQUAL( returnRoute.size(), 3 );
+    BOOST_CHECK_CLOSE( returnRoute[1].position.latitude(), 1.5, percentageTolerance );
+    BOOST_CHECK_CLOSE( returnRoute[1].position.longitude(), 15, percentageTolerance );
+
+    // Tracks
+    BOOST_REQUIRE_EQUAL( document.tracks.size(), 2 );
+    BOOST_CHECK_EQUAL( document.tracks[0].name, "Morning" );
+    BOOST_REQUIRE_EQUAL( document.tracks[0].segments.size(), 2 );
+    BOOST_CHECK_EQUAL( document.tracks[0].segments[0].size(), 2 );
+    BOOST_CHECK_EQUAL( document.tracks[0].segments[1].size(), 1 );
+    BOOST_CHECK_EQUAL( document.tracks[0].points().size(), 3 );
+    BOOST_CHECK_EQUAL( document.tracks[1].name, "Afternoon" );
+    BOOST_REQUIRE_EQUAL( document.tracks[1].segments.size(), 1 );
+
+    std::vector<TrackPoint> afternoon = document.trackPoints(1);
+    BOOST_REQUIRE_EQUAL( afternoon.size(), 2 );
+    BOOST_CHECK_CLOSE( afternoon[1].position.latitude(), -8, percentageTolerance );
+    BOOST_CHECK_EQUAL( afternoon[1].dateTime.tm_hour, 13 );
+    BOOST_CHECK_EQUAL( afternoon[1].dateTime.tm_min, 1 );
+}
+
+// The same points are obtained as from parsing the first route or track on its own.
+BOOST_AUTO_TEST_CASE( ConsistentWithSingleFeatureParsers )
+{
+    const std::string filepath = DataFiles::GPXTracksDir + "MultipleFeatures.gpx";
+    std::fstream documentData {filepath};
+    std::fstream routeData {filepath};
+    std::fstream trackData {filepath};
+
+    GPX::Document document = GPX::parseDocument(documentData);
+    std::vector<RoutePoint> route = GPX::parseRoute(routeData);
+    std::vector<TrackPoint> track = GPX::parseTrack(trackData);
+
+    std::vector<RoutePoint> documentRoute = document.routePoints(0);
+    BOOST_REQUIRE_EQUAL( documentRoute.size(), route.size() );
+    for (std::size_t i = 0; i < route.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( documentRoute[i].position.latitude(), route[i].position.latitude() );
+        BOOST_CHECK_EQUAL( documentRoute[i].position.elevation(), route[i].position.elevation() );
+    }
+
+    std::vector<TrackPoint> documentTrack = document.trackPoints(0);
+    BOOST_REQUIRE_EQUAL( documentTrack.size(), track.size() );
+    for (std::size_t i = 0; i < track.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( documentTrack[i].position.longitude(), track[i].position.longitude() );
+        BOOST_CHECK_EQUAL( documentTrack[i].dateTime.tm_min, track[i].dateTime.tm_min );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( EmptyDocument )
+{
+    std::stringstream gpxData {"<gpx></gpx>"};
+
+    GPX::Document document = GPX::parseDocument(gpxData);
+
+    BOOST_CHECK( document.points.empty() );
+    BOOST_CHECK_EQUAL( document.waypoints.size(), 0 );
+    BOOST_CHECK( document.routes.empty() );
+    BOOST_CHECK( document.tracks.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( IndexOutOfRange )
+{
+    std::stringstream gpxData {"<gpx><rte><rtept lat=\"0\" lon=\"0\"></rtept></rte></gpx>"};
+
+    GPX::Document document = GPX::parseDocument(gpxData);
+
+    BOOST_CHECK_THROW( document.routePoints(1), std::out_of_range );
+    BOOST_CHECK_THROW( document.trackPoints(0), std::out_of_range );
+}
+
+BOOST_AUTO_TEST_CASE( TrackPointWithoutTime )
+{
+    std::stringstream gpxData {"<gpx><trk><trkpt lat=\"0\" lon=\"0\"></trkpt></trk></gpx>"};
+
+    BOOST_CHECK_THROW( GPX::parseDocument(gpxData), std::domain_error );
+}
+
+BOOST_AUTO_TEST_CASE( MissingGpxElement )
+{
+    std::stringstream gpxData {"<rte><rtept lat=\"0\" lon=\"0\"></rtept></rte>"};
+
+    BOOST_CHECK_THROW( GPX::parseDocument(gpxData), std::domain_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <sstream>
+
+#include "gpx-parser.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( GPX_parseTrackLenient )
+
+const metres percentageTolerance = 0.000001;
+
+const std::string validTrkpt = "<trkpt lat=\"20\" lon=\"70\"><ele>250</ele><time>2020-03-23T13:00:01Z</time></trkpt>";
+
+std::string trackOf(std::string trkpts)
+{
+    return "<gpx><trk>" + trkpts + "</trk></gpx>";
+}
+
+void checkSingleRejection(std::string badTrkpt, GPX::PointError expectedReason)
+{
+    std::stringstream gpxData {trackOf(validTrkpt + badTrkpt + validTrkpt)};
+    GPX::ParseReport report;
+
+    std::vector<TrackPoint> trackPoints = GPX::parseTrackLenient(gpxData, report);
+
+    BOOST_CHECK_EQUAL( trackPoints.size(), 2 );
+    BOOST_REQUIRE_EQUAL( report.rejectedPoints.size(), 1 );
+    BOOST_CHECK_EQUAL( report.rejectedPoints[0].index, 1 );
+    BOOST_CHECK( report.rejectedPoints[0].reason == expectedReason );
+}
+
+// A clean track parses exactly as it would strictly, with nothing reported.
+BOOST_AUTO_TEST_CASE( CleanTrack )
+{
+    std::stringstream gpxData {trackOf(validTrkpt + validTrkpt)};
+    GPX::ParseReport report;
+
+    std::vector<TrackPoint> trackPoints = GPX::parseTrackLenient(gpxData, report);
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 2 );
+    BOOST_CHECK( report.rejectedPoints.empty() );
+    BOOST_CHECK_CLOSE( trackPoints[0].position.latitude(), 20, percentageTolerance );
+    BOOST_CHECK_CLOSE( trackPoints[0].position.longitude(), 70, percentageTolerance );
+    BOOST_CHECK_CLOSE( trackPoints[0].position.elevation(), 250, percentageTolerance );
+    BOOST_CHECK_EQUAL( trackPoints[0].dateTime.tm_year, 2020 - 1900 );
+    BOOST_CHECK_EQUAL( trackPoints[0].dateTime.tm_mon, 2 );
+    BOOST_CHECK_EQUAL( trackPoints[0].dateTime.tm_mday, 23 );
+    BOOST_CHECK_EQUAL( trackPoints[0].dateTime.tm_sec, 1 );
+}
+
+BOOST_AUTO_TEST_CASE( MissingAttributes )
+{
+    checkSingleRejection("<trkpt lon=\"70\"><time>2020-03-23T13:00:01Z</time></trkpt>", GPX::PointError::missingLatitude);
+    checkSingleRejection("<trkpt lat=\"20\"><time>2020-03-23T13:00:01Z</time></trkpt>", GPX::PointError::missingLongitude);
+}
+
+BOOST_AUTO_TEST_CASE( MalformedNumbers )
+{
+    checkSingleRejection("<trkpt lat=\"north\" lon=\"70\"><time>2020-03-23T13:00:01Z</time></trkpt>", GPX::PointError::malformedLatitude);
+    checkSingleRejection("<trkpt lat=\"20\" lon=\"70x\"><time>2020-03-23T13:00:01Z</time></trkpt>", GPX::PointError::malformedLongitude);
+    checkSingleRejection("<trkpt lat=\"20\" lon=\"70\"><ele>high</ele><time>2020-03-23T13:00:01Z</time></trkpt>", GPX::PointError::malformedElevation);
+}
+
+BOOST_AUTO_TEST_CASE( OutOfRangeValues )
+{
+    checkSingleRejection("<trkpt lat=\"91\" lon=\"70\"><time>2020-03-23T13:00:01Z</time></trkpt>", GPX::PointError::invalidLatitude);
+    checkSingleRejection("<trkpt lat=\"20\" lon=\"-181\"><time>2020-03-23T13:00:01Z</time></trkpt>", GPX::PointError::invalidLongitude);
+    checkSingleRejection("<trkpt lat=\"20\" lon=\"70\"><ele>-7000000</ele><time>2020-03-23T13:00:01Z</time></trkpt>", GPX::PointError::invalidElevation);
+}
+
+BOOST_AUTO_TEST_CASE( BadTimes )
+{
+    checkSingleRejection("<trkpt lat=\"20\" lon=\"70\"></trkpt>", GPX::PointError::missingTime);
+    checkSingleRejection("<trkpt lat=\"20\" lon=\"70\"><time>yesterday</time></trkpt>", GPX::PointError::malformedTime);
+    checkSingleRejection("<trkpt lat=\"20\" lon=\"70\"><time>2020-13-23T13:00:01Z</time></trkpt>", GPX::PointError::malformedTime);
+    checkSingleRejection("<trkpt lat=\"20\" lon=\"70\"><time>2020-03-23T13:00:01</time></trkpt>", GPX::PointError::malformedTime);
+}
+
+// Fractional seconds are common in device output; they are accepted and discarded.
+BOOST_AUTO_TEST_CASE( FractionalSeconds )
+{
+    std::stringstream gpxData {trackOf("<trkpt lat=\"20\" lon=\"70\"><time> 2020-03-23T13:00:01.250Z </time></trkpt>")};
+    GPX::ParseReport report;
+
+    std::vector<TrackPoint> trackPoints = GPX::parseTrackLenient(gpxData, report);
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 1 );
+    BOOST_CHECK( report.rejectedPoints.empty() );
+    BOOST_CHECK_EQUAL( trackPoints[0].dateTime.tm_sec, 1 );
+}
+
+// Indices count across segments, so that rejected points can be located in the original file.
+BOOST_AUTO_TEST_CASE( IndicesAcrossSegments )
+{
+    const std::string badTrkpt = "<trkpt lat=\"20\" lon=\"70\"></trkpt>";
+    std::stringstream gpxData {trackOf("<trkseg>" + validTrkpt + badTrkpt + "</trkseg><trkseg>" + badTrkpt + validTrkpt + validTrkpt + "</trkseg>")};
+    GPX::ParseReport report;
+
+    std::vector<TrackPoint> trackPoints = GPX::parseTrackLenient(gpxData, report);
+
+    BOOST_CHECK_EQUAL( trackPoints.size(), 3 );
+    BOOST_REQUIRE_EQUAL( report.rejectedPoints.size(), 2 );
+    BOOST_CHECK_EQUAL( report.rejectedPoints[0].index, 1 );
+    BOOST_CHECK_EQUAL( report.rejectedPoints[1].index, 2 );
+}
+
+// Problems with the document as a whole still abandon the parse.
+BOOST_AUTO_TEST_CASE( UnusableDocuments )
+{
+    GPX::ParseReport report;
+
+    std::stringstream missingTrk {"<gpx></gpx>"};
+    BOOST_CHECK_THROW( GPX::parseTrackLenient(missingTrk, report), std::domain_error );
+
+    std::stringstream malformedXML {"<gpx><trk>" + validTrkpt + "</gpx>"};
+    BOOST_CHECK_THROW( GPX::parseTrackLenient(malformedXML, report), std::domain_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
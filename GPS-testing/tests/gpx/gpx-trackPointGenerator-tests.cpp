@@ -0,0 +1,195 @@
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#include <unistd.h>
+
+#include "dataFiles.h"
+#include "gpx-parser.h"
+#include "io-events.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( GPX_TrackPointGenerator )
+
+std::string readGPXTrackFile(std::string filename)
+{
+    const std::string filepath = DataFiles::GPXTracksDir + filename;
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open log file: " + filepath + "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::ifstream file {filepath, std::ios::binary};
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Writes the data in pieces of the given size, pausing between them, as an upload would arrive.
+void uploadInPieces(int fd, const std::string& data, std::size_t pieceSize, std::chrono::microseconds pause)
+{
+    for (std::size_t start = 0; start < data.size(); start += pieceSize)
+    {
+        const std::string piece = data.substr(start, pieceSize);
+        for (std::size_t written = 0; written < piece.size(); )
+        {
+            const ssize_t n = ::write(fd, piece.data() + written, piece.size() - written);
+            if (n > 0) written += n;
+        }
+        if (pause.count() > 0) std::this_thread::sleep_for(pause);
+    }
+}
+
+// Parses the complete data through a pipe.
+std::vector<TrackPoint> generateAll(const std::string& data)
+{
+    int pipeFds[2];
+    BOOST_REQUIRE( ::pipe(pipeFds) == 0 );
+    std::thread writer([&] { uploadInPieces(pipeFds[1], data, 64, std::chrono::microseconds(0)); ::close(pipeFds[1]); });
+
+    std::vector<TrackPoint> points;
+    try
+    {
+        GPX::TrackPointGenerator generator {pipeFds[0]};
+        while (! generator.ended())
+        {
+            while (std::optional<TrackPoint> point = generator.next()) points.push_back(*point);
+        }
+    }
+    catch (...)
+    {
+        writer.join();
+        ::close(pipeFds[0]);
+        throw;
+    }
+    writer.join();
+    ::close(pipeFds[0]);
+    return points;
+}
+
+void checkSamePoints(const std::vector<TrackPoint>& actual, const std::vector<TrackPoint>& expected)
+{
+    BOOST_REQUIRE_EQUAL( actual.size(), expected.size() );
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( actual[i].position.latitude(), expected[i].position.latitude() );
+        BOOST_CHECK_EQUAL( actual[i].position.longitude(), expected[i].position.longitude() );
+        BOOST_CHECK_EQUAL( actual[i].position.elevation(), expected[i].position.elevation() );
+        BOOST_CHECK_EQUAL( actual[i].name, expected[i].name );
+        BOOST_CHECK_EQUAL( actual[i].dateTime.tm_year, expected[i].dateTime.tm_year );
+        BOOST_CHECK_EQUAL( actual[i].dateTime.tm_mon, expected[i].dateTime.tm_mon );
+        BOOST_CHECK_EQUAL( actual[i].dateTime.tm_mday, expected[i].dateTime.tm_mday );
+        BOOST_CHECK_EQUAL( actual[i].dateTime.tm_hour, expected[i].dateTime.tm_hour );
+        BOOST_CHECK_EQUAL( actual[i].dateTime.tm_min, expected[i].dateTime.tm_min );
+        BOOST_CHECK_EQUAL( actual[i].dateTime.tm_sec, expected[i].dateTime.tm_sec );
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( SameAsParseTrack )
+{
+    for (std::string filename : {"MultipleSegments.gpx", "ThreePointTrack.gpx", "ThreePointTrack-ExtraData.gpx", "MultipleFeatures.gpx"})
+    {
+        const std::string data = readGPXTrackFile(filename);
+        std::stringstream gpxData {data};
+
+        checkSamePoints(generateAll(data), GPX::parseTrack(gpxData));
+    }
+}
+
+// One event-loop thread parses many uploads, resuming each generator when its pipe is readable.
+BOOST_AUTO_TEST_CASE( UploadsOnEventLoop )
+{
+    const std::string data = readGPXTrackFile("MultipleSegments.gpx");
+    std::stringstream gpxData {data};
+    const std::vector<TrackPoint> expected = GPX::parseTrack(gpxData);
+
+    const std::size_t numUploads = 64;
+    std::vector<std::array<int,2>> pipes(numUploads);
+    std::vector<std::unique_ptr<GPX::TrackPointGenerator>> generators;
+    std::vector<std::vector<TrackPoint>> points(numUploads);
+    IO::EventLoop loop;
+    for (std::size_t i = 0; i < numUploads; ++i)
+    {
+        BOOST_REQUIRE( ::pipe(pipes[i].data()) == 0 );
+        generators.push_back(std::make_unique<GPX::TrackPointGenerator>(pipes[i][0]));
+        loop.watch(pipes[i][0], [&,i]
+        {
+            while (std::optional<TrackPoint> point = generators[i]->next()) points[i].push_back(*point);
+            return ! generators[i]->ended();
+        });
+    }
+
+    std::vector<std::thread> uploads;
+    for (std::size_t i = 0; i < numUploads; ++i)
+    {
+        uploads.emplace_back([&,i] { uploadInPieces(pipes[i][1], data, 17 + i, std::chrono::microseconds(50)); ::close(pipes[i][1]); });
+    }
+
+    loop.run();
+    for (std::thread& upload : uploads) upload.join();
+
+    BOOST_CHECK_EQUAL( loop.size(), 0 );
+    for (std::size_t i = 0; i < numUploads; ++i)
+    {
+        checkSamePoints(points[i], expected);
+        ::close(pipes[i][0]);
+    }
+}
+
+// An invalid point is reported by the handler's exception, which stops watching only that upload.
+BOOST_AUTO_TEST_CASE( ErrorInOneUpload )
+{
+    const std::string valid = readGPXTrackFile("ThreePointTrack.gpx");
+    std::string invalid = valid;
+    invalid.replace(invalid.find("<time>"), 6, "<tiem>");
+    invalid.replace(invalid.find("</time>"), 7, "</tiem>");
+
+    std::array<int,2> validPipe, invalidPipe;
+    BOOST_REQUIRE( ::pipe(validPipe.data()) == 0 && ::pipe(invalidPipe.data()) == 0 );
+    uploadInPieces(invalidPipe[1], invalid, invalid.size(), std::chrono::microseconds(0));
+    ::close(invalidPipe[1]);
+
+    GPX::TrackPointGenerator validGenerator {validPipe[0]}, invalidGenerator {invalidPipe[0]};
+    std::vector<TrackPoint> points;
+    IO::EventLoop loop;
+    loop.watch(invalidPipe[0], [&] { while (invalidGenerator.next()) {} return ! invalidGenerator.ended(); });
+    loop.watch(validPipe[0], [&]
+    {
+        while (std::optional<TrackPoint> point = validGenerator.next()) points.push_back(*point);
+        return ! validGenerator.ended();
+    });
+
+    BOOST_CHECK_THROW( loop.run(), std::domain_error );
+    BOOST_CHECK_EQUAL( loop.size(), 1 );
+
+    uploadInPieces(validPipe[1], valid, valid.size(), std::chrono::microseconds(0));
+    ::close(validPipe[1]);
+    loop.run();
+
+    BOOST_CHECK_EQUAL( points.size(), 3 );
+    for (int fd : {validPipe[0], invalidPipe[0]}) ::close(fd);
+}
+
+BOOST_AUTO_TEST_CASE( IncompleteDocuments )
+{
+    const std::string data = readGPXTrackFile("ThreePointTrack.gpx");
+
+    BOOST_CHECK_THROW( generateAll("<?xml version=\"1.0\"?><gpx></gpx>"), std::domain_error );
+    BOOST_CHECK_THROW( generateAll("<gpx><trk><name>Empty</name></trk></gpx>"), std::domain_error );
+    BOOST_CHECK_THROW( generateAll(data.substr(0, data.find("</trk>"))), std::domain_error );
+}
+
+BOOST_AUTO_TEST_CASE( InvalidDescriptor )
+{
+    BOOST_CHECK_THROW( GPX::TrackPointGenerator{-1}, std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
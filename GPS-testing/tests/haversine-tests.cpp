@@ -0,0 +1,185 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "earth.h"
+#include "position.h"
+#include "haversine.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( Haversine )
+
+const std::vector<DistanceKernel> allKernels = { DistanceKernel::scalar, DistanceKernel::avx2 };
+
+// Maps doubles to integers with the same ordering, so that adjacent doubles map to adjacent integers.
+std::int64_t orderedBits(double d)
+{
+    std::int64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return bits < 0 ? INT64_MIN - bits : bits;
+}
+
+std::uint64_t ulpsBetween(double a, double b)
+{
+    return std::llabs(orderedBits(a) - orderedBits(b));
+}
+
+// Pairs of points no more than 'maxSeparation' degrees apart in each of latitude and longitude.
+void randomPairs(std::mt19937_64& generator, degrees maxSeparation, std::size_t numPairs,
+                 std::vector<degrees>& lats, std::vector<degrees>& lons)
+{
+    std::uniform_real_distribution<degrees> latitude(-90,90), longitude(-180,180), offset(-maxSeparation,maxSeparation);
+    for (std::size_t i = 0; i < numPairs; ++i)
+    {
+        const degrees lat = latitude(generator);
+        const degrees lon = longitude(generator);
+        degrees otherLon = lon + offset(generator);
+        if (otherLon > 180) otherLon -= 360;
+        if (otherLon < -180) otherLon += 360;
+
+        lats.push_back(lat);
+        lons.push_back(lon);
+        lats.push_back(std::max(-90.0, std::min(90.0, lat + offset(generator))));
+        lons.push_back(otherLon);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( MatchesPositionDistance )
+{
+    BOOST_CHECK_EQUAL( haversineDistance(52.91249953, -1.18402513, 52.9581383, -1.1542364),
+                       Position::horizontalDistanceBetween(Earth::CliftonCampus, Earth::CityCampus) );
+}
+
+BOOST_AUTO_TEST_CASE( ScalarKernelIsExact )
+{
+    std::mt19937_64 generator;
+    std::vector<degrees> lats, lons;
+    randomPairs(generator, 10, 1000, lats, lons);
+    std::vector<metres> distances;
+
+    consecutiveDistances(lats, lons, distances, DistanceKernel::scalar);
+
+    BOOST_REQUIRE_EQUAL( distances.size(), lats.size() - 1 );
+    for (std::size_t i = 0; i < distances.size(); ++i)
+    {
+        BOOST_REQUIRE_EQUAL( distances[i], haversineDistance(lats[i], lons[i], lats[i+1], lons[i+1]) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( KernelsWithinULPBound )
+{
+    std::mt19937_64 generator;
+    const metres quarterCircumference = Earth::polarCircumference / 4;
+
+    for (DistanceKernel kernel : allKernels)
+    {
+        if (! isSupported(kernel)) continue;
+
+        for (degrees maxSeparation : {0.00001, 0.01, 1.0, 45.0})
+        {
+            std::vector<degrees> lats, lons;
+            randomPairs(generator, maxSeparation, 20000, lats, lons);
+            std::vector<metres> distances;
+
+            consecutiveDistances(lats, lons, distances, kernel);
+
+            std::uint64_t worstULPs = 0;
+            for (std::size_t i = 0; i < distances.size(); i += 2) // Only the pairs, not the points between them.
+            {
+                const metres expected = haversineDistance(lats[i], lons[i], lats[i+1], lons[i+1]);
+                if (expected <= quarterCircumference) worstULPs = std::max(worstULPs, ulpsBetween(distances[i], expected));
+            }
+            BOOST_CHECK_LE( worstULPs, maxBatchErrorULPs );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( DistancesToTarget )
+{
+    std::mt19937_64 generator;
+    std::vector<degrees> lats, lons;
+    randomPairs(generator, 20, 501, lats, lons); // Not a multiple of the vector width.
+
+    for (DistanceKernel kernel : allKernels)
+    {
+        if (! isSupported(kernel)) continue;
+
+        std::vector<metres> distances;
+        distancesTo(lats, lons, Earth::CityCampus.latitude(), Earth::CityCampus.longitude(), distances, kernel);
+
+        BOOST_REQUIRE_EQUAL( distances.size(), lats.size() );
+        for (std::size_t i = 0; i < distances.size(); ++i)
+        {
+            const metres expected = Position::horizontalDistanceBetween(Position(lats[i], lons[i], 0), Earth::CityCampus);
+            BOOST_CHECK_CLOSE( distances[i], expected, 1e-9 );
+        }
+    }
+}
+
+// Lanes whose reductions fall in every quadrant, including the poles and the anti-meridian.
+BOOST_AUTO_TEST_CASE( ExtremeCoordinates )
+{
+    const std::vector<degrees> lats = {90, -90, 0, 0, 45, -45, 89.9999999, 0, 0};
+    const std::vector<degrees> lons = {0, 180, -180, 180, 179.9999, -179.9999, 0, 0, 90};
+
+    for (DistanceKernel kernel : allKernels)
+    {
+        if (! isSupported(kernel)) continue;
+
+        std::vector<metres> distances;
+        consecutiveDistances(lats, lons, distances, kernel);
+
+        for (std::size_t i = 0; i < distances.size(); ++i)
+        {
+            BOOST_CHECK_CLOSE( distances[i], haversineDistance(lats[i], lons[i], lats[i+1], lons[i+1]), 1e-9 );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( FewerPointsThanLanes )
+{
+    std::vector<metres> distances = {1, 2, 3};
+
+    consecutiveDistances({}, {}, distances);
+    BOOST_CHECK( distances.empty() );
+
+    consecutiveDistances({52.9}, {-1.2}, distances);
+    BOOST_CHECK( distances.empty() );
+
+    consecutiveDistances({52.9, 53.0, 53.1}, {-1.2, -1.2, -1.2}, distances);
+    BOOST_CHECK_EQUAL( distances.size(), 2 );
+}
+
+// Neither kernel validates its inputs, so they behave the same for invalid coordinates.
+BOOST_AUTO_TEST_CASE( UnvalidatedCoordinates )
+{
+    const std::vector<degrees> lats = {91, 0, -200, 0, 0};
+    const std::vector<degrees> lons = {0, 400, 0, 0, 0};
+
+    for (DistanceKernel kernel : allKernels)
+    {
+        if (! isSupported(kernel)) continue;
+
+        std::vector<metres> distances;
+        BOOST_CHECK_NO_THROW( consecutiveDistances(lats, lons, distances, kernel) );
+        BOOST_CHECK_NO_THROW( distancesTo(lats, lons, 100, 0, distances, kernel) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( MismatchedArrays )
+{
+    std::vector<metres> distances;
+
+    BOOST_CHECK_THROW( consecutiveDistances({52.9, 53.0}, {-1.2}, distances), std::invalid_argument );
+    BOOST_CHECK_THROW( distancesTo({52.9}, {-1.2, -1.3}, 0, 0, distances), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,235 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <random>
+
+#include <zlib.h>
+#include <unistd.h>
+
+#include "dataFiles.h"
+#include "gpx-parser.h"
+#include "nmea-parser.h"
+#include "io-input.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( IO_InputStream )
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+// Utilities
+
+std::string readWholeFile(std::string filepath)
+{
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open log file: " + filepath + "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::ifstream file {filepath, std::ios::binary};
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Reads via the istream (not its streambuf), so that read errors set the stream state.
+std::string readWholeStream(std::istream& stream)
+{
+    std::string content;
+    char buffer[4096];
+    while (stream.read(buffer, sizeof(buffer)) || stream.gcount() > 0)
+    {
+        content.append(buffer, stream.gcount());
+    }
+    return content;
+}
+
+// A temporary file, removed when the test case that created it ends.
+struct TemporaryFile
+{
+    std::string path;
+
+    explicit TemporaryFile(std::string path) : path{path} {}
+    ~TemporaryFile() { std::filesystem::remove(path); }
+
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+};
+
+/* Writes the content as one gzip member per string, appended to a new temporary file.
+ * The process ID is added to the name, so that concurrent test runs use different files.
+ */
+std::unique_ptr<TemporaryFile> writeGzipFile(std::string filename, std::vector<std::string> members)
+{
+    filename = std::to_string(::getpid()) + "-" + filename;
+    auto file = std::make_unique<TemporaryFile>((std::filesystem::temp_directory_path() / filename).string());
+    std::filesystem::remove(file->path);
+    for (const std::string& content : members)
+    {
+        gzFile gz = gzopen(file->path.c_str(), "ab");
+        BOOST_REQUIRE( gz != nullptr );
+        BOOST_REQUIRE_EQUAL( gzwrite(gz, content.data(), content.size()), int(content.size()) );
+        gzclose(gz);
+    }
+    return file;
+}
+
+// Compresses the content as a single gzip member in memory, with the given compression level.
+std::string gzipMember(const std::string& content, int level)
+{
+    z_stream zs {};
+    BOOST_REQUIRE( deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK );
+    std::string compressed(deflateBound(&zs, content.size()), '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(content.data()));
+    zs.avail_in = content.size();
+    zs.next_out = reinterpret_cast<Bytef*>(compressed.data());
+    zs.avail_out = compressed.size();
+    BOOST_REQUIRE( deflate(&zs, Z_FINISH) == Z_STREAM_END );
+    compressed.resize(zs.total_out);
+    deflateEnd(&zs);
+    return compressed;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( UncompressedPassesThrough )
+{
+    const std::string original = readWholeFile(DataFiles::NMEADir + "gll.log");
+
+    IO::InputStream input {DataFiles::NMEADir + "gll.log"};
+
+    BOOST_CHECK( ! input.isCompressed() );
+    BOOST_CHECK( readWholeStream(input) == original );
+}
+
+BOOST_AUTO_TEST_CASE( CompressedNMEALog )
+{
+    const std::string original = readWholeFile(DataFiles::NMEADir + "gga_rmc-2.log");
+    const auto compressedFile = writeGzipFile("gga_rmc-2.log.gz", {original});
+
+    IO::InputStream input {compressedFile->path};
+
+    BOOST_CHECK( input.isCompressed() );
+    BOOST_CHECK( readWholeStream(input) == original );
+}
+
+// The NMEA parser reads a compressed log directly, with the same result as the plain log.
+BOOST_AUTO_TEST_CASE( CompressedNMEASentences )
+{
+    const std::string plainPath = DataFiles::NMEADir + "gga_rmc-2.log";
+    const auto compressedFile = writeGzipFile("gga_rmc-2-sentences.log.gz", {readWholeFile(plainPath)});
+    std::ifstream plainData {plainPath};
+
+    IO::InputStream compressedData {compressedFile->path};
+    std::vector<Position> expected = NMEA::readSentences(plainData);
+    std::vector<Position> actual = NMEA::readSentences(compressedData);
+
+    BOOST_REQUIRE( ! expected.empty() );
+    BOOST_REQUIRE_EQUAL( actual.size(), expected.size() );
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( actual[i].latitude(), expected[i].latitude() );
+        BOOST_CHECK_EQUAL( actual[i].longitude(), expected[i].longitude() );
+        BOOST_CHECK_EQUAL( actual[i].elevation(), expected[i].elevation() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( CompressedGPXTrack )
+{
+    const std::string original = readWholeFile(DataFiles::GPXTracksDir + "MultipleSegments.gpx");
+    const auto compressedFile = writeGzipFile("MultipleSegments.gpx.gz", {original});
+    std::stringstream plainData {original};
+
+    IO::InputStream compressedData {compressedFile->path};
+    std::vector<TrackPoint> expected = GPX::parseTrack(plainData);
+    std::vector<TrackPoint> actual = GPX::parseTrack(compressedData);
+
+    BOOST_REQUIRE_EQUAL( actual.size(), expected.size() );
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( actual[i].position.latitude(), expected[i].position.latitude() );
+        BOOST_CHECK_EQUAL( actual[i].position.longitude(), expected[i].position.longitude() );
+    }
+}
+
+// Appending to a .gz file produces several members, which must be read as one stream.
+BOOST_AUTO_TEST_CASE( ConcatenatedMembers )
+{
+    const auto compressedFile = writeGzipFile("members.gz", {"first\n", "second\n", "third\n"});
+
+    IO::InputStream input {compressedFile->path};
+
+    BOOST_CHECK_EQUAL( readWholeStream(input), "first\nsecond\nthird\n" );
+}
+
+/* A member boundary that falls one byte before the end of the decompressor's 64 KB input chunk,
+ * so that only the first byte of the next member's header is in the chunk.
+ */
+BOOST_AUTO_TEST_CASE( MemberBoundaryAtChunkEnd )
+{
+    const std::size_t boundary = 64 * 1024 - 1;
+
+    // Stored (uncompressed) random data, so that the member size can be adjusted byte by byte.
+    std::mt19937 generator;
+    std::string content(boundary, '\0');
+    for (char& c : content) c = char(generator());
+    std::string first = gzipMember(content, 0);
+    for (int attempt = 0; attempt < 10 && first.size() != boundary; ++attempt)
+    {
+        content.resize(content.size() + boundary - first.size());
+        first = gzipMember(content, 0);
+    }
+    BOOST_REQUIRE_EQUAL( first.size(), boundary );
+
+    std::stringstream source {first + gzipMember("second\n", 9) + gzipMember("third\n", 9)};
+    IO::InputStream input {source};
+
+    BOOST_CHECK( readWholeStream(input) == content + "second\nthird\n" );
+}
+
+// Tiny buffers force many hand-overs between the decompressor and the reader.
+BOOST_AUTO_TEST_CASE( SmallBuffers )
+{
+    const std::string original = readWholeFile(DataFiles::NMEADir + "gga_rmc-1.log");
+    const auto compressedFile = writeGzipFile("gga_rmc-1.log.gz", {original});
+    std::ifstream compressed {compressedFile->path, std::ios::binary};
+
+    IO::DecompressingStreambuf decompressor {compressed, 7};
+    std::istream input {&decompressor};
+
+    BOOST_CHECK( readWholeStream(input) == original );
+}
+
+// The XML parser puts characters back, which must work across buffer boundaries.
+BOOST_AUTO_TEST_CASE( PutbackAcrossBuffers )
+{
+    const std::string original = readWholeFile(DataFiles::GPXTracksDir + "MultipleSegments.gpx");
+    const auto compressedFile = writeGzipFile("MultipleSegments-small.gpx.gz", {original});
+    std::ifstream compressed {compressedFile->path, std::ios::binary};
+    std::stringstream plainData {original};
+
+    IO::DecompressingStreambuf decompressor {compressed, 3};
+    std::istream compressedData {&decompressor};
+
+    BOOST_CHECK_EQUAL( GPX::parseTrack(compressedData).size(), GPX::parseTrack(plainData).size() );
+}
+
+BOOST_AUTO_TEST_CASE( CorruptData )
+{
+    std::string corrupt = readWholeFile(writeGzipFile("corrupt.gz", {std::string(10000,'x')})->path);
+    corrupt.resize(corrupt.size() / 2);
+    std::stringstream source {corrupt};
+
+    IO::InputStream input {source};
+    readWholeStream(input);
+
+    BOOST_CHECK( input.isCompressed() );
+    BOOST_CHECK( input.bad() );
+}
+
+BOOST_AUTO_TEST_CASE( MissingFile )
+{
+    BOOST_CHECK_THROW( IO::InputStream{"no-such-file.gz"}, std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
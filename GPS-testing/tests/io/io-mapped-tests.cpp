@@ -0,0 +1,74 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+
+#include "dataFiles.h"
+#include "io-mapped.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( IO_MappedFile )
+
+BOOST_AUTO_TEST_CASE( MapsWholeFile )
+{
+    const std::string filepath = DataFiles::NMEADir + "gll.log";
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open log file: " + filepath + "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::ifstream file {filepath, std::ios::binary};
+    const std::string expected {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    IO::MappedFile mapped {filepath};
+
+    BOOST_CHECK( mapped.contents() == expected );
+}
+
+BOOST_AUTO_TEST_CASE( MissingFile )
+{
+    BOOST_CHECK_THROW( IO::MappedFile{"no-such-file.log"}, std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( Directory )
+{
+    BOOST_CHECK_THROW( IO::MappedFile{std::filesystem::temp_directory_path().string()}, std::invalid_argument );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ChunksAreWholeLines )
+{
+    const std::string text = "one\ntwo\nthree\nfour\nfive\nsix\nseven\n";
+
+    for (std::size_t maxChunks = 1; maxChunks <= 10; ++maxChunks)
+    {
+        std::vector<std::string_view> chunks = IO::splitIntoLineChunks(text, maxChunks);
+
+        BOOST_REQUIRE_LE( chunks.size(), maxChunks );
+        std::string joined;
+        for (std::string_view chunk : chunks)
+        {
+            BOOST_CHECK( ! chunk.empty() && chunk.back() == '\n' );
+            joined += chunk;
+        }
+        BOOST_CHECK_EQUAL( joined, text );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( UnterminatedFinalLine )
+{
+    std::vector<std::string_view> chunks = IO::splitIntoLineChunks("one\ntwo", 2);
+
+    BOOST_REQUIRE_EQUAL( chunks.size(), 2 );
+    BOOST_CHECK_EQUAL( chunks[0], "one\n" );
+    BOOST_CHECK_EQUAL( chunks[1], "two" );
+}
+
+BOOST_AUTO_TEST_CASE( SingleLongLine )
+{
+    BOOST_CHECK_EQUAL( IO::splitIntoLineChunks("no newline at all", 4).size(), 1 );
+    BOOST_CHECK( IO::splitIntoLineChunks("", 4).empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
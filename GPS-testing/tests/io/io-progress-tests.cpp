@@ -0,0 +1,109 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include "dataFiles.h"
+#include "gpx-parser.h"
+#include "io-progress.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( IO_Progress )
+
+// A track of the given number of points, large enough to span many check intervals.
+std::string generatedTrack(unsigned int numPoints)
+{
+    std::ostringstream gpx;
+    gpx << "<gpx><trk><trkseg>";
+    for (unsigned int i = 0; i < numPoints; ++i)
+    {
+        gpx << "<trkpt lat=\"" << (i % 90) << "\" lon=\"0\"><time>2020-03-23T13:00:01Z</time></trkpt>";
+    }
+    gpx << "</trkseg></trk></gpx>";
+    return gpx.str();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ReportsProgress )
+{
+    const std::string gpx = generatedTrack(2000);
+    std::stringstream gpxData {gpx};
+    std::vector<IO::Progress> reports;
+    IO::ProgressMonitor monitor {[&reports](const IO::Progress& p) {reports.push_back(p); return true;}, 8192};
+
+    std::vector<TrackPoint> trackPoints = GPX::parseTrack(gpxData, monitor);
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 2000 );
+    BOOST_REQUIRE_GE( reports.size(), gpx.size() / 8192 );
+    for (std::size_t i = 1; i < reports.size(); ++i)
+    {
+        BOOST_CHECK_GT( reports[i].bytesConsumed, reports[i-1].bytesConsumed );
+        BOOST_CHECK( reports[i].elapsed >= reports[i-1].elapsed );
+    }
+    BOOST_CHECK_EQUAL( reports.back().bytesConsumed, gpx.size() );
+    BOOST_CHECK_EQUAL( reports.back().pointsProduced, 2000 );
+    BOOST_CHECK_EQUAL( monitor.progress().pointsProduced, 2000 );
+}
+
+BOOST_AUTO_TEST_CASE( CallbackCancels )
+{
+    std::stringstream gpxData {generatedTrack(2000)};
+    std::uint64_t bytesWhenCancelled = 0;
+    IO::ProgressMonitor monitor {[&](const IO::Progress& p) {bytesWhenCancelled = p.bytesConsumed; return p.bytesConsumed < 16384;}, 4096};
+
+    BOOST_CHECK_THROW( GPX::parseTrack(gpxData, monitor), IO::Cancelled );
+    BOOST_CHECK( monitor.isCancelled() );
+    BOOST_CHECK_GE( bytesWhenCancelled, 16384 );
+    BOOST_CHECK_LT( bytesWhenCancelled, 16384 + 2 * 4096 );
+}
+
+BOOST_AUTO_TEST_CASE( CancelledExternally )
+{
+    std::stringstream gpxData {generatedTrack(2000)};
+    IO::ProgressMonitor monitor {nullptr, 4096};
+
+    monitor.cancel();
+
+    BOOST_CHECK_THROW( GPX::parseTrack(gpxData, monitor), IO::Cancelled );
+    BOOST_CHECK_LE( monitor.progress().bytesConsumed, 2 * 4096 );
+}
+
+// Other parse errors are still reported as before.
+BOOST_AUTO_TEST_CASE( ParseErrorsUnaffected )
+{
+    std::stringstream gpxData {"<gpx><rte></rte></gpx>"};
+    IO::ProgressMonitor monitor;
+
+    BOOST_CHECK_THROW( GPX::parseTrack(gpxData, monitor), std::domain_error );
+}
+
+BOOST_AUTO_TEST_CASE( SameResultAsUnmonitored )
+{
+    const std::string filepath = DataFiles::GPXTracksDir + "MultipleSegments.gpx";
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open log file: " + filepath + "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::ifstream plainData {filepath};
+    std::ifstream monitoredData {filepath};
+    IO::ProgressMonitor monitor {nullptr, 1}; // Check after every block.
+
+    std::vector<TrackPoint> expected = GPX::parseTrack(plainData);
+    std::vector<TrackPoint> actual = GPX::parseTrack(monitoredData, monitor);
+
+    BOOST_REQUIRE_EQUAL( actual.size(), expected.size() );
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( actual[i].position.latitude(), expected[i].position.latitude() );
+        BOOST_CHECK_EQUAL( actual[i].position.longitude(), expected[i].position.longitude() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( ZeroInterval )
+{
+    BOOST_CHECK_THROW( IO::ProgressMonitor(nullptr, 0), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
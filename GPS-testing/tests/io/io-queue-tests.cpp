@@ -0,0 +1,72 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <thread>
+
+#include "io-queue.h"
+
+using namespace GPS;
+
+BOOST_AUTO_TEST_SUITE( IO_SpscQueue )
+
+BOOST_AUTO_TEST_CASE( FirstInFirstOut )
+{
+    IO::SpscQueue<int> queue {3};
+    int value = 0;
+
+    BOOST_CHECK( queue.empty() );
+    BOOST_CHECK( ! queue.tryPop(value) );
+    BOOST_CHECK( queue.tryPush(1) );
+    BOOST_CHECK( queue.tryPush(2) );
+    BOOST_CHECK( queue.tryPush(3) );
+    BOOST_CHECK( ! queue.tryPush(4) ); // Full
+
+    BOOST_CHECK( queue.tryPop(value) );
+    BOOST_CHECK_EQUAL( value, 1 );
+    BOOST_CHECK( queue.tryPush(4) );   // Wraps around
+    for (int expected : {2, 3, 4})
+    {
+        BOOST_REQUIRE( queue.tryPop(value) );
+        BOOST_CHECK_EQUAL( value, expected );
+    }
+    BOOST_CHECK( queue.empty() );
+    BOOST_CHECK_EQUAL( queue.capacity(), 3 );
+}
+
+// Every value arrives, in order, when the producer and consumer run concurrently.
+BOOST_AUTO_TEST_CASE( ConcurrentProducerAndConsumer )
+{
+    const int numValues = 1000000;
+    IO::SpscQueue<int> queue {64};
+
+    std::thread producer([&queue]
+    {
+        for (int i = 0; i < numValues; )
+        {
+            if (queue.tryPush(i)) ++i;
+        }
+    });
+
+    int expected = 0;
+    bool inOrder = true;
+    while (expected < numValues)
+    {
+        int value;
+        if (queue.tryPop(value))
+        {
+            inOrder = inOrder && value == expected;
+            ++expected;
+        }
+    }
+    producer.join();
+
+    BOOST_CHECK( inOrder );
+    BOOST_CHECK( queue.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( ZeroCapacity )
+{
+    BOOST_CHECK_THROW( IO::SpscQueue<int>{0}, std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
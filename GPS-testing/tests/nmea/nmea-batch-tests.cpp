@@ -0,0 +1,174 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include <fstream>
+#include <sstream>
+
+#include "dataFiles.h"
+#include "nmea-batch.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( ValidateLines )
+
+const std::vector<SimdLevel> allLevels = {SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2};
+
+// The expected results, from scanning each line separately.
+std::vector<ScanResult> scanEachLine(const std::string& text)
+{
+    std::vector<ScanResult> results;
+    std::istringstream lines {text};
+    SentenceView sentenceView;
+    for (std::string line; std::getline(lines, line); )
+    {
+        if (! line.empty() && line.back() == '\r') line.pop_back();
+        results.push_back(scanSentence(line, sentenceView));
+    }
+    return results;
+}
+
+void checkAllLevelsAgree(const std::string& text)
+{
+    const std::vector<ScanResult> expected = scanEachLine(text);
+
+    for (SimdLevel level : allLevels)
+    {
+        if (! isSupported(level)) continue;
+
+        std::vector<LineCheck> actual;
+        validateLines(text, actual, level);
+
+        BOOST_REQUIRE_EQUAL( actual.size(), expected.size() );
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            BOOST_CHECK_MESSAGE( actual[i].result == expected[i],
+                                 "Line " << i << " mismatched at SIMD level " << int(level) << ": "
+                                 << text.substr(actual[i].begin, actual[i].length) );
+        }
+    }
+}
+
+std::string readLogFile(std::string filename)
+{
+    std::ifstream file {DataFiles::NMEADir + filename};
+    BOOST_REQUIRE_MESSAGE( file.good(),
+      ("Could not open NMEA data file: " + DataFiles::NMEADir + filename +
+       "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ScalarAlwaysSupported )
+{
+    BOOST_CHECK( isSupported(SimdLevel::scalar) );
+    BOOST_CHECK( isSupported(bestSimdLevel()) );
+}
+
+BOOST_AUTO_TEST_CASE( LineBoundaries )
+{
+    const std::string text = "$GPGLL,5425.31,N,107.03,W,82610*69\r\n\n$GPAAA,1*4b";
+    std::vector<LineCheck> results;
+
+    validateLines(text, results);
+
+    BOOST_REQUIRE_EQUAL( results.size(), 3 );
+    BOOST_CHECK_EQUAL( results[0].begin, 0 );
+    BOOST_CHECK_EQUAL( results[0].length, 34 );
+    BOOST_CHECK( results[0].result == ScanResult::valid );
+    BOOST_CHECK_EQUAL( results[1].begin, 36 );
+    BOOST_CHECK_EQUAL( results[1].length, 0 );
+    BOOST_CHECK( results[1].result == ScanResult::invalidStructure );
+    BOOST_CHECK_EQUAL( results[2].begin, 37 );
+    BOOST_CHECK_EQUAL( results[2].length, 11 );
+    BOOST_CHECK( results[2].result == ScanResult::valid );
+}
+
+BOOST_AUTO_TEST_CASE( ResultsAreAppended )
+{
+    std::vector<LineCheck> results;
+
+    validateLines("$GPAAA,1*4b\n", results);
+    validateLines("$GPAAA,1*4c\n", results);
+
+    BOOST_REQUIRE_EQUAL( results.size(), 2 );
+    BOOST_CHECK( results[1].result == ScanResult::checksumMismatch );
+}
+
+BOOST_AUTO_TEST_CASE( EdgeCases )
+{
+    checkAllLevelsAgree("");
+    checkAllLevelsAgree("\n\n\n");
+    checkAllLevelsAgree("$");
+    checkAllLevelsAgree("$GPXXX,*01");
+    checkAllLevelsAgree("$GPGLL,5425.31,N,107.03,W,82610*69");
+    checkAllLevelsAgree("$GPGLL,5425.31,N,107.03,W,82610*6");
+    checkAllLevelsAgree("$GPGLL,5425.31,N,107.03,W,82610*69\r");
+    checkAllLevelsAgree("$GPXXX,$77*01\n$GPXXX,2*3,1*77\n$GPXXX*01\n$GQXXX,*01\n$GPXXX,*012\n$GPXXX,*g3\n*$GP\n");
+    checkAllLevelsAgree("$GPGLL,5425.31,N,107.03,W,82610*69$GPRMC,113922.000,A,3722.5993,N,00559.2458,W,0.000,0.00,150914,,A*62\n");
+}
+
+BOOST_AUTO_TEST_CASE( TalkerIDs )
+{
+    checkAllLevelsAgree("$GNGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*64\n"
+                        "$GLGSV,1,1,02,65,40,083,46,66,17,308,41*61\n"
+                        "$GBGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*2B\n"
+                        "$BDGLL,5425.31,N,107.03,W,82610*78\n"
+                        "$GLGLL,5425.31,N,107.03,W,82610*69\n");
+
+    std::vector<LineCheck> results;
+    validateLines("$GNGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*64", results);
+    BOOST_REQUIRE_EQUAL( results.size(), 1 );
+    BOOST_CHECK( results[0].result == ScanResult::valid );
+}
+
+BOOST_AUTO_TEST_CASE( LogFiles )
+{
+    checkAllLevelsAgree(readLogFile("gll.log"));
+    checkAllLevelsAgree(readLogFile("gga_rmc-1.log"));
+    checkAllLevelsAgree(readLogFile("gga_rmc-2.log"));
+}
+
+// Long fields move the '*' through every offset within the SIMD blocks.
+BOOST_AUTO_TEST_CASE( LongLines )
+{
+    std::string text;
+    for (unsigned int length = 0; length < 100; ++length)
+    {
+        std::string sentence = "GPXXX," + std::string(length, 'a');
+        unsigned char checksum = 0;
+        for (char c : sentence) checksum ^= c;
+        std::ostringstream line;
+        line << '$' << sentence << '*' << std::hex << (checksum >> 4) << (checksum & 0xF) << '\n';
+        text += line.str();
+    }
+
+    checkAllLevelsAgree(text);
+    BOOST_CHECK( scanEachLine(text).back() == ScanResult::valid );
+}
+
+// Random corruptions of valid sentences, including the characters that stop the scan.
+BOOST_AUTO_TEST_CASE( RandomCorruptions )
+{
+    const std::string original = readLogFile("gga_rmc-2.log");
+    const std::string replacements = "$*\n\r,0Aa";
+    std::mt19937 generator {2024};
+    std::uniform_int_distribution<std::size_t> position {0, original.size() - 1};
+    std::uniform_int_distribution<std::size_t> replacement {0, replacements.size() - 1};
+
+    std::string corrupted = original;
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+        corrupted[position(generator)] = replacements[replacement(generator)];
+    }
+
+    checkAllLevelsAgree(corrupted);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
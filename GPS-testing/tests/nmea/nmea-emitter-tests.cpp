@@ -0,0 +1,216 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <cmath>
+#include <chrono>
+
+#include "nmea-formats.h"
+#include "nmea-emitter.h"
+#include "gridworld-route.h"
+#include "gridworld-track.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( SentenceEmitter_ )
+
+// 4 decimal places of minutes.
+const degrees ddmAccuracy = 0.0001 / 60;
+
+std::tm timeOfDay(int hours, int minutes, int seconds)
+{
+    std::tm time {};
+    time.tm_hour = hours;
+    time.tm_min = minutes;
+    time.tm_sec = seconds;
+    return time;
+}
+
+// Splits the emitted text into sentences, checking that each one is valid and terminated by "\r\n".
+std::vector<std::string_view> emittedSentences(std::string_view text)
+{
+    std::vector<std::string_view> sentences;
+    for (std::size_t lineEnd = text.find("\r\n"); lineEnd != std::string_view::npos; lineEnd = text.find("\r\n"))
+    {
+        sentences.push_back(text.substr(0, lineEnd));
+        text.remove_prefix(lineEnd + 2);
+    }
+    BOOST_CHECK( text.empty() );
+
+    SentenceView sentenceView;
+    for (std::string_view sentence : sentences)
+    {
+        BOOST_CHECK_MESSAGE( scanSentence(sentence, sentenceView) == ScanResult::valid, "Invalid sentence: " << sentence );
+    }
+    return sentences;
+}
+
+Fix decodeEmitted(std::string_view sentence)
+{
+    SentenceView sentenceView;
+    Fix fix;
+    BOOST_REQUIRE( scanSentence(sentence, sentenceView) == ScanResult::valid );
+    BOOST_REQUIRE( decodeFix(sentenceView, fix) );
+    return fix;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Formats )
+{
+    const Position position {37.386036667, -5.99298, 30};
+    NMEA::SentenceEmitter emitter;
+
+    emitter.gll(position, timeOfDay(9,46,27));
+    emitter.gga(position, timeOfDay(9,46,27));
+    std::tm dateTime = timeOfDay(9,46,27);
+    dateTime.tm_mday = 15;
+    dateTime.tm_mon = 8;
+    dateTime.tm_year = 114;
+    emitter.rmc(position, dateTime);
+
+    const std::vector<std::string_view> sentences = emittedSentences(emitter.contents());
+    BOOST_REQUIRE_EQUAL( sentences.size(), 3 );
+    BOOST_CHECK_EQUAL( sentences[0].substr(0, sentences[0].find('*')),
+                       "$GPGLL,3723.1622,N,00559.5788,W,094627.000" );
+    BOOST_CHECK_EQUAL( sentences[1].substr(0, sentences[1].find('*')),
+                       "$GPGGA,094627.000,3723.1622,N,00559.5788,W,1,08,1.0,30.0,M,0.0,M,," );
+    BOOST_CHECK_EQUAL( sentences[2].substr(0, sentences[2].find('*')),
+                       "$GPRMC,094627.000,A,3723.1622,N,00559.5788,W,,,150914,,,A" );
+}
+
+BOOST_AUTO_TEST_CASE( DecodesToTheSamePosition )
+{
+    const std::vector<Position> positions = { {0,0,0}, {-0.5,179.999,-12.34}, {89.99999,-179.5,8848.86}, {-90,180,0} };
+    NMEA::SentenceEmitter emitter;
+
+    for (const Position& position : positions) emitter.gga(position, timeOfDay(23,59,59));
+
+    const std::vector<std::string_view> sentences = emittedSentences(emitter.contents());
+    BOOST_REQUIRE_EQUAL( sentences.size(), positions.size() );
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        const Fix fix = decodeEmitted(sentences[i]);
+        BOOST_REQUIRE( fix.position.has_value() );
+        BOOST_CHECK_SMALL( fix.position->latitude() - positions[i].latitude(), ddmAccuracy );
+        BOOST_CHECK_SMALL( fix.position->longitude() - positions[i].longitude(), ddmAccuracy );
+        BOOST_CHECK_SMALL( fix.position->elevation() - positions[i].elevation(), 0.05 );
+        BOOST_REQUIRE( fix.timeOfDay.has_value() );
+        BOOST_CHECK_EQUAL( *fix.timeOfDay, 23 * 3600 + 59 * 60 + 59 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( GGAQualityFields )
+{
+    NMEA::SentenceEmitter emitter;
+
+    emitter.gga(Position{0, 0, 0}, {}, {0, 3, 12.34});
+
+    const std::string_view sentence = emittedSentences(emitter.contents()).at(0);
+    BOOST_CHECK_EQUAL( sentence.substr(0, sentence.find('*')),
+                       "$GPGGA,,0000.0000,N,00000.0000,E,0,03,12.3,0.0,M,0.0,M,," );
+
+    const Fix fix = decodeEmitted(sentence);
+    BOOST_CHECK_EQUAL( fix.quality.value_or(99), 0 );
+    BOOST_CHECK_EQUAL( fix.satellitesUsed.value_or(99), 3 );
+    BOOST_CHECK_CLOSE( fix.hdop.value_or(0), 12.3, 0.0001 );
+}
+
+// Minutes that round up to 60 carry into the degrees.
+BOOST_AUTO_TEST_CASE( RoundingCarries )
+{
+    NMEA::SentenceEmitter emitter;
+
+    emitter.gll(Position{51.9999999, -0.9999999, 0});
+
+    const std::string_view sentence = emittedSentences(emitter.contents()).at(0);
+    BOOST_CHECK_EQUAL( sentence.substr(0, sentence.find('*')), "$GPGLL,5200.0000,N,00100.0000,W," );
+}
+
+BOOST_AUTO_TEST_CASE( SinkReceivesEverySentence )
+{
+    const Position position {54.4219, -107.0503, 501.5};
+    std::ostringstream sink;
+    NMEA::SentenceEmitter buffered;
+    {
+        NMEA::SentenceEmitter streamed {sink, NMEA::SentenceEmitter::maxSentenceLength};
+        for (int s = 0; s < 1000; ++s)
+        {
+            streamed.gga(position, timeOfDay(0,0,s % 60));
+            buffered.gga(position, timeOfDay(0,0,s % 60));
+        }
+        BOOST_CHECK_LE( streamed.contents().size(), NMEA::SentenceEmitter::maxSentenceLength );
+    }
+
+    BOOST_CHECK_EQUAL( emittedSentences(sink.str()).size(), 1000 );
+    BOOST_CHECK( sink.str() == buffered.contents() );
+
+    buffered.clear();
+    BOOST_CHECK( buffered.contents().empty() );
+}
+
+BOOST_AUTO_TEST_CASE( InvalidUse )
+{
+    BOOST_CHECK_THROW( NMEA::SentenceEmitter{10}, std::invalid_argument );
+
+    NMEA::SentenceEmitter emitter;
+    BOOST_CHECK_THROW( emitter.gga(Position{0, 0, 1e8}), std::domain_error );
+    BOOST_CHECK_THROW( emitter.gga(Position{0, 0, 0}, {}, {10, 8, 1.0}), std::domain_error );
+    BOOST_CHECK_THROW( emitter.gga(Position{0, 0, 0}, {}, {1, 100, 1.0}), std::domain_error );
+    BOOST_CHECK_THROW( emitter.gga(Position{0, 0, 0}, {}, {1, 8, 100}), std::domain_error );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( GridWorldRoute )
+{
+    const GridWorld::Route route {"ABGMSY"};
+    const std::vector<RoutePoint> routePoints = route.toRoutePoints();
+    std::stringstream nmea {route.toNMEA()};
+
+    const std::vector<Position> positions = readSentences(nmea);
+
+    BOOST_REQUIRE_EQUAL( positions.size(), routePoints.size() );
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        BOOST_CHECK_SMALL( positions[i].latitude() - routePoints[i].position.latitude(), ddmAccuracy );
+        BOOST_CHECK_SMALL( positions[i].longitude() - routePoints[i].position.longitude(), ddmAccuracy );
+        BOOST_CHECK_SMALL( positions[i].elevation() - routePoints[i].position.elevation(), 0.05 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( GridWorldTrack )
+{
+    // RMC dates have two-digit years, so the track must start after 1980.
+    const auto startTime = std::chrono::system_clock::from_time_t(1410774387); // 2014-09-15
+    const GridWorld::Track track {"A1B2C3H10M", GridWorld::Model(), startTime};
+    const std::vector<TrackPoint> trackPoints = track.toTrackPoints();
+
+    const std::string nmea = track.toNMEA();
+    const std::vector<std::string_view> sentences = emittedSentences(nmea);
+
+    BOOST_REQUIRE_EQUAL( sentences.size(), 2 * trackPoints.size() );
+    for (std::size_t i = 0; i < trackPoints.size(); ++i)
+    {
+        const Fix gga = decodeEmitted(sentences[2*i]);
+        const Fix rmc = decodeEmitted(sentences[2*i+1]);
+        const std::tm& dateTime = trackPoints[i].dateTime;
+
+        BOOST_CHECK_EQUAL( gga.format, "GGA" );
+        BOOST_CHECK_EQUAL( rmc.format, "RMC" );
+        BOOST_REQUIRE( gga.position && rmc.position );
+        BOOST_CHECK_SMALL( gga.position->latitude() - trackPoints[i].position.latitude(), ddmAccuracy );
+        BOOST_CHECK_SMALL( rmc.position->longitude() - trackPoints[i].position.longitude(), ddmAccuracy );
+        BOOST_CHECK_EQUAL( *gga.timeOfDay, dateTime.tm_hour * 3600 + dateTime.tm_min * 60 + dateTime.tm_sec );
+        BOOST_REQUIRE( rmc.date.has_value() );
+        BOOST_CHECK_EQUAL( rmc.date->day, dateTime.tm_mday );
+        BOOST_CHECK_EQUAL( rmc.date->month, dateTime.tm_mon + 1 );
+        BOOST_CHECK_EQUAL( rmc.date->year, dateTime.tm_year + 1900 );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
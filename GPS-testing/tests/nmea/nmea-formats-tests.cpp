@@ -0,0 +1,230 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iomanip>
+
+#include "nmea-formats.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( DecodeFix )
+
+const double percentageAccuracy = 0.0001;
+
+const double metresPerSecondPerKnot = 1852.0 / 3600;
+
+// Wraps the sentence body in the '$' prefix and the '*' checksum suffix.
+std::string sentenceWithChecksum(std::string body)
+{
+    unsigned int checksum = 0;
+    for (char c : body) checksum ^= static_cast<unsigned char>(c);
+    std::ostringstream sentence;
+    sentence << '$' << body << '*' << std::uppercase << std::hex << std::setw(2) << std::setfill('0') << checksum;
+    return sentence.str();
+}
+
+bool decode(const std::string& sentence, Fix& fix)
+{
+    SentenceView sentenceView;
+    BOOST_REQUIRE( scanSentence(sentence, sentenceView) == ScanResult::valid );
+    return decodeFix(sentenceView, fix);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( PackedFormatCodes )
+{
+    BOOST_CHECK_EQUAL( packFormatCode("GGA"), ('G' << 16) | ('G' << 8) | 'A' );
+    BOOST_CHECK_NE( packFormatCode("GGA"), packFormatCode("GAG") );
+    BOOST_CHECK_EQUAL( packFormatCode("GG"), 0 );
+    BOOST_CHECK_EQUAL( packFormatCode("GGAA"), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( Registry )
+{
+    for (const FormatSpec& spec : supportedFormats())
+    {
+        BOOST_REQUIRE( findFormat(spec.format) != nullptr );
+        BOOST_CHECK_EQUAL( findFormat(spec.format)->format, spec.format );
+        BOOST_CHECK_LE( spec.minFields, spec.maxFields );
+    }
+    BOOST_CHECK_EQUAL( supportedFormats().size(), 8 );
+    BOOST_CHECK( findFormat("MSS") == nullptr );
+    BOOST_CHECK( isSupportedFormat("VTG") );
+    BOOST_CHECK( isSupportedFormat("ZDA") );
+}
+
+BOOST_AUTO_TEST_CASE( RMC )
+{
+    Fix fix;
+
+    BOOST_REQUIRE( decode(sentenceWithChecksum("GPRMC,113922.000,A,3722.5993,N,00559.2458,W,1.500,87.25,150914,,A"), fix) );
+
+    BOOST_CHECK_EQUAL( fix.format, "RMC" );
+    BOOST_REQUIRE( fix.position );
+    BOOST_CHECK_CLOSE( fix.position->latitude(), ddmTodd("3722.5993"), percentageAccuracy );
+    BOOST_CHECK_CLOSE( fix.position->longitude(), -ddmTodd("00559.2458"), percentageAccuracy );
+    BOOST_REQUIRE( fix.timeOfDay );
+    BOOST_CHECK_CLOSE( *fix.timeOfDay, 11*3600 + 39*60 + 22, percentageAccuracy );
+    BOOST_REQUIRE( fix.date );
+    BOOST_CHECK_EQUAL( fix.date->year, 2014 );
+    BOOST_CHECK_EQUAL( fix.date->month, 9 );
+    BOOST_CHECK_EQUAL( fix.date->day, 15 );
+    BOOST_REQUIRE( fix.groundSpeed );
+    BOOST_CHECK_CLOSE( *fix.groundSpeed, 1.5 * metresPerSecondPerKnot, percentageAccuracy );
+    BOOST_REQUIRE( fix.course );
+    BOOST_CHECK_CLOSE( *fix.course, 87.25, percentageAccuracy );
+    BOOST_CHECK( ! fix.hdop );
+}
+
+BOOST_AUTO_TEST_CASE( GGA )
+{
+    Fix fix;
+
+    BOOST_REQUIRE( decode(sentenceWithChecksum("GPGGA,170834,4124.8963,N,08151.6838,W,1,05,1.5,280.2,M,-34.0,M,,"), fix) );
+
+    BOOST_REQUIRE( fix.position );
+    BOOST_CHECK_CLOSE( fix.position->elevation(), 280.2, percentageAccuracy );
+    BOOST_CHECK_CLOSE( *fix.timeOfDay, 17*3600 + 8*60 + 34, percentageAccuracy );
+    BOOST_CHECK_EQUAL( *fix.quality, 1 );
+    BOOST_CHECK_EQUAL( *fix.satellitesUsed, 5 );
+    BOOST_CHECK_CLOSE( *fix.hdop, 1.5, percentageAccuracy );
+    BOOST_CHECK( ! fix.date );
+}
+
+// Receivers without a fix leave the position empty, but the rest of the sentence is still usable.
+BOOST_AUTO_TEST_CASE( GGAWithoutPosition )
+{
+    Fix fix;
+
+    BOOST_REQUIRE( decode(sentenceWithChecksum("GPGGA,002153.000,,,,,0,0,,,M,,M,,"), fix) );
+
+    BOOST_CHECK( ! fix.position );
+    BOOST_CHECK( fix.timeOfDay );
+    BOOST_CHECK_EQUAL( *fix.quality, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( QualityOfDecodedFix )
+{
+    Fix fix;
+    QualityFilter filter;
+    filter.maxHdop = 2.0;
+
+    BOOST_REQUIRE( decode(sentenceWithChecksum("GPGGA,170834,4124.8963,N,08151.6838,W,1,05,1.5,280.2,M,-34.0,M,,"), fix) );
+    BOOST_CHECK( meetsQuality(fix, filter) );
+    filter.minSatellites = 6;
+    BOOST_CHECK( ! meetsQuality(fix, filter) );
+
+    BOOST_REQUIRE( decode(sentenceWithChecksum("GPGGA,002153.000,,,,,0,0,,,M,,M,,"), fix) );
+    BOOST_CHECK( ! meetsQuality(fix, QualityFilter{}) );
+
+    BOOST_REQUIRE( decode(sentenceWithChecksum("GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1"), fix) );
+    BOOST_CHECK( ! meetsQuality(fix, filter) );
+    filter.minSatellites = 5;
+    BOOST_CHECK( meetsQuality(fix, filter) );
+}
+
+BOOST_AUTO_TEST_CASE( GLLTimeWithoutLeadingZero )
+{
+    Fix fix;
+
+    BOOST_REQUIRE( decode("$GPGLL,5425.31,N,107.03,W,82610*69", fix) );
+
+    BOOST_CHECK( fix.position );
+    BOOST_CHECK_CLOSE( *fix.timeOfDay, 8*3600 + 26*60 + 10, percentageAccuracy );
+}
+
+BOOST_AUTO_TEST_CASE( VTG )
+{
+    Fix fix;
+
+    BOOST_REQUIRE( decode("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48", fix) );
+
+    BOOST_CHECK( ! fix.position );
+    BOOST_CHECK_CLOSE( *fix.course, 54.7, percentageAccuracy );
+    BOOST_CHECK_CLOSE( *fix.groundSpeed, 5.5 * metresPerSecondPerKnot, percentageAccuracy );
+}
+
+BOOST_AUTO_TEST_CASE( GSA )
+{
+    Fix fix;
+
+    BOOST_REQUIRE( decode(sentenceWithChecksum("GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1"), fix) );
+
+    BOOST_CHECK_EQUAL( *fix.satellitesUsed, 5 );
+    BOOST_CHECK_CLOSE( *fix.pdop, 2.5, percentageAccuracy );
+    BOOST_CHECK_CLOSE( *fix.hdop, 1.3, percentageAccuracy );
+    BOOST_CHECK_CLOSE( *fix.vdop, 2.1, percentageAccuracy );
+}
+
+BOOST_AUTO_TEST_CASE( GSV )
+{
+    Fix fix;
+
+    BOOST_REQUIRE( decode(sentenceWithChecksum("GPGSV,2,1,08,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45"), fix) );
+
+    BOOST_CHECK_EQUAL( *fix.satellitesInView, 8 );
+}
+
+BOOST_AUTO_TEST_CASE( ZDA )
+{
+    Fix fix;
+
+    BOOST_REQUIRE( decode(sentenceWithChecksum("GPZDA,201530.00,04,07,2002,00,00"), fix) );
+
+    BOOST_CHECK_CLOSE( *fix.timeOfDay, 20*3600 + 15*60 + 30, percentageAccuracy );
+    BOOST_CHECK_EQUAL( fix.date->year, 2002 );
+    BOOST_CHECK_EQUAL( fix.date->month, 7 );
+    BOOST_CHECK_EQUAL( fix.date->day, 4 );
+}
+
+BOOST_AUTO_TEST_CASE( GNS )
+{
+    Fix fix;
+
+    BOOST_REQUIRE( decode(sentenceWithChecksum("GPGNS,224749.00,3333.4268,N,11153.3538,W,D,19,0.6,406.110,-26.294,6.0,0138"), fix) );
+
+    BOOST_REQUIRE( fix.position );
+    BOOST_CHECK_CLOSE( fix.position->latitude(), ddmTodd("3333.4268"), percentageAccuracy );
+    BOOST_CHECK_CLOSE( fix.position->elevation(), 406.110, percentageAccuracy );
+    BOOST_CHECK_EQUAL( *fix.satellitesUsed, 19 );
+    BOOST_CHECK_CLOSE( *fix.hdop, 0.6, percentageAccuracy );
+}
+
+BOOST_AUTO_TEST_CASE( InvalidFields )
+{
+    Fix fix;
+
+    BOOST_CHECK( ! decode(sentenceWithChecksum("GPRMC,113922.000,A,3722.5993,N,00559.2458,W,fast,0.00,150914,,A"), fix) );
+    BOOST_CHECK( ! decode(sentenceWithChecksum("GPRMC,113922.000,A,3722.5993,N,00559.2458,W,0.000,0.00,321314,,A"), fix) );
+    BOOST_CHECK( ! decode(sentenceWithChecksum("GPRMC,253922.000,A,3722.5993,N,00559.2458,W,0.000,0.00,150914,,A"), fix) );
+    BOOST_CHECK( ! decode(sentenceWithChecksum("GPGGA,170834,4124.8963,X,08151.6838,W,1,05,1.5,280.2,M,-34.0,M,,"), fix) );
+    BOOST_CHECK( ! decode(sentenceWithChecksum("GPVTG,400.0,T,034.4,M,005.5,N,010.2,K"), fix) );
+}
+
+BOOST_AUTO_TEST_CASE( WrongNumberOfFields )
+{
+    Fix fix;
+
+    BOOST_CHECK( ! decode(sentenceWithChecksum("GPVTG,054.7,T,034.4,M,005.5,N"), fix) );
+    BOOST_CHECK( ! decode(sentenceWithChecksum("GPZDA,201530.00,04,07,2002"), fix) );
+}
+
+BOOST_AUTO_TEST_CASE( UnsupportedFormat )
+{
+    Fix fix;
+
+    BOOST_CHECK( ! decode("$GPMSS,55,27,318.0,100,*66", fix) );
+}
+
+BOOST_AUTO_TEST_CASE( PositionOnlyFromPositionalFormats )
+{
+    const SentenceData vtg = { "VTG", {"054.7","T","034.4","M","005.5","N","010.2","K"} };
+
+    BOOST_CHECK_THROW( positionFromSentenceData(vtg), std::domain_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
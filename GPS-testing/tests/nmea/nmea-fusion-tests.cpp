@@ -0,0 +1,175 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <fstream>
+#include <filesystem>
+
+#include "dataFiles.h"
+#include "nmea-fusion.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( EpochFusion )
+
+const double percentageAccuracy = 0.0001;
+
+Fix ggaFix(double timeOfDay)
+{
+    Fix fix;
+    fix.format = "GGA";
+    fix.timeOfDay = timeOfDay;
+    fix.position = Position(37.5, -5.9, 30.0);
+    fix.quality = 1;
+    return fix;
+}
+
+Fix rmcFix(double timeOfDay)
+{
+    Fix fix;
+    fix.format = "RMC";
+    fix.timeOfDay = timeOfDay;
+    fix.position = Position(37.5, -5.9, 0);
+    fix.date = Date{2014, 9, 15};
+    fix.groundSpeed = 2.5;
+    return fix;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( PairFused )
+{
+    EpochFuser fuser;
+    std::vector<Fix> fused;
+
+    fuser.add(rmcFix(100), fused);
+    fuser.add(ggaFix(100), fused);
+    fuser.flush(fused);
+
+    BOOST_REQUIRE_EQUAL( fused.size(), 1 );
+    BOOST_CHECK_EQUAL( fused[0].format, "GGA" ); // The format that supplied the position.
+    BOOST_CHECK_CLOSE( fused[0].position->elevation(), 30.0, percentageAccuracy );
+    BOOST_CHECK_EQUAL( fused[0].date->day, 15 );
+    BOOST_CHECK_CLOSE( *fused[0].groundSpeed, 2.5, percentageAccuracy );
+    BOOST_CHECK_EQUAL( *fused[0].quality, 1 );
+}
+
+BOOST_AUTO_TEST_CASE( LargeFileGGA_RMC )
+{
+    const std::string filepath = DataFiles::NMEADir + "gga_rmc-1.log";
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open log file: " + filepath + "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::fstream sentences {filepath};
+
+    std::vector<Fix> fused = readFusedFixes(sentences);
+
+    BOOST_REQUIRE_EQUAL( fused.size(), 316 );
+    for (const Fix& fix : fused)
+    {
+        BOOST_REQUIRE( fix.position && fix.date && fix.quality && fix.groundSpeed );
+    }
+    // $GPGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*7A
+    BOOST_CHECK_CLOSE( fused[0].position->elevation(), 30.0, percentageAccuracy );
+    BOOST_CHECK_CLOSE( *fused[0].timeOfDay, 9*3600 + 46*60 + 27, percentageAccuracy );
+}
+
+// Without a partner sentence, an epoch is held only until the buffer is full.
+BOOST_AUTO_TEST_CASE( MissingPartnerBounded )
+{
+    EpochFuser fuser {2};
+    std::vector<Fix> fused;
+
+    fuser.add(ggaFix(1), fused);
+    fuser.add(ggaFix(2), fused);
+    BOOST_CHECK( fused.empty() );
+
+    fuser.add(ggaFix(3), fused);
+    BOOST_REQUIRE_EQUAL( fused.size(), 1 );
+    BOOST_CHECK_EQUAL( *fused[0].timeOfDay, 1 );
+    BOOST_CHECK_EQUAL( fuser.pendingEpochs(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( LatePartner )
+{
+    EpochFuser fuser {1};
+    std::vector<Fix> fused;
+
+    fuser.add(ggaFix(1), fused);
+    fuser.add(ggaFix(2), fused);
+    fuser.add(rmcFix(1), fused);
+
+    BOOST_REQUIRE_EQUAL( fused.size(), 2 );
+    BOOST_CHECK_EQUAL( fused[1].format, "RMC" );
+    BOOST_CHECK_EQUAL( fuser.lateFixes(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( OutOfOrderWithinBuffer )
+{
+    EpochFuser fuser {2};
+    std::vector<Fix> fused;
+
+    fuser.add(ggaFix(2), fused);
+    fuser.add(ggaFix(1), fused);
+    fuser.add(rmcFix(1), fused);
+    fuser.flush(fused);
+
+    BOOST_REQUIRE_EQUAL( fused.size(), 2 );
+    BOOST_CHECK_EQUAL( *fused[0].timeOfDay, 1 );
+    BOOST_CHECK( fused[0].date );
+    BOOST_CHECK_EQUAL( *fused[1].timeOfDay, 2 );
+    BOOST_CHECK_EQUAL( fuser.lateFixes(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( Midnight )
+{
+    EpochFuser fuser {1};
+    std::vector<Fix> fused;
+
+    fuser.add(ggaFix(86399), fused);
+    fuser.add(ggaFix(0), fused);
+    fuser.flush(fused);
+
+    BOOST_REQUIRE_EQUAL( fused.size(), 2 );
+    BOOST_CHECK_EQUAL( *fused[1].timeOfDay, 0 );
+    BOOST_CHECK_EQUAL( fuser.lateFixes(), 0 );
+}
+
+// VTG sentences have no time, so belong to the latest epoch.
+BOOST_AUTO_TEST_CASE( UntimedFix )
+{
+    EpochFuser fuser;
+    std::vector<Fix> fused;
+    Fix vtg;
+    vtg.format = "VTG";
+    vtg.course = 87.5;
+
+    fuser.add(vtg, fused);
+    fuser.add(ggaFix(1), fused);
+    fuser.add(vtg, fused);
+    fuser.flush(fused);
+
+    BOOST_REQUIRE_EQUAL( fused.size(), 2 );
+    BOOST_CHECK_EQUAL( fused[0].format, "VTG" );
+    BOOST_CHECK_CLOSE( *fused[1].course, 87.5, percentageAccuracy );
+}
+
+BOOST_AUTO_TEST_CASE( FirstValueWins )
+{
+    Fix first = rmcFix(1);
+    Fix second = rmcFix(1);
+    second.groundSpeed = 9.0;
+    second.hdop = 1.5;
+
+    mergeFix(first, second);
+
+    BOOST_CHECK_CLOSE( *first.groundSpeed, 2.5, percentageAccuracy );
+    BOOST_CHECK_CLOSE( *first.hdop, 1.5, percentageAccuracy );
+}
+
+BOOST_AUTO_TEST_CASE( EmptyBuffer )
+{
+    BOOST_CHECK_THROW( EpochFuser{0}, std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
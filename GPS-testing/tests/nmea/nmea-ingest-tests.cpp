@@ -0,0 +1,218 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "dataFiles.h"
+#include "nmea-parser.h"
+#include "nmea-ingest.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( NMEA_IngestEngine )
+
+std::string readNMEAfile(std::string filename)
+{
+    const std::string filepath = DataFiles::NMEADir + filename;
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open NMEA data file: " + filepath +
+       "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::ifstream file {filepath, std::ios::binary};
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+void writeAll(int fd, const std::string& data)
+{
+    for (std::size_t written = 0; written < data.size(); )
+    {
+        const ssize_t n = ::write(fd, data.data() + written, std::min<std::size_t>(data.size() - written, 1000));
+        if (n > 0) written += n;
+    }
+}
+
+struct Pipe
+{
+    int readEnd;
+    int writeEnd;
+
+    Pipe()
+    {
+        int fds[2];
+        BOOST_REQUIRE( ::pipe(fds) == 0 );
+        readEnd = fds[0];
+        writeEnd = fds[1];
+    }
+};
+
+// Pops fixes from the devices until every device has ended and been emptied, counting positions per device.
+std::vector<std::size_t> drain(std::vector<IngestEngine::Device*>& devices)
+{
+    std::vector<std::size_t> positions(devices.size(), 0);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    Fix fix;
+    for (bool finished = false; ! finished && std::chrono::steady_clock::now() < deadline; )
+    {
+        finished = true;
+        for (std::size_t i = 0; i < devices.size(); ++i)
+        {
+            const bool ended = devices[i]->ended(); // Checked before popping, so that no fix is missed.
+            while (devices[i]->tryPop(fix)) positions[i] += fix.position.has_value();
+            finished = finished && ended;
+        }
+    }
+    return positions;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ManyDevices )
+{
+    const std::vector<std::string> logs = {readNMEAfile("gll.log"), readNMEAfile("gga_rmc-1.log"), readNMEAfile("gga_rmc-2.log")};
+    std::vector<std::size_t> expectedPositions;
+    for (const std::string& log : logs)
+    {
+        std::stringstream data {log};
+        expectedPositions.push_back(readSentences(data).size());
+    }
+
+    const std::size_t numDevices = 24;
+    IngestEngine engine {4, 4096}; // Each log arrives in one burst, so the queues must hold all of it.
+    std::vector<Pipe> pipes(numDevices);
+    std::vector<IngestEngine::Device*> devices;
+    for (Pipe& pipe : pipes) devices.push_back(&engine.addDevice(pipe.readEnd));
+
+    std::vector<std::thread> writers;
+    for (std::size_t i = 0; i < numDevices; ++i)
+    {
+        writers.emplace_back([&,i] { writeAll(pipes[i].writeEnd, logs[i % logs.size()]); ::close(pipes[i].writeEnd); });
+    }
+
+    const std::vector<std::size_t> positions = drain(devices);
+    for (std::thread& writer : writers) writer.join();
+
+    for (std::size_t i = 0; i < numDevices; ++i)
+    {
+        BOOST_CHECK( devices[i]->ended() );
+        BOOST_CHECK_EQUAL( positions[i], expectedPositions[i % logs.size()] );
+        BOOST_CHECK_EQUAL( devices[i]->droppedFixes(), 0 );
+        ::close(pipes[i].readEnd);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( DevicesSpreadAcrossShards )
+{
+    IngestEngine engine {4};
+    std::vector<Pipe> pipes(8);
+    std::vector<std::size_t> devicesPerShard(engine.shardCount(), 0);
+
+    for (Pipe& pipe : pipes) ++devicesPerShard[engine.addDevice(pipe.readEnd).shard()];
+
+    for (std::size_t count : devicesPerShard) BOOST_CHECK_EQUAL( count, 2 );
+
+    engine.stop();
+    for (Pipe& pipe : pipes)
+    {
+        ::close(pipe.readEnd);
+        ::close(pipe.writeEnd);
+    }
+}
+
+// A device that sends nothing does not hold up another on the same shard.
+BOOST_AUTO_TEST_CASE( SilentDeviceDoesNotBlock )
+{
+    IngestEngine engine {1};
+    Pipe silent, busy;
+    engine.addDevice(silent.readEnd);
+    std::vector<IngestEngine::Device*> devices = {&engine.addDevice(busy.readEnd)};
+
+    writeAll(busy.writeEnd, "$GPGLL,5425.31,N,107.03,W,82610*69\n");
+    ::close(busy.writeEnd);
+
+    BOOST_CHECK_EQUAL( drain(devices)[0], 1 );
+
+    engine.stop();
+    for (int fd : {silent.readEnd, silent.writeEnd, busy.readEnd}) ::close(fd);
+}
+
+// A consumer that falls behind loses fixes, rather than stalling the shard.
+BOOST_AUTO_TEST_CASE( FullQueueDropsFixes )
+{
+    IngestEngine engine {1, 4};
+    Pipe pipe;
+    IngestEngine::Device& device = engine.addDevice(pipe.readEnd);
+
+    std::string data;
+    for (int i = 0; i < 10; ++i) data += "$GPGLL,5425.31,N,107.03,W,82610*69\n";
+    writeAll(pipe.writeEnd, data);
+    ::close(pipe.writeEnd);
+
+    while (! device.ended()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    Fix fix;
+    std::size_t popped = 0;
+    while (device.tryPop(fix)) ++popped;
+    BOOST_CHECK_EQUAL( popped, 4 );
+    BOOST_CHECK_EQUAL( device.droppedFixes(), 6 );
+    ::close(pipe.readEnd);
+}
+
+// Removing a device that is still open restores its descriptor, which can then be closed.
+BOOST_AUTO_TEST_CASE( RemoveOpenDevice )
+{
+    IngestEngine engine {1};
+    Pipe silent, busy;
+    const int originalFlags = ::fcntl(silent.readEnd, F_GETFL);
+    IngestEngine::Device& device = engine.addDevice(silent.readEnd);
+    std::vector<IngestEngine::Device*> devices = {&engine.addDevice(busy.readEnd)};
+
+    engine.removeDevice(device);
+    BOOST_CHECK_EQUAL( ::fcntl(silent.readEnd, F_GETFL), originalFlags );
+    for (int fd : {silent.readEnd, silent.writeEnd}) ::close(fd);
+
+    // The other device on the shard is unaffected.
+    writeAll(busy.writeEnd, "$GPGLL,5425.31,N,107.03,W,82610*69\n");
+    ::close(busy.writeEnd);
+    BOOST_CHECK_EQUAL( drain(devices)[0], 1 );
+
+    engine.removeDevice(*devices[0]);
+    ::close(busy.readEnd);
+}
+
+// A device that has ended has already restored its descriptor, and can still be removed.
+BOOST_AUTO_TEST_CASE( RemoveEndedDevice )
+{
+    IngestEngine engine {1};
+    Pipe pipe;
+    const int originalFlags = ::fcntl(pipe.readEnd, F_GETFL);
+    IngestEngine::Device& device = engine.addDevice(pipe.readEnd);
+
+    ::close(pipe.writeEnd);
+    while (! device.ended()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    BOOST_CHECK_EQUAL( ::fcntl(pipe.readEnd, F_GETFL), originalFlags );
+    ::close(pipe.readEnd);
+
+    engine.removeDevice(device);
+    BOOST_CHECK_THROW( engine.removeDevice(device), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( StoppedEngine )
+{
+    IngestEngine engine {2};
+    engine.stop();
+
+    BOOST_CHECK_THROW( engine.addDevice(0), std::logic_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
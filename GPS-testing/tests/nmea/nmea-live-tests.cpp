@@ -0,0 +1,340 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+#include <array>
+#include <memory>
+#include <optional>
+#include <atomic>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "dataFiles.h"
+#include "nmea-parser.h"
+#include "nmea-live.h"
+#include "io-events.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( LiveInput )
+
+std::string readNMEAfile(std::string filename)
+{
+    const std::string filepath = DataFiles::NMEADir + filename;
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open NMEA data file: " + filepath +
+       "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::ifstream file {filepath, std::ios::binary};
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Writes the data in pieces of the given size, pausing between them, as a device would.
+void writeInPieces(int fd, const std::string& data, std::size_t pieceSize, std::chrono::microseconds pause)
+{
+    for (std::size_t start = 0; start < data.size(); start += pieceSize)
+    {
+        const std::string piece = data.substr(start, pieceSize);
+        for (std::size_t written = 0; written < piece.size(); )
+        {
+            const ssize_t n = ::write(fd, piece.data() + written, piece.size() - written);
+            if (n > 0) written += n;
+        }
+        if (pause.count() > 0) std::this_thread::sleep_for(pause);
+    }
+}
+
+// Counts the sentences that readSentences() would read: those with a position.
+std::size_t countPositions(const std::vector<Fix>& fixes)
+{
+    std::size_t positions = 0;
+    for (const Fix& fix : fixes) positions += fix.position.has_value();
+    return positions;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( PipeInSmallPieces )
+{
+    const std::string data = readNMEAfile("gga_rmc-1.log");
+    int pipeFds[2];
+    BOOST_REQUIRE( ::pipe(pipeFds) == 0 );
+
+    std::thread writer([&] { writeInPieces(pipeFds[1], data, 37, std::chrono::microseconds(10)); ::close(pipeFds[1]); });
+
+    std::vector<Fix> fixes;
+    LiveReader reader {pipeFds[0], [&](const Fix& fix) {fixes.push_back(fix);}};
+    reader.run();
+    writer.join();
+    ::close(pipeFds[0]);
+
+    BOOST_CHECK( reader.ended() );
+    BOOST_CHECK_EQUAL( countPositions(fixes), 632 );
+    BOOST_CHECK_EQUAL( fixes.front().format, "GGA" );
+    BOOST_CHECK_EQUAL( fixes.back().format, "RMC" );
+}
+
+// A buffer barely longer than a sentence makes lines wrap around the end of the ring.
+BOOST_AUTO_TEST_CASE( LinesWrapAroundBuffer )
+{
+    const std::string data = readNMEAfile("gll.log");
+    std::stringstream expectedData {data};
+    const std::size_t expected = readSentences(expectedData).size();
+    int pipeFds[2];
+    BOOST_REQUIRE( ::pipe(pipeFds) == 0 );
+
+    std::thread writer([&] { writeInPieces(pipeFds[1], data, 4096, std::chrono::microseconds(0)); ::close(pipeFds[1]); });
+
+    std::vector<Fix> fixes;
+    LiveReader reader {pipeFds[0], [&](const Fix& fix) {fixes.push_back(fix);}, 61};
+    reader.run();
+    writer.join();
+    ::close(pipeFds[0]);
+
+    BOOST_CHECK_EQUAL( countPositions(fixes), expected );
+    BOOST_CHECK_EQUAL( reader.discardedLines(), 0 );
+}
+
+// Replays a log through a pseudo-terminal, as a GPS receiver on a serial port would appear.
+BOOST_AUTO_TEST_CASE( PseudoTerminal )
+{
+    const std::string data = readNMEAfile("gga_rmc-2.log");
+    std::stringstream expectedData {data};
+    const std::size_t expected = readSentences(expectedData).size();
+
+    const int master = ::posix_openpt(O_RDWR | O_NOCTTY);
+    BOOST_REQUIRE( master >= 0 );
+    BOOST_REQUIRE( ::grantpt(master) == 0 && ::unlockpt(master) == 0 );
+    const int device = ::open(::ptsname(master), O_RDWR | O_NOCTTY);
+    BOOST_REQUIRE( device >= 0 );
+
+    // Raw mode, so that line endings pass through unchanged.
+    termios settings;
+    ::tcgetattr(device, &settings);
+    ::cfmakeraw(&settings);
+    ::tcsetattr(device, TCSANOW, &settings);
+
+    std::thread writer([&] { writeInPieces(device, data, 512, std::chrono::microseconds(50)); ::close(device); });
+
+    std::vector<Fix> fixes;
+    LiveReader reader {master, [&](const Fix& fix) {fixes.push_back(fix);}};
+    reader.run();
+    writer.join();
+    ::close(master);
+
+    BOOST_CHECK( reader.ended() );
+    BOOST_CHECK_EQUAL( countPositions(fixes), expected );
+}
+
+// Each sentence is delivered as soon as its line is complete.
+BOOST_AUTO_TEST_CASE( DeliveredWithoutWaiting )
+{
+    int pipeFds[2];
+    BOOST_REQUIRE( ::pipe(pipeFds) == 0 );
+    std::vector<Fix> fixes;
+    LiveReader reader {pipeFds[0], [&](const Fix& fix) {fixes.push_back(fix);}};
+
+    writeInPieces(pipeFds[1], "$GPGLL,5425.31,N,107.03,W,82610*69\n$GPGLL,5425.", 1000, std::chrono::microseconds(0));
+    BOOST_CHECK( reader.poll() );
+    BOOST_CHECK_EQUAL( fixes.size(), 1 );
+
+    writeInPieces(pipeFds[1], "31,N,107.03,W,82610*69", 1000, std::chrono::microseconds(0)); // No final newline.
+    BOOST_CHECK( reader.poll(std::chrono::milliseconds(100)) );
+    BOOST_CHECK_EQUAL( fixes.size(), 1 );
+
+    ::close(pipeFds[1]);
+    BOOST_CHECK( ! reader.poll() );
+    BOOST_CHECK_EQUAL( fixes.size(), 2 );
+    ::close(pipeFds[0]);
+}
+
+BOOST_AUTO_TEST_CASE( OverlongLineDiscarded )
+{
+    int pipeFds[2];
+    BOOST_REQUIRE( ::pipe(pipeFds) == 0 );
+    std::vector<Fix> fixes;
+    LiveReader reader {pipeFds[0], [&](const Fix& fix) {fixes.push_back(fix);}, 64};
+
+    writeInPieces(pipeFds[1], std::string(200, 'x') + "\n$GPGLL,5425.31,N,107.03,W,82610*69\n", 1000, std::chrono::microseconds(0));
+    ::close(pipeFds[1]);
+    reader.run();
+    ::close(pipeFds[0]);
+
+    BOOST_CHECK_EQUAL( reader.discardedLines(), 1 );
+    BOOST_CHECK_EQUAL( fixes.size(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( StopFromCallback )
+{
+    int pipeFds[2];
+    BOOST_REQUIRE( ::pipe(pipeFds) == 0 );
+    std::size_t numFixes = 0;
+    LiveReader* readerPtr = nullptr;
+    LiveReader reader {pipeFds[0], [&](const Fix&) { ++numFixes; readerPtr->stop(); }};
+    readerPtr = &reader;
+
+    writeInPieces(pipeFds[1], "$GPGLL,5425.31,N,107.03,W,82610*69\n", 1000, std::chrono::microseconds(0));
+    reader.run(std::chrono::milliseconds(10)); // The pipe stays open, so only stop() ends the run.
+
+    BOOST_CHECK_EQUAL( numFixes, 1 );
+    BOOST_CHECK( ! reader.ended() );
+    ::close(pipeFds[1]);
+    ::close(pipeFds[0]);
+}
+
+// One event-loop thread parses many streams, resuming each generator when its pipe is readable.
+BOOST_AUTO_TEST_CASE( GeneratorsOnEventLoop )
+{
+    const std::vector<std::string> logs = {readNMEAfile("gll.log"), readNMEAfile("gga_rmc-1.log"), readNMEAfile("gga_rmc-2.log")};
+    std::vector<std::size_t> expected;
+    for (const std::string& log : logs)
+    {
+        std::stringstream data {log};
+        expected.push_back(readSentences(data).size());
+    }
+
+    const std::size_t numStreams = 48;
+    std::vector<std::array<int,2>> pipes(numStreams);
+    std::vector<std::unique_ptr<FixGenerator>> generators;
+    std::vector<std::vector<Fix>> fixes(numStreams);
+    IO::EventLoop loop;
+    for (std::size_t i = 0; i < numStreams; ++i)
+    {
+        BOOST_REQUIRE( ::pipe(pipes[i].data()) == 0 );
+        generators.push_back(std::make_unique<FixGenerator>(pipes[i][0]));
+        loop.watch(pipes[i][0], [&,i]
+        {
+            while (std::optional<Fix> fix = generators[i]->next()) fixes[i].push_back(*fix);
+            return ! generators[i]->ended();
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (std::size_t i = 0; i < numStreams; ++i)
+    {
+        writers.emplace_back([&,i] { writeInPieces(pipes[i][1], logs[i % logs.size()], 301, std::chrono::microseconds(20)); ::close(pipes[i][1]); });
+    }
+
+    loop.run();
+    for (std::thread& writer : writers) writer.join();
+
+    BOOST_CHECK_EQUAL( loop.size(), 0 );
+    for (std::size_t i = 0; i < numStreams; ++i)
+    {
+        BOOST_CHECK( generators[i]->ended() );
+        BOOST_CHECK_EQUAL( countPositions(fixes[i]), expected[i % logs.size()] );
+        ::close(pipes[i][0]);
+    }
+}
+
+// A device that sends continuously does not starve another stream on the same event loop.
+BOOST_AUTO_TEST_CASE( GeneratorsShareEventLoopWithFlood )
+{
+    const std::string log = readNMEAfile("gll.log");
+    std::stringstream data {log};
+    const std::size_t expected = readSentences(data).size();
+
+    int floodFds[2];
+    int quietFds[2];
+    BOOST_REQUIRE( ::pipe(floodFds) == 0 );
+    BOOST_REQUIRE( ::pipe(quietFds) == 0 );
+    BOOST_REQUIRE( ::fcntl(floodFds[1], F_SETFL, O_NONBLOCK) == 0 );
+
+    // Keeps the pipe full until told to stop.
+    std::atomic<bool> flooding {true};
+    std::thread flooder([&]
+    {
+        std::string sentences;
+        for (int i = 0; i < 100; ++i) sentences += "$GPGLL,5425.31,N,107.03,W,82610*69\n";
+        while (flooding)
+        {
+            if (::write(floodFds[1], sentences.data(), sentences.size()) < 0) std::this_thread::yield();
+        }
+        ::close(floodFds[1]);
+    });
+
+    FixGenerator flood {floodFds[0]};
+    FixGenerator quiet {quietFds[0]};
+    std::size_t floodFixes = 0;
+    std::vector<Fix> quietFixes;
+    IO::EventLoop loop;
+    loop.watch(floodFds[0], [&]
+    {
+        // Processing each fix takes longer than sending it.
+        while (flood.next())
+        {
+            ++floodFixes;
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+        }
+        return true;
+    });
+    loop.watch(quietFds[0], [&]
+    {
+        while (std::optional<Fix> fix = quiet.next()) quietFixes.push_back(*fix);
+        if (quiet.ended()) loop.stop();
+        return ! quiet.ended();
+    });
+
+    std::thread writer([&] { writeInPieces(quietFds[1], log, 301, std::chrono::microseconds(20)); ::close(quietFds[1]); });
+    // Should the quiet stream be starved, ending the flood lets the loop stop.
+    std::atomic<bool> finished {false};
+    std::thread watchdog([&]
+    {
+        for (int i = 0; i < 50 && ! finished; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        flooding = false;
+        loop.stop();
+    });
+
+    loop.run(std::chrono::milliseconds(10));
+    finished = true;
+    flooding = false;
+    writer.join();
+    flooder.join();
+    watchdog.join();
+
+    BOOST_CHECK( quiet.ended() );
+    BOOST_CHECK_EQUAL( countPositions(quietFixes), expected );
+    BOOST_CHECK( floodFixes > 0 );
+    ::close(floodFds[0]);
+    ::close(quietFds[0]);
+}
+
+// The generator yields what has arrived, and resumes where it left off.
+BOOST_AUTO_TEST_CASE( GeneratorResumes )
+{
+    int pipeFds[2];
+    BOOST_REQUIRE( ::pipe(pipeFds) == 0 );
+    FixGenerator generator {pipeFds[0]};
+
+    BOOST_CHECK( ! generator.next() );
+    writeInPieces(pipeFds[1], "$GPGLL,5425.32,N,107.11,W,82319*65\n$GPGLL,5425.3", 100, std::chrono::microseconds(0));
+    BOOST_CHECK( generator.next().has_value() );
+    BOOST_CHECK( ! generator.next() );
+    BOOST_CHECK( ! generator.ended() );
+
+    writeInPieces(pipeFds[1], "2,N,107.1,W,82429*50", 100, std::chrono::microseconds(0));
+    ::close(pipeFds[1]);
+    const std::optional<Fix> last = generator.next();
+    BOOST_REQUIRE( last.has_value() );
+    BOOST_CHECK_EQUAL( *last->timeOfDay, 8 * 3600 + 24 * 60 + 29 );
+    BOOST_CHECK( ! generator.next() );
+    BOOST_CHECK( generator.ended() );
+    ::close(pipeFds[0]);
+}
+
+BOOST_AUTO_TEST_CASE( InvalidDescriptor )
+{
+    BOOST_CHECK_THROW( (LiveReader{-1, [](const Fix&) {}}), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
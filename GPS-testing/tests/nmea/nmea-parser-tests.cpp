@@ -1,12 +1,15 @@
 #include <boost/test/unit_test.hpp>
 
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <vector>
 #include <utility>
+#include <iterator>
 #include <ostream>
 #include <fstream>
 #include <sstream>
+#include <filesystem>
 
 #include "dataFiles.h"
 #include "nmea-parser.h"
@@ -151,6 +154,16 @@ BOOST_AUTO_TEST_CASE( InvalidLettersPrefix )
     BOOST_CHECK( ! hasValidSentenceStructure("$XXX,*01") );
 }
 
+BOOST_AUTO_TEST_CASE( MultiConstellationTalkers )
+{
+    BOOST_CHECK( hasValidSentenceStructure("$GNGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*64") );
+    BOOST_CHECK( hasValidSentenceStructure("$GLXXX,*01") );
+    BOOST_CHECK( hasValidSentenceStructure("$GAXXX,*01") );
+    BOOST_CHECK( hasValidSentenceStructure("$GBXXX,*01") );
+    BOOST_CHECK( hasValidSentenceStructure("$BDXXX,*01") );
+    BOOST_CHECK( ! hasValidSentenceStructure("$GnXXX,*01") );
+}
+
 BOOST_AUTO_TEST_CASE( InvalidFormatCode )
 {
     BOOST_CHECK( ! hasValidSentenceStructure("$GP,*01") );
@@ -381,6 +394,97 @@ BOOST_AUTO_TEST_SUITE_END()
 
 /////////////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_SUITE( ScanSentence )
+
+BOOST_AUTO_TEST_CASE( ValidSentence )
+{
+    const std::string sentence = "$GPGGA,114530.000,3722.6279,N,00559.1566,W,1,0,,1.0,M,,M,,*4E";
+    const std::vector<std::string_view> expectedFields = {"114530.000","3722.6279","N","00559.1566","W","1","0","","1.0","M","","M","",""};
+    SentenceView sentenceView;
+
+    BOOST_REQUIRE( scanSentence(sentence, sentenceView) == ScanResult::valid );
+    BOOST_CHECK_EQUAL( sentenceView.format, "GGA" );
+    BOOST_CHECK( sentenceView.dataFields == expectedFields );
+}
+
+// The views refer into the scanned sentence, rather than to copies.
+BOOST_AUTO_TEST_CASE( FieldsAreViewsIntoSentence )
+{
+    const std::string sentence = "$GPGLL,5425.31,N,107.03,W,82610*69";
+    SentenceView sentenceView;
+
+    BOOST_REQUIRE( scanSentence(sentence, sentenceView) == ScanResult::valid );
+    BOOST_REQUIRE_EQUAL( sentenceView.dataFields.size(), 5 );
+    BOOST_CHECK( sentenceView.format.data() == sentence.data() + 3 );
+    BOOST_CHECK( sentenceView.dataFields[0].data() == sentence.data() + 7 );
+}
+
+BOOST_AUTO_TEST_CASE( ChecksumMismatch )
+{
+    SentenceView sentenceView;
+
+    BOOST_CHECK( scanSentence("$GPGLL,5425.31,N,107.03,W,82610*24", sentenceView) == ScanResult::checksumMismatch );
+    BOOST_CHECK_EQUAL( sentenceView.dataFields.size(), 5 );
+}
+
+BOOST_AUTO_TEST_CASE( InvalidStructures )
+{
+    SentenceView sentenceView;
+
+    BOOST_CHECK( scanSentence("", sentenceView) == ScanResult::invalidStructure );
+    BOOST_CHECK( scanSentence("$GQXXX,*01", sentenceView) == ScanResult::invalidStructure );
+    BOOST_CHECK( scanSentence("$GPXXX,$77*01", sentenceView) == ScanResult::invalidStructure );
+    BOOST_CHECK( scanSentence("$GPXXX,*012", sentenceView) == ScanResult::invalidStructure );
+    BOOST_CHECK( scanSentence("$GPXXX,*g3", sentenceView) == ScanResult::invalidStructure );
+    BOOST_CHECK( scanSentence("$GPGLL,5425.31,N,107.03,W,82610", sentenceView) == ScanResult::invalidStructure );
+    BOOST_CHECK( sentenceView.dataFields.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( TalkerRecorded )
+{
+    SentenceView sentenceView;
+
+    BOOST_REQUIRE( scanSentence("$GNRMC,094627.000,A,3723.1622,N,00559.5788,W,0.000,0.00,150914,,A*71", sentenceView) == ScanResult::valid );
+    BOOST_CHECK( sentenceView.talker == Talker::multiple );
+    BOOST_CHECK_EQUAL( sentenceView.format, "RMC" );
+
+    BOOST_REQUIRE( scanSentence("$BDGLL,5425.31,N,107.03,W,82610*78", sentenceView) == ScanResult::valid );
+    BOOST_CHECK( sentenceView.talker == Talker::beidou );
+
+    BOOST_REQUIRE( scanSentence("$GPGLL,5425.31,N,107.03,W,82610*69", sentenceView) == ScanResult::valid );
+    BOOST_CHECK( sentenceView.talker == Talker::gps );
+
+    // The checksum covers the talker ID.
+    BOOST_CHECK( scanSentence("$GLGLL,5425.31,N,107.03,W,82610*69", sentenceView) == ScanResult::checksumMismatch );
+}
+
+BOOST_AUTO_TEST_CASE( TalkerTable )
+{
+    static_assert( std::size(acceptedTalkers) == 6 );
+
+    Talker talker = Talker::gps;
+    BOOST_CHECK( findTalker('G','A', talker) && talker == Talker::galileo );
+    BOOST_CHECK( findTalker('G','B', talker) && talker == Talker::beidou );
+    BOOST_CHECK( ! findTalker('G','Q', talker) );
+}
+
+// A reused view does not retain fields from the previous sentence.
+BOOST_AUTO_TEST_CASE( ReusedView )
+{
+    SentenceView sentenceView;
+
+    scanSentence("$GPRMC,115856.000,A,3722.6710,N,00559.3014,W,0.000,0.00,150914,,A*6d", sentenceView);
+    BOOST_REQUIRE( scanSentence("$GPAAA,1*4b", sentenceView) == ScanResult::valid );
+
+    BOOST_CHECK_EQUAL( sentenceView.format, "AAA" );
+    BOOST_REQUIRE_EQUAL( sentenceView.dataFields.size(), 1 );
+    BOOST_CHECK_EQUAL( sentenceView.dataFields[0], "1" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE( HasCorrectNumberOfFields )
 
 BOOST_AUTO_TEST_CASE( CorrectGLL )
@@ -679,6 +783,203 @@ BOOST_AUTO_TEST_SUITE_END()
 
 /////////////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_SUITE( DecodePositionSentence )
+
+DecodeStatus decodeStatus(std::string line)
+{
+    SentenceView sentenceView;
+    degrees lat, lon;
+    metres ele;
+    return decodePositionSentence(line, sentenceView, lat, lon, ele);
+}
+
+BOOST_AUTO_TEST_CASE( ValidSentence )
+{
+    SentenceView sentenceView;
+    degrees lat = 0, lon = 0;
+    metres ele = 0;
+
+    BOOST_REQUIRE( decodePositionSentence("$GPGGA,114530.000,3722.6279,N,00559.1566,W,1,0,,1.0,M,,M,,*4E\r", sentenceView, lat, lon, ele) == DecodeStatus::ok );
+    BOOST_CHECK_CLOSE( lat, ddmTodd("3722.6279"), 0.0001 );
+    BOOST_CHECK_CLOSE( lon, -ddmTodd("00559.1566"), 0.0001 );
+    BOOST_CHECK_CLOSE( ele, 1.0, 0.0001 );
+}
+
+BOOST_AUTO_TEST_CASE( EachReason )
+{
+    BOOST_CHECK( decodeStatus("@Sonygps/ver3.0/wgs-84/") == DecodeStatus::invalidStructure );
+    BOOST_CHECK( decodeStatus("$GPGLL,5425.31,N,107.03,W,82610*24") == DecodeStatus::checksumMismatch );
+    BOOST_CHECK( decodeStatus("$GPBOD,045.,T,023.,M,DEST,START*01") == DecodeStatus::unsupportedFormat );
+    BOOST_CHECK( decodeStatus("$GPGSV,1,1,02,65,40,083,46,66,17,308,41*7D") == DecodeStatus::noPosition );
+    BOOST_CHECK( decodeStatus("$GPGLL,5425.31,N,107.03,W*78") == DecodeStatus::wrongNumberOfFields );
+    BOOST_CHECK( decodeStatus("$GPGGA,114530.000,3722.6279,X,00559.1566,W,1,0,,1.0,M,,M,,*58") == DecodeStatus::badBearing );
+    BOOST_CHECK( decodeStatus("$GPGLL,54x25.31,N,107.03,W,82610*11") == DecodeStatus::malformedNumber );
+    BOOST_CHECK( decodeStatus("$GPGGA,114530.000,3722.6279,N,00559.1566,W,1,0,,high,M,,M,,*6F") == DecodeStatus::malformedNumber );
+    BOOST_CHECK( decodeStatus("$GPGLL,9125.31,N,107.03,W,82610*60") == DecodeStatus::outOfRange );
+    BOOST_CHECK( decodeStatus("$GPGLL,5425.31,N,18107.03,W,82610*60") == DecodeStatus::outOfRange );
+}
+
+BOOST_AUTO_TEST_CASE( CountersAfterRun )
+{
+    std::stringstream sentences;
+    sentences << "@Sonygps/ver3.0/wgs-84/" << '\n'
+              << "$GPGLL,5425.31,N,107.03,W,82610*69" << '\n'
+              << "$GPGLL,5425.31,N,107.03,W,82610*24" << '\n'
+              << "$GPGLL,5425.31,N,107.03,W,82610*24" << '\n'
+              << "$GPGGA,114530.000,3722.6279,X,00559.1566,W,1,0,,1.0,M,,M,,*58" << '\n'
+              << '\n'
+              << "\r\n"
+              << "$GPGLL,9125.31,N,107.03,W,82610*60" << "\r\n";
+    DecodeCounters counters;
+
+    std::vector<Position> positions = readSentences(sentences, counters);
+
+    BOOST_CHECK_EQUAL( positions.size(), 1 );
+    BOOST_CHECK_EQUAL( counters[DecodeStatus::ok], 1 );
+    BOOST_CHECK_EQUAL( counters[DecodeStatus::invalidStructure], 1 );
+    BOOST_CHECK_EQUAL( counters[DecodeStatus::checksumMismatch], 2 );
+    BOOST_CHECK_EQUAL( counters[DecodeStatus::badBearing], 1 );
+    BOOST_CHECK_EQUAL( counters[DecodeStatus::outOfRange], 1 );
+    BOOST_CHECK_EQUAL( counters.rejected(), 5 ); // Blank lines are not counted.
+}
+
+BOOST_AUTO_TEST_CASE( CountersAccumulate )
+{
+    const std::string filepath = DataFiles::NMEADir + "gga_rmc-1.log";
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open NMEA data file: " + filepath +
+       "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    DecodeCounters counters;
+
+    for (int run = 0; run < 2; ++run)
+    {
+        std::fstream sentences {filepath};
+        BOOST_CHECK_EQUAL( readSentences(sentences, counters).size(), 632 );
+    }
+
+    BOOST_CHECK_EQUAL( counters[DecodeStatus::ok], 2 * 632 );
+    BOOST_CHECK_EQUAL( counters[DecodeStatus::invalidStructure], 2 ); // The header line.
+
+    DecodeCounters total;
+    total += counters;
+    total += counters;
+    BOOST_CHECK_EQUAL( total.rejected(), 4 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( QualityFilters )
+
+const std::string noFix        = "$GPGGA,114530.000,3722.6279,N,00559.1566,W,0,0,,1.0,M,,M,,*4F";
+const std::string weakFix      = "$GPGGA,114530.000,3722.6279,N,00559.1566,W,1,03,4.5,1.0,M,,M,,*52";
+const std::string strongFix    = "$GPGGA,114530.000,3722.6279,N,00559.1566,W,2,09,0.9,1.0,M,,M,,*53";
+const std::string unfilledFix  = "$GPGGA,114530.000,3722.6279,N,00559.1566,W,1,0,,1.0,M,,M,,*4E"; // No HDOP.
+const std::string weakGNS      = "$GPGNS,114530.000,3722.6279,N,00559.1566,W,AA,03,4.5,1.0,,,*78";
+const std::string gll          = "$GPGLL,5425.31,N,107.03,W,82610*69";
+
+DecodeStatus decodeStatus(std::string line, const QualityFilter& filter)
+{
+    SentenceView sentenceView;
+    degrees lat, lon;
+    metres ele;
+    return decodePositionSentence(line, sentenceView, filter, lat, lon, ele);
+}
+
+BOOST_AUTO_TEST_CASE( DefaultRejectsOnlyMissingFixes )
+{
+    const QualityFilter filter;
+
+    BOOST_CHECK( decodeStatus(noFix, filter) == DecodeStatus::poorQuality );
+    BOOST_CHECK( decodeStatus(weakFix, filter) == DecodeStatus::ok );
+    BOOST_CHECK( decodeStatus(unfilledFix, filter) == DecodeStatus::ok );
+    BOOST_CHECK( decodeStatus(weakGNS, filter) == DecodeStatus::ok );
+    BOOST_CHECK( decodeStatus(gll, filter) == DecodeStatus::ok );
+}
+
+BOOST_AUTO_TEST_CASE( Thresholds )
+{
+    QualityFilter filter;
+    filter.minSatellites = 4;
+    filter.maxHdop = 2.0;
+
+    BOOST_CHECK( decodeStatus(weakFix, filter) == DecodeStatus::poorQuality );
+    BOOST_CHECK( decodeStatus(weakGNS, filter) == DecodeStatus::poorQuality );
+    BOOST_CHECK( decodeStatus(strongFix, filter) == DecodeStatus::ok );
+
+    filter.minSatellites = 0;
+    BOOST_CHECK( decodeStatus(weakFix, filter) == DecodeStatus::poorQuality ); // HDOP 4.5
+
+    filter.maxHdop = 5.0;
+    filter.minQuality = 2;
+    BOOST_CHECK( decodeStatus(weakFix, filter) == DecodeStatus::poorQuality );
+    BOOST_CHECK( decodeStatus(weakGNS, filter) == DecodeStatus::ok ); // GNS has no quality indicator.
+    BOOST_CHECK( decodeStatus(strongFix, filter) == DecodeStatus::ok );
+}
+
+// Formats, and sentences, without the quality fields are not rejected for lacking them.
+BOOST_AUTO_TEST_CASE( AbsentFieldsPass )
+{
+    QualityFilter filter;
+    filter.minSatellites = 4;
+    filter.maxHdop = 2.0;
+
+    BOOST_CHECK( decodeStatus(gll, filter) == DecodeStatus::ok );
+
+    filter.minSatellites = 0;
+    BOOST_CHECK( decodeStatus(unfilledFix, filter) == DecodeStatus::ok );
+}
+
+// The quality fields are checked before the coordinates are decoded.
+BOOST_AUTO_TEST_CASE( CheckedBeforeCoordinates )
+{
+    const QualityFilter filter;
+
+    BOOST_CHECK( decodeStatus("$GPGGA,114530.000,3722.6279,X,00559.1566,W,0,0,,1.0,M,,M,,*59", filter) == DecodeStatus::poorQuality );
+    BOOST_CHECK( decodeStatus("$GPGGA,114530.000,3722.6279,N,00559.1566,W,x,0,,1.0,M,,M,,*07", filter) == DecodeStatus::malformedNumber );
+}
+
+// Without a filter, nothing is rejected for its quality.
+BOOST_AUTO_TEST_CASE( UnfilteredAcceptsAll )
+{
+    std::stringstream sentences;
+    sentences << noFix << '\n' << weakFix << '\n' << strongFix << '\n';
+
+    BOOST_CHECK_EQUAL( readSentences(sentences).size(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( ReadWithFilter )
+{
+    std::stringstream sentences;
+    sentences << noFix << '\n' << weakFix << '\n' << strongFix << '\n' << gll << '\n';
+    QualityFilter filter;
+    filter.minSatellites = 4;
+    DecodeCounters counters;
+
+    std::vector<Position> positions = readSentences(sentences, filter, counters);
+
+    BOOST_CHECK_EQUAL( positions.size(), 2 );
+    BOOST_CHECK_EQUAL( counters[DecodeStatus::ok], 2 );
+    BOOST_CHECK_EQUAL( counters[DecodeStatus::poorQuality], 2 );
+    BOOST_CHECK_EQUAL( counters.rejected(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( LogsPassDefaultFilter )
+{
+    const std::string filepath = DataFiles::NMEADir + "gga_rmc-1.log";
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open NMEA data file: " + filepath +
+       "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::fstream sentences {filepath};
+
+    BOOST_CHECK_EQUAL( readSentences(sentences, QualityFilter{}).size(), 632 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE( ReadSentences )
 
 const double percentageAccuracy = 0.0001;
@@ -692,6 +993,22 @@ const GPS::Position gllPos = GPS::Position("5425.31",'N',"107.03",'W',"0");
 const GPS::Position rmcPos = GPS::Position("3722.5993",'N',"00559.2458",'W',"0");
 const GPS::Position ggaPos = GPS::Position("3722.6279",'N',"00559.1566",'W',"1.0");
 
+BOOST_AUTO_TEST_CASE( MultiConstellationStream )
+{
+    std::stringstream sentences;
+    sentences << "$GNGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*64" << std::endl
+              << "$GNRMC,094627.000,A,3723.1622,N,00559.5788,W,0.000,0.00,150914,,A*71" << std::endl
+              << "$GLGSV,1,1,02,65,40,083,46,66,17,308,41*61" << std::endl
+              << "$GAGLL,5425.31,N,107.03,W,82610*78" << std::endl
+              << validGLLSentence << std::endl;
+
+    std::vector<Position> positions = readSentences(sentences);
+
+    BOOST_REQUIRE_EQUAL( positions.size(), 4 );
+    BOOST_CHECK_CLOSE( positions[0].elevation(), 30.0, percentageAccuracy );
+    BOOST_CHECK_CLOSE( positions[2].latitude(), gllPos.latitude(), percentageAccuracy );
+}
+
 BOOST_AUTO_TEST_CASE( EmptyStream )
 {
     std::stringstream sentences("");
@@ -857,6 +1174,76 @@ BOOST_AUTO_TEST_CASE( InvalidFields )
     BOOST_CHECK_EQUAL( positions.size() , expectedSize );
 }
 
+BOOST_AUTO_TEST_CASE( CarriageReturnLineEndings )
+{
+    std::stringstream sentences;
+    sentences << validGLLSentence << "\r\n";
+    sentences << validRMCSentence << "\r\n";
+    const unsigned int expectedSize = 2;
+
+    std::vector<Position> positions = readSentences(sentences);
+
+    BOOST_CHECK_EQUAL( positions.size() , expectedSize );
+}
+
+BOOST_AUTO_TEST_CASE( FinalLineUnterminated )
+{
+    std::stringstream sentences;
+    sentences << validGLLSentence << std::endl;
+    sentences << validRMCSentence;
+    const unsigned int expectedSize = 2;
+
+    std::vector<Position> positions = readSentences(sentences);
+
+    BOOST_CHECK_EQUAL( positions.size() , expectedSize );
+}
+
+// Enough data that many sentences straddle the boundaries between the blocks that are read.
+BOOST_AUTO_TEST_CASE( ManySentences )
+{
+    std::stringstream sentences;
+    const unsigned int repetitions = 5000;
+    for (unsigned int i = 0; i < repetitions; ++i)
+    {
+        sentences << validGLLSentence << std::endl << validMSSSentence << std::endl << validGGASentence << std::endl;
+    }
+    const unsigned int expectedSize = 2 * repetitions;
+
+    std::vector<Position> positions = readSentences(sentences);
+
+    BOOST_REQUIRE_EQUAL( positions.size() , expectedSize );
+    BOOST_CHECK_CLOSE( positions.back().latitude(), ggaPos.latitude(), percentageAccuracy );
+    BOOST_CHECK_CLOSE( positions.back().elevation(), ggaPos.elevation(), percentageAccuracy );
+}
+
+BOOST_AUTO_TEST_CASE( VeryLongLine )
+{
+    std::stringstream sentences;
+    sentences << validGLLSentence << std::endl;
+    sentences << std::string(200000,'X') << std::endl;
+    sentences << validRMCSentence << std::endl;
+    const unsigned int expectedSize = 2;
+
+    std::vector<Position> positions = readSentences(sentences);
+
+    BOOST_CHECK_EQUAL( positions.size() , expectedSize );
+}
+
+BOOST_AUTO_TEST_CASE( ProgressMonitorCountsPositions )
+{
+    std::stringstream sentences;
+    sentences << validGLLSentence << std::endl;
+    sentences << validMSSSentence << std::endl;
+    sentences << validRMCSentence << std::endl;
+    IO::ProgressMonitor monitor;
+
+    std::vector<Position> positions = readSentences(sentences, monitor);
+
+    BOOST_CHECK_EQUAL( positions.size() , 2 );
+    BOOST_CHECK_EQUAL( monitor.progress().pointsProduced , 2 );
+    BOOST_CHECK_EQUAL( monitor.progress().bytesConsumed , sentences.str().size() );
+}
+
 std::fstream openNMEAfile(std::string filename)
 {
     std::string dataFilepath = DataFiles::NMEADir + filename;
@@ -920,3 +1307,75 @@ BOOST_AUTO_TEST_CASE( LargeFileGGA_RMC )
 BOOST_AUTO_TEST_SUITE_END()
 
 /////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( ReadSentencesParallel )
+
+std::string nmeaFilepath(std::string filename)
+{
+    const std::string filepath = DataFiles::NMEADir + filename;
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open NMEA data file: " + filepath +
+       "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    return filepath;
+}
+
+void checkSamePositions(const std::vector<Position>& actual, const std::vector<Position>& expected)
+{
+    BOOST_REQUIRE_EQUAL( actual.size(), expected.size() );
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+        BOOST_REQUIRE_EQUAL( actual[i].latitude(), expected[i].latitude() );
+        BOOST_REQUIRE_EQUAL( actual[i].longitude(), expected[i].longitude() );
+        BOOST_REQUIRE_EQUAL( actual[i].elevation(), expected[i].elevation() );
+    }
+}
+
+// Whatever the number of chunks, the result matches the sequential reader, in order.
+BOOST_AUTO_TEST_CASE( MatchesSequentialRead )
+{
+    for (std::string filename : {"gll.log", "gga_rmc-1.log", "gga_rmc-2.log"})
+    {
+        const std::string filepath = nmeaFilepath(filename);
+        std::fstream sentences {filepath};
+        const std::vector<Position> expected = readSentences(sentences);
+
+        for (unsigned int threads : {0, 1, 2, 3, 7, 64})
+        {
+            checkSamePositions( readSentencesParallel(filepath, threads), expected );
+        }
+    }
+}
+
+// More chunks than lines, CRLF line endings, and no final newline.
+BOOST_AUTO_TEST_CASE( FewLines )
+{
+    const std::string filepath = (std::filesystem::temp_directory_path() / "few-lines.log").string();
+    {
+        std::ofstream file {filepath, std::ios::binary};
+        file << "$GPGLL,5425.31,N,107.03,W,82610*69\r\n"
+             << "garbage\r\n"
+             << "$GPRMC,113922.000,A,3722.5993,N,00559.2458,W,0.000,0.00,150914,,A*62";
+    }
+
+    for (unsigned int threads : {1, 2, 100})
+    {
+        BOOST_CHECK_EQUAL( readSentencesParallel(filepath, threads).size(), 2 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( EmptyFile )
+{
+    const std::string filepath = (std::filesystem::temp_directory_path() / "empty.log").string();
+    std::ofstream {filepath};
+
+    BOOST_CHECK( readSentencesParallel(filepath).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( MissingFile )
+{
+    BOOST_CHECK_THROW( readSentencesParallel("no-such-file.log"), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/////////////////////////////////////////////////////////////////////////////////////////
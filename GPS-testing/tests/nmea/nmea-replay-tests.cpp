@@ -0,0 +1,280 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <optional>
+#include <cstdlib>
+#include <ctime>
+
+#include <unistd.h>
+
+#include "dataFiles.h"
+#include "nmea-formats.h"
+#include "nmea-replay.h"
+#include "gridworld-track.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( NMEA_Replay )
+
+std::string readNMEAfile(std::string filename)
+{
+    const std::string filepath = DataFiles::NMEADir + filename;
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open NMEA data file: " + filepath +
+       "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::ifstream file {filepath, std::ios::binary};
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+ReplayLog replayLogFrom(const std::string& nmea)
+{
+    std::stringstream data {nmea};
+    return ReplayLog::fromNMEA(data);
+}
+
+// Reads everything from the descriptor until the writer closes it.
+void readUntilClosed(int fd, std::string& received)
+{
+    char buffer[4096];
+    for (ssize_t n; (n = ::read(fd, buffer, sizeof(buffer))) != 0; )
+    {
+        if (n > 0) received.append(buffer, n);
+    }
+}
+
+struct Pipe
+{
+    int readEnd;
+    int writeEnd;
+
+    Pipe()
+    {
+        int fds[2];
+        BOOST_REQUIRE( ::pipe(fds) == 0 );
+        readEnd = fds[0];
+        writeEnd = fds[1];
+    }
+};
+
+const std::string threeSeconds = "$GPGLL,5425.32,N,107.11,W,000000*54\n"
+                                 "$GPGLL,5425.32,N,107.11,W,000001*55\n"
+                                 "$GPGLL,5425.32,N,107.11,W,000002*56\n";
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( LogTiming )
+{
+    const std::string original = readNMEAfile("gga_rmc-1.log");
+    const ReplayLog log = replayLogFrom(original);
+
+    std::istringstream lines {original};
+    std::size_t nonBlankLines = 0;
+    std::optional<double> firstTime;
+    SentenceView sentence;
+    for (std::string line; std::getline(lines, line); )
+    {
+        if (! line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        Fix fix;
+        if (scanSentence(line, sentence) == ScanResult::valid && decodeFix(sentence, fix) && fix.timeOfDay)
+        {
+            if (! firstTime) firstTime = fix.timeOfDay;
+            BOOST_CHECK_EQUAL( log.dueTime(nonBlankLines), *fix.timeOfDay - *firstTime );
+        }
+        ++nonBlankLines;
+    }
+
+    BOOST_REQUIRE_EQUAL( log.sentenceCount(), nonBlankLines );
+    BOOST_CHECK_EQUAL( log.dueTime(0), 0 );  // The header line precedes the first timed sentence.
+    BOOST_CHECK_EQUAL( log.sentenceEnd(log.sentenceCount() - 1), log.text().size() );
+    BOOST_CHECK_EQUAL( log.text().substr(0, 25), "@Sonygps/ver3.0/wgs-84/\r\n" );
+    for (std::size_t i = 1; i < log.sentenceCount(); ++i)
+    {
+        BOOST_CHECK_LE( log.dueTime(i-1), log.dueTime(i) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( PastMidnight )
+{
+    const ReplayLog log = replayLogFrom("$GPGLL,5425.32,N,107.11,W,235959*55\n"
+                                        "$GPGLL,5425.32,N,107.11,W,000000*54\n"
+                                        "not a sentence\n"
+                                        "$GPGLL,5425.32,N,107.11,W,235958*54\n"  // Late
+                                        "$GPGLL,5425.32,N,107.11,W,000002*56\n");
+
+    BOOST_REQUIRE_EQUAL( log.sentenceCount(), 5 );
+    BOOST_CHECK_EQUAL( log.dueTime(0), 0 );
+    BOOST_CHECK_EQUAL( log.dueTime(1), 1 );
+    BOOST_CHECK_EQUAL( log.dueTime(2), 1 );
+    BOOST_CHECK_EQUAL( log.dueTime(3), 1 );
+    BOOST_CHECK_EQUAL( log.dueTime(4), 3 );
+    BOOST_CHECK_EQUAL( log.duration(), 3 );
+    BOOST_CHECK_EQUAL( log.sentencesDueBy(0.5), 1 );
+    BOOST_CHECK_EQUAL( log.sentencesDueBy(1), 4 );
+}
+
+BOOST_AUTO_TEST_CASE( TrackTiming )
+{
+    const ReplayLog log = ReplayLog::fromTrack(GridWorld::Track("A1B2C").toTrackPoints());
+
+    BOOST_REQUIRE_EQUAL( log.sentenceCount(), 6 );
+    const std::vector<double> expected = {0, 0, 1, 1, 3, 3};
+    for (std::size_t i = 0; i < expected.size(); ++i) BOOST_CHECK_EQUAL( log.dueTime(i), expected[i] );
+    BOOST_CHECK_EQUAL( log.text().substr(0, 6), "$GPGGA" );
+}
+
+// Track point times are UTC, so a local change to daylight saving time does not shift them.
+BOOST_AUTO_TEST_CASE( FromTrackIgnoresLocalTimeZone )
+{
+    const auto utc = [](int hour, int minute)
+    {
+        std::tm time {};
+        time.tm_year = 121; // 2021, when UK clocks went forward at 01:00 UTC on 28 March.
+        time.tm_mon = 2;
+        time.tm_mday = 28;
+        time.tm_hour = hour;
+        time.tm_min = minute;
+        time.tm_isdst = -1;
+        return time;
+    };
+    const std::vector<TrackPoint> trackPoints = { {Position(0,0,0), "", utc(0,30)}, {Position(0,0,0), "", utc(2,30)} };
+
+    const char* const originalTZ = std::getenv("TZ");
+    const std::optional<std::string> savedTZ = originalTZ ? std::optional<std::string>{originalTZ} : std::nullopt;
+    ::setenv("TZ", "GMT0BST,M3.5.0/1,M10.5.0", 1);
+    ::tzset();
+
+    const ReplayLog log = ReplayLog::fromTrack(trackPoints);
+
+    if (savedTZ) ::setenv("TZ", savedTZ->c_str(), 1);
+    else ::unsetenv("TZ");
+    ::tzset();
+
+    BOOST_REQUIRE_EQUAL( log.sentenceCount(), 4 );
+    BOOST_CHECK_EQUAL( log.dueTime(2), 2 * 3600 );
+}
+
+// As fast as possible, to many devices at once: every device receives every repetition, intact.
+BOOST_AUTO_TEST_CASE( ManyDevices )
+{
+    const ReplayLog log = replayLogFrom(readNMEAfile("gga_rmc-2.log"));
+    const unsigned int repetitions = 3;
+    const std::size_t numDevices = 8;
+
+    std::vector<Pipe> pipes(numDevices);
+    std::vector<std::string> received(numDevices);
+    std::vector<std::thread> readers;
+    {
+        Replayer replayer {log, 0, repetitions};
+        for (std::size_t i = 0; i < numDevices; ++i)
+        {
+            replayer.addDevice(pipes[i].writeEnd);
+            readers.emplace_back(readUntilClosed, pipes[i].readEnd, std::ref(received[i]));
+        }
+
+        replayer.run();
+
+        BOOST_CHECK_EQUAL( replayer.sentencesWritten(), numDevices * repetitions * log.sentenceCount() );
+        BOOST_CHECK_EQUAL( replayer.droppedDevices(), 0 );
+    }
+    for (Pipe& pipe : pipes) ::close(pipe.writeEnd);
+    for (std::thread& reader : readers) reader.join();
+
+    const std::string expected = std::string(log.text()) + std::string(log.text()) + std::string(log.text());
+    for (std::size_t i = 0; i < numDevices; ++i)
+    {
+        BOOST_CHECK( received[i] == expected );
+        ::close(pipes[i].readEnd);
+    }
+}
+
+// Two seconds of log, at ten times real time, take a fifth of a second.
+BOOST_AUTO_TEST_CASE( ScaledRealTime )
+{
+    const ReplayLog log = replayLogFrom(threeSeconds);
+    Pipe pipe;
+    std::string received;
+    std::thread reader {readUntilClosed, pipe.readEnd, std::ref(received)};
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        Replayer replayer {log, 10};
+        replayer.addDevice(pipe.writeEnd);
+        replayer.run();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    ::close(pipe.writeEnd);
+    reader.join();
+
+    BOOST_CHECK_GE( elapsed.count(), 0.19 );
+    BOOST_CHECK_LT( elapsed.count(), 1.0 );
+    BOOST_CHECK( received == log.text() );
+    ::close(pipe.readEnd);
+}
+
+BOOST_AUTO_TEST_CASE( Stop )
+{
+    const ReplayLog log = replayLogFrom(threeSeconds);
+    Pipe pipe;
+    Replayer replayer {log, 1, 1000};
+    replayer.addDevice(pipe.writeEnd);
+
+    std::thread stopper {[&replayer] { std::this_thread::sleep_for(std::chrono::milliseconds(50)); replayer.stop(); }};
+    const auto start = std::chrono::steady_clock::now();
+    replayer.run(std::chrono::milliseconds(10));
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    stopper.join();
+
+    BOOST_CHECK_LT( elapsed.count(), 0.5 );
+    BOOST_CHECK_EQUAL( replayer.sentencesWritten(), 1 );
+    ::close(pipe.readEnd);
+    ::close(pipe.writeEnd);
+}
+
+BOOST_AUTO_TEST_CASE( ReaderGoesAway )
+{
+    std::signal(SIGPIPE, SIG_IGN);
+    const ReplayLog log = replayLogFrom(threeSeconds);
+    Pipe closed, open;
+    ::close(closed.readEnd);
+    std::string received;
+    std::thread reader {readUntilClosed, open.readEnd, std::ref(received)};
+    {
+        Replayer replayer {log, 0};
+        replayer.addDevice(closed.writeEnd);
+        replayer.addDevice(open.writeEnd);
+        replayer.run();
+
+        BOOST_CHECK_EQUAL( replayer.droppedDevices(), 1 );
+    }
+    ::close(closed.writeEnd);
+    ::close(open.writeEnd);
+    reader.join();
+
+    BOOST_CHECK( received == log.text() );
+    ::close(open.readEnd);
+}
+
+BOOST_AUTO_TEST_CASE( InvalidArguments )
+{
+    const ReplayLog log = replayLogFrom(threeSeconds);
+
+    BOOST_CHECK_THROW( Replayer(log, -1), std::invalid_argument );
+    BOOST_CHECK_THROW( Replayer(log, 1, 0), std::invalid_argument );
+
+    Replayer replayer {log};
+    BOOST_CHECK_THROW( replayer.addDevice(-1), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+
+#include "dataFiles.h"
+#include "nmea-parser.h"
+#include "nmea-track.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( ReadTrackPoints )
+
+const double percentageAccuracy = 0.0001;
+
+// Wraps the sentence body in the '$' prefix and the '*' checksum suffix.
+std::string sentenceWithChecksum(std::string body)
+{
+    unsigned int checksum = 0;
+    for (char c : body) checksum ^= static_cast<unsigned char>(c);
+    std::ostringstream sentence;
+    sentence << '$' << body << '*' << std::uppercase << std::hex << std::setw(2) << std::setfill('0') << checksum;
+    return sentence.str();
+}
+
+std::string ggaSentence(std::string time)
+{
+    return sentenceWithChecksum("GPGGA," + time + ",3722.6279,N,00559.1566,W,1,0,,1.0,M,,M,,");
+}
+
+std::string rmcSentence(std::string time, std::string date)
+{
+    return sentenceWithChecksum("GPRMC," + time + ",A,3722.5993,N,00559.2458,W,0.000,0.00," + date + ",,A");
+}
+
+void checkDateTime(const std::tm& dateTime, int year, int month, int day, int hour, int minute, int second)
+{
+    BOOST_CHECK_EQUAL( dateTime.tm_year + 1900, year );
+    BOOST_CHECK_EQUAL( dateTime.tm_mon + 1, month );
+    BOOST_CHECK_EQUAL( dateTime.tm_mday, day );
+    BOOST_CHECK_EQUAL( dateTime.tm_hour, hour );
+    BOOST_CHECK_EQUAL( dateTime.tm_min, minute );
+    BOOST_CHECK_EQUAL( dateTime.tm_sec, second );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( EmptyStream )
+{
+    std::stringstream sentences("");
+
+    BOOST_CHECK( readTrackPoints(sentences).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( LargeFileGGA_RMC )
+{
+    const std::string filepath = DataFiles::NMEADir + "gga_rmc-1.log";
+    BOOST_REQUIRE_MESSAGE( std::filesystem::exists(filepath),
+      ("Could not open log file: " + filepath + "\n(If you're running at the command-line, you need to 'cd' into the 'bin/' directory first.)") );
+    std::fstream sentences {filepath};
+
+    std::vector<TrackPoint> trackPoints = readTrackPoints(sentences);
+
+    // Each epoch has a GGA and an RMC sentence, which are fused into one point.
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 316 );
+
+    // Pos 0: $GPGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*7A, dated by the RMC sentence of the same epoch.
+    BOOST_CHECK_CLOSE( trackPoints[0].position.latitude(), ddmTodd("3723.1622"), percentageAccuracy );
+    BOOST_CHECK_CLOSE( trackPoints[0].position.elevation(), 30.0, percentageAccuracy );
+    checkDateTime( trackPoints[0].dateTime, 2014, 9, 15, 9, 46, 27 );
+
+    // Last: $GPRMC,120326.000,A,3722.7827,N,00559.3166,W,0.000,0.00,150914,,A*69
+    checkDateTime( trackPoints.back().dateTime, 2014, 9, 15, 12, 3, 26 );
+}
+
+BOOST_AUTO_TEST_CASE( MidnightRollover )
+{
+    std::stringstream sentences;
+    sentences << rmcSentence("235958.000", "311214") << '\n'
+              << ggaSentence("235959.500") << '\n'
+              << ggaSentence("000001.000") << '\n'
+              << ggaSentence("000002.000") << '\n';
+
+    std::vector<TrackPoint> trackPoints = readTrackPoints(sentences);
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 4 );
+    checkDateTime( trackPoints[0].dateTime, 2014, 12, 31, 23, 59, 58 );
+    checkDateTime( trackPoints[1].dateTime, 2014, 12, 31, 23, 59, 59 );
+    checkDateTime( trackPoints[2].dateTime, 2015, 1, 1, 0, 0, 1 );
+    checkDateTime( trackPoints[3].dateTime, 2015, 1, 1, 0, 0, 2 );
+}
+
+BOOST_AUTO_TEST_CASE( PointsBeforeFirstDate )
+{
+    std::stringstream sentences;
+    sentences << ggaSentence("235959") << '\n'
+              << ggaSentence("000000") << '\n'
+              << rmcSentence("000001", "010316") << '\n';
+
+    std::vector<TrackPoint> trackPoints = readTrackPoints(sentences);
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 3 );
+    checkDateTime( trackPoints[0].dateTime, 2016, 2, 29, 23, 59, 59 );
+    checkDateTime( trackPoints[1].dateTime, 2016, 3, 1, 0, 0, 0 );
+    checkDateTime( trackPoints[2].dateTime, 2016, 3, 1, 0, 0, 1 );
+}
+
+// ZDA sentences carry a date, but no position.
+BOOST_AUTO_TEST_CASE( DateFromZDA )
+{
+    std::stringstream sentences;
+    sentences << sentenceWithChecksum("GPZDA,201530.00,04,07,2002,00,00") << '\n'
+              << ggaSentence("201531") << '\n';
+
+    std::vector<TrackPoint> trackPoints = readTrackPoints(sentences);
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 1 );
+    checkDateTime( trackPoints[0].dateTime, 2002, 7, 4, 20, 15, 31 );
+}
+
+// A small step back in time is out-of-order data (which the epoch fusion reorders), not a new day.
+BOOST_AUTO_TEST_CASE( SmallStepBack )
+{
+    std::stringstream sentences;
+    sentences << rmcSentence("120005", "150914") << '\n'
+              << ggaSentence("120004") << '\n';
+
+    std::vector<TrackPoint> trackPoints = readTrackPoints(sentences);
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 2 );
+    checkDateTime( trackPoints[0].dateTime, 2014, 9, 15, 12, 0, 4 );
+    checkDateTime( trackPoints[1].dateTime, 2014, 9, 15, 12, 0, 5 );
+}
+
+BOOST_AUTO_TEST_CASE( StartDate )
+{
+    std::stringstream sentences;
+    sentences << ggaSentence("235959") << '\n'
+              << ggaSentence("000000") << '\n';
+
+    std::vector<TrackPoint> trackPoints = readTrackPoints(sentences, Date{2020, 2, 28});
+
+    BOOST_REQUIRE_EQUAL( trackPoints.size(), 2 );
+    checkDateTime( trackPoints[0].dateTime, 2020, 2, 28, 23, 59, 59 );
+    checkDateTime( trackPoints[1].dateTime, 2020, 2, 29, 0, 0, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( NoDate )
+{
+    std::stringstream sentences;
+    sentences << ggaSentence("120000") << '\n';
+
+    BOOST_CHECK_THROW( readTrackPoints(sentences), std::domain_error );
+}
+
+BOOST_AUTO_TEST_CASE( InvalidSentencesIgnored )
+{
+    std::stringstream sentences;
+    sentences << rmcSentence("120000", "150914") << '\n'
+              << "$GPGGA,120001.000,3722.6279,N,00559.1566,W,1,0,,1.0,M,,M,,*00" << '\n' // checksum mismatch
+              << sentenceWithChecksum("GPGGA,,3722.6279,N,00559.1566,W,1,0,,1.0,M,,M,,") << '\n' // no time
+              << sentenceWithChecksum("GPGGA,120003,,,,,0,0,,,M,,M,,") << '\n'; // no position
+
+    BOOST_CHECK_EQUAL( readTrackPoints(sentences).size(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( CalendarDays )
+{
+    BOOST_CHECK_EQUAL( nextDay({2000,2,28}).day, 29 );
+    BOOST_CHECK_EQUAL( nextDay({1900,2,28}).month, 3 );
+    BOOST_CHECK_EQUAL( nextDay({2019,12,31}).year, 2020 );
+    BOOST_CHECK_EQUAL( previousDay({2020,1,1}).day, 31 );
+    BOOST_CHECK_EQUAL( previousDay({2021,3,1}).day, 28 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,9 @@
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
+#include <cstdint>
+#include <string>
+
 #include "geometry.h"
 #include "position.h"
 #include "earth.h"
@@ -48,6 +52,69 @@ BOOST_AUTO_TEST_SUITE_END()
 
 /////////////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_SUITE( IntegerDDM )
+
+BOOST_AUTO_TEST_CASE( ExactValues )
+{
+    degrees dd = 0;
+
+    BOOST_REQUIRE( decodeDDM("3700", dd) );
+    BOOST_CHECK_EQUAL( dd, 37 );
+    BOOST_REQUIRE( decodeDDM("6730", dd) );
+    BOOST_CHECK_EQUAL( dd, 67.5 );
+    BOOST_REQUIRE( decodeDDM("0030.000000", dd) );
+    BOOST_CHECK_EQUAL( dd, 0.5 );
+    BOOST_REQUIRE( decodeDDM("7730.90", dd) );
+    BOOST_CHECK_EQUAL( dd, 77.515 ); // Exactly 77 + 30.9/60, so the nearest double to it.
+    BOOST_REQUIRE( decodeDDM("107.03", dd) );
+    BOOST_CHECK_EQUAL( dd, (1 * 6000 + 703) / 6000.0 );
+    BOOST_REQUIRE( decodeDDM("5.", dd) );
+    BOOST_CHECK_EQUAL( dd, 5 / 60.0 );
+}
+
+// The integer decoding agrees with the floating-point ddmTodd(), to within rounding.
+BOOST_AUTO_TEST_CASE( AgreesWithDDMtoDD )
+{
+    for (std::string ddm : {"5425.31", "3723.1622", "00559.5788", "17959.99999", "0000.0001", "9000", "4530.123456789"})
+    {
+        degrees dd;
+        BOOST_REQUIRE( decodeDDM(ddm, dd) );
+        BOOST_CHECK_CLOSE( dd, ddmTodd(ddm), 1e-12 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( FixedPointE7 )
+{
+    std::int64_t e7 = 0;
+
+    BOOST_REQUIRE( decodeDDME7("5425.31", e7) );
+    BOOST_CHECK_EQUAL( e7, 544218333 ); // 54 + 25.31/60 = 54.42183333...
+    BOOST_REQUIRE( decodeDDME7("00559.2458", e7) );
+    BOOST_CHECK_EQUAL( e7, 59874300 );  // 5 + 59.2458/60 = 5.98743
+    BOOST_REQUIRE( decodeDDME7("0000.00002", e7) );
+    BOOST_CHECK_EQUAL( e7, 3 );         // 0.00002/60 = 3.33e-7, rounded to 3
+    BOOST_REQUIRE( decodeDDME7("0000.000003", e7) );
+    BOOST_CHECK_EQUAL( e7, 1 );         // 0.5e-7, rounded up
+    BOOST_REQUIRE( decodeDDME7("18000.000000000000", e7) );
+    BOOST_CHECK_EQUAL( e7, 1800000000 );
+}
+
+BOOST_AUTO_TEST_CASE( Rejected )
+{
+    degrees dd = 0;
+    std::int64_t e7 = 0;
+
+    for (std::string ddm : {"", ".5", "-5425.31", "+5425.31", "54x25.31", "5425.3.1", "5425.31 ", "5460.00", "123456.0"})
+    {
+        BOOST_CHECK_MESSAGE( ! decodeDDM(ddm, dd), ddm );
+        BOOST_CHECK_MESSAGE( ! decodeDDME7(ddm, e7), ddm );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE( HorizontalDistanceBetween )
 
 const double percentageAccuracy = 1;
@@ -110,6 +177,38 @@ BOOST_AUTO_TEST_SUITE_END()
 
 /////////////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_SUITE( GeodeticPoints )
+
+BOOST_AUTO_TEST_CASE( CachedValues )
+{
+    const GeodeticPoint point {Earth::CliftonCampus};
+
+    BOOST_CHECK_EQUAL( point.latitude(), degToRad(Earth::CliftonCampus.latitude()) );
+    BOOST_CHECK_EQUAL( point.longitude(), degToRad(Earth::CliftonCampus.longitude()) );
+    BOOST_CHECK_EQUAL( point.cosLatitude(), std::cos(point.latitude()) );
+}
+
+// The cached values give exactly the same distances as the Positions they were made from.
+BOOST_AUTO_TEST_CASE( SameDistances )
+{
+    const Position positions[] = { Earth::NorthPole, Earth::SouthPole, Earth::EquatorialMeridian,
+                                   Earth::EquatorialAntiMeridian, Earth::CliftonCampus, Earth::CityCampus,
+                                   Earth::Pontianak };
+
+    for (const Position& first : positions)
+    {
+        for (const Position& second : positions)
+        {
+            BOOST_CHECK_EQUAL( Position::horizontalDistanceBetween(GeodeticPoint(first), GeodeticPoint(second)),
+                               Position::horizontalDistanceBetween(first, second) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE( Constructor )
 
 const double percentageAccuracy = 0.0001;
@@ -261,6 +360,22 @@ BOOST_AUTO_TEST_CASE( ElevationBelowBoundary )
    BOOST_CHECK_THROW( Position(lat,lon,eleBelowBoundary) , std::invalid_argument );
 }
 
+BOOST_AUTO_TEST_CASE( NaNArgs )
+{
+    BOOST_CHECK_THROW( Position(NAN,lon,ele) , std::invalid_argument );
+    BOOST_CHECK_THROW( Position(lat,NAN,ele) , std::invalid_argument );
+    BOOST_CHECK_THROW( Position(lat,lon,NAN) , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( ConstantExpression )
+{
+    constexpr Position pos = Position(25.5,37.25,4786.2);
+    static_assert( pos.latitude() == 25.5 && pos.longitude() == 37.25 && pos.elevation() == 4786.2 );
+    static_assert( Earth::NorthPole.latitude() == poleLatitude );
+
+    BOOST_CHECK_EQUAL( pos.latitude(), 25.5 );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ///////////////////////////////////////////////